@@ -0,0 +1,299 @@
+#include "SyntheticEventGenerator.h"
+#include <algorithm>
+
+namespace {
+    /// energy of the beams (13 TeV collisions)
+    constexpr double beam_energy = 6500;
+
+    /// approximate masses of the particles used in the synthetic events
+    double particleMass(int pid) {
+        switch (std::abs(pid)) {
+            case 11: return 0.000511;
+            case 13: return 0.10566;
+            case 111: return 0.13498;
+            case 211: return 0.13957;
+            case 310: return 0.49761;
+            case 321: return 0.49368;
+            case 411: return 1.86966;
+            case 421: return 1.86484;
+            case 511: return 5.27965;
+            case 521: return 5.27934;
+            case 2112: return 0.93957;
+            case 2212: return 0.93827;
+            case 3122: return 1.11568;
+            case 4: return 1.5;
+            case 5: return 4.8;
+            default: return 0;
+        }
+    }
+
+    /// four-momentum with the energy from the mass of the particle
+    HepMC3::FourVector onShell(double px, double py, double pz, int pid) {
+        const double mass = particleMass(pid);
+        return HepMC3::FourVector(px, py, pz, std::sqrt(px * px + py * py + pz * pz + mass * mass));
+    }
+
+    /// rotates the direction of (px, py, pz) by the polar angle theta and the azimuth phi around it, keeping |p|
+    void rotate(double& px, double& py, double& pz, double theta, double phi) {
+        const double p = std::sqrt(px * px + py * py + pz * pz);
+        if (p == 0)
+            return;
+        const double ux = px / p, uy = py / p, uz = pz / p;
+        // orthonormal basis (u, v, w)
+        double vx = -uy, vy = ux, vz = 0;
+        double norm = std::sqrt(vx * vx + vy * vy);
+        if (norm < 1e-12) {vx = 1; vy = 0; norm = 1;}
+        vx /= norm; vy /= norm;
+        const double wx = uy * vz - uz * vy, wy = uz * vx - ux * vz, wz = ux * vy - uy * vx;
+        const double c = std::cos(theta), s = std::sin(theta), cp = std::cos(phi), sp = std::sin(phi);
+        px = p * (c * ux + s * (cp * vx + sp * wx));
+        py = p * (c * uy + s * (cp * vy + sp * wy));
+        pz = p * (c * uz + s * (cp * vz + sp * wz));
+    }
+}
+
+
+std::uint64_t SyntheticRandom::next() {
+    std::uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+double SyntheticRandom::gaussian() {
+    // Box-Muller
+    return std::sqrt(-2 * std::log(uniform())) * std::cos(2 * M_PI * uniform());
+}
+
+int SyntheticRandom::poisson(double mean) {
+    if (mean <= 0)
+        return 0;
+    // gaussian approximation for large means
+    if (mean > 30)
+        return std::max(0, int(std::lround(mean + std::sqrt(mean) * gaussian())));
+    const double limit = std::exp(-mean);
+    int counts = 0;
+    for (double product = uniform(); product > limit; product *= uniform())
+        counts++;
+    return counts;
+}
+
+
+void SyntheticEventGenerator::generate(HepMC3::GenEvent& hepmc_event) {
+    hepmc_event.clear();
+    hepmc_event.set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
+    hepmc_event.set_event_number(_event_number++);
+
+    // hard process: two partons back to back in the transverse plane, pT falling as 1/pT^4 in the window
+    const double a = std::pow(_settings.pthat_min, -3), b = std::pow(_settings.pthat_max, -3);
+    const double pthat = std::pow(a + (b - a) * _random.uniform(), -1. / 3);
+    const double phi = _random.uniform(0, 2 * M_PI);
+    const double y1 = _random.uniform(-2, 2), y2 = _random.uniform(-2, 2);
+
+    int pid1, pid2, initial_pid1, initial_pid2;
+    if (_settings.hard_flavour == 4 || _settings.hard_flavour == 5) {
+        pid1 = _settings.hard_flavour;
+        pid2 = -_settings.hard_flavour;
+        // gg -> QQbar dominates
+        initial_pid1 = initial_pid2 = 21;
+    }
+    else {
+        const double channel = _random.uniform();
+        const int light_quark = 1 + int(_random.uniform() * 2.999);
+        if (channel < 0.5) {pid1 = pid2 = initial_pid1 = initial_pid2 = 21;}
+        else if (channel < 0.85) {pid1 = initial_pid1 = light_quark; pid2 = initial_pid2 = 21;}
+        else {pid1 = initial_pid1 = light_quark; pid2 = initial_pid2 = -light_quark;}
+    }
+
+    HepMC3::GenParticlePtr hard1 = std::make_shared<HepMC3::GenParticle>(
+        onShell(pthat * std::cos(phi), pthat * std::sin(phi), pthat * std::sinh(y1), pid1), pid1, 23);
+    HepMC3::GenParticlePtr hard2 = std::make_shared<HepMC3::GenParticle>(
+        onShell(-pthat * std::cos(phi), -pthat * std::sin(phi), pthat * std::sinh(y2), pid2), pid2, 23);
+
+    // incoming partons along the beam axis carrying the E +- pz of the hard system
+    const HepMC3::FourVector hard_system = hard1->momentum() + hard2->momentum();
+    const double e_plus = 0.5 * (hard_system.e() + hard_system.pz()), e_minus = 0.5 * (hard_system.e() - hard_system.pz());
+    HepMC3::GenParticlePtr beam1 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, beam_energy, beam_energy), 2212, 4);
+    HepMC3::GenParticlePtr beam2 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, -beam_energy, beam_energy), 2212, 4);
+    HepMC3::GenParticlePtr initial1 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, e_plus, e_plus), initial_pid1, 21);
+    HepMC3::GenParticlePtr initial2 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, -e_minus, e_minus), initial_pid2, 21);
+    HepMC3::GenParticlePtr remnant1 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, beam_energy - e_plus, beam_energy - e_plus), 2101, 63);
+    HepMC3::GenParticlePtr remnant2 = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector(0, 0, -beam_energy + e_minus, beam_energy - e_minus), 2101, 63);
+
+    HepMC3::GenVertexPtr beam_vertex1 = std::make_shared<HepMC3::GenVertex>();
+    beam_vertex1->add_particle_in(beam1);
+    beam_vertex1->add_particle_out(initial1);
+    beam_vertex1->add_particle_out(remnant1);
+    hepmc_event.add_vertex(beam_vertex1);
+    HepMC3::GenVertexPtr beam_vertex2 = std::make_shared<HepMC3::GenVertex>();
+    beam_vertex2->add_particle_in(beam2);
+    beam_vertex2->add_particle_out(initial2);
+    beam_vertex2->add_particle_out(remnant2);
+    hepmc_event.add_vertex(beam_vertex2);
+
+    HepMC3::GenVertexPtr hard_vertex = std::make_shared<HepMC3::GenVertex>();
+    hard_vertex->add_particle_in(initial1);
+    hard_vertex->add_particle_in(initial2);
+    hard_vertex->add_particle_out(hard1);
+    hard_vertex->add_particle_out(hard2);
+    hepmc_event.add_vertex(hard_vertex);
+
+    // parton shower and hadronization of the hard partons
+    std::vector<HepMC3::GenParticlePtr> partons1 = shower(hepmc_event, hard1);
+    std::vector<HepMC3::GenParticlePtr> partons2 = shower(hepmc_event, hard2);
+    const int hard_hadrons = _random.poisson(_settings.mean_multiplicity * (1 - _settings.underlying_event_fraction));
+    if (_random.uniform() < _settings.shared_string_probability) {
+        partons1.insert(partons1.end(), partons2.begin(), partons2.end());
+        hadronize(hepmc_event, partons1, hard_hadrons);
+    }
+    else {
+        hadronize(hepmc_event, partons1, hard_hadrons / 2);
+        hadronize(hepmc_event, partons2, hard_hadrons - hard_hadrons / 2);
+    }
+
+    // underlying event from the beam remnants - soft particles not connected to the hard process
+    HepMC3::GenVertexPtr remnant_vertex = std::make_shared<HepMC3::GenVertex>();
+    remnant_vertex->add_particle_in(remnant1);
+    remnant_vertex->add_particle_in(remnant2);
+    const int soft_particles = _random.poisson(_settings.mean_multiplicity * _settings.underlying_event_fraction);
+    for (int i = 0; i < soft_particles; i++) {
+        const double pt = _random.exponential(0.5), eta = _random.uniform(-5, 5), soft_phi = _random.uniform(0, 2 * M_PI);
+        addHadron(hepmc_event, remnant_vertex, lightHadronPid(), pt * std::cos(soft_phi), pt * std::sin(soft_phi), pt * std::sinh(eta));
+    }
+    hepmc_event.add_vertex(remnant_vertex);
+}
+
+std::vector<HepMC3::GenParticlePtr> SyntheticEventGenerator::shower(HepMC3::GenEvent& hepmc_event, HepMC3::GenParticlePtr parton) {
+    // the hard parton starts the shower through a copy, as in Pythia
+    HepMC3::GenParticlePtr first = std::make_shared<HepMC3::GenParticle>(parton->momentum(), parton->pid(), 51);
+    HepMC3::GenVertexPtr vertex = std::make_shared<HepMC3::GenVertex>();
+    vertex->add_particle_in(parton);
+    vertex->add_particle_out(first);
+    hepmc_event.add_vertex(vertex);
+
+    std::vector<HepMC3::GenParticlePtr> partons = {first};
+    const int number_partons = 1 + _random.poisson(_settings.mean_shower_partons - 1);
+    while (int(partons.size()) < number_partons) {
+        // the most energetic parton splits: a -> b c with momentum fractions z and 1 - z
+        auto it_parent = std::max_element(partons.begin(), partons.end(), [](const HepMC3::GenParticlePtr& p1, const HepMC3::GenParticlePtr& p2) {
+            return p1->momentum().e() < p2->momentum().e();
+        });
+        HepMC3::GenParticlePtr parent = *it_parent;
+        const HepMC3::FourVector& momentum = parent->momentum();
+        const double z = _random.uniform(0.1, 0.9), theta = std::min(_random.exponential(0.15), 1.), azimuth = _random.uniform(0, 2 * M_PI);
+        // the opening angles balance the transverse momentum with respect to the parent direction
+        double px1 = z * momentum.px(), py1 = z * momentum.py(), pz1 = z * momentum.pz();
+        double px2 = (1 - z) * momentum.px(), py2 = (1 - z) * momentum.py(), pz2 = (1 - z) * momentum.pz();
+        rotate(px1, py1, pz1, (1 - z) * theta, azimuth);
+        rotate(px2, py2, pz2, z * theta, azimuth + M_PI);
+        // quarks radiate gluons, gluons split into gluons
+        const int pid1 = parent->pid(), pid2 = 21;
+
+        HepMC3::GenParticlePtr daughter1 = std::make_shared<HepMC3::GenParticle>(onShell(px1, py1, pz1, pid1), pid1, 51);
+        HepMC3::GenParticlePtr daughter2 = std::make_shared<HepMC3::GenParticle>(onShell(px2, py2, pz2, pid2), pid2, 51);
+        HepMC3::GenVertexPtr split_vertex = std::make_shared<HepMC3::GenVertex>();
+        split_vertex->add_particle_in(parent);
+        split_vertex->add_particle_out(daughter1);
+        split_vertex->add_particle_out(daughter2);
+        hepmc_event.add_vertex(split_vertex);
+
+        *it_parent = daughter1;
+        partons.push_back(daughter2);
+    }
+    // partons at the end of the shower
+    for (HepMC3::GenParticlePtr final_parton: partons)
+        final_parton->set_status(71);
+    return partons;
+}
+
+void SyntheticEventGenerator::hadronize(HepMC3::GenEvent& hepmc_event, const std::vector<HepMC3::GenParticlePtr>& partons, int number_hadrons) {
+    // partons -> string -> hadrons
+    HepMC3::FourVector total_momentum;
+    for (HepMC3::GenParticlePtr parton: partons)
+        total_momentum += parton->momentum();
+    HepMC3::GenParticlePtr string = std::make_shared<HepMC3::GenParticle>(total_momentum, 92, 2);
+    HepMC3::GenVertexPtr string_vertex = std::make_shared<HepMC3::GenVertex>();
+    for (HepMC3::GenParticlePtr parton: partons)
+        string_vertex->add_particle_in(parton);
+    string_vertex->add_particle_out(string);
+    hepmc_event.add_vertex(string_vertex);
+
+    HepMC3::GenVertexPtr hadron_vertex = std::make_shared<HepMC3::GenVertex>();
+    hadron_vertex->add_particle_in(string);
+    // the hadrons are shared among the partons by energy; heavy quarks give a leading heavy-flavour hadron
+    for (HepMC3::GenParticlePtr parton: partons) {
+        const HepMC3::FourVector& momentum = parton->momentum();
+        int parton_hadrons = std::max(1, int(std::lround(number_hadrons * momentum.e() / total_momentum.e())));
+        double remaining_fraction = 1;
+        const int flavour = std::abs(parton->pid());
+        if (flavour == 4 || flavour == 5) {
+            // b -> B-bar (bbar u or bbar d), c -> D (c ubar or c dbar)
+            const bool charged = _random.uniform() < 0.5;
+            int pid = flavour == 5 ? (charged ? 521 : 511) : (charged ? 411 : 421);
+            if ((flavour == 5) == (parton->pid() > 0))
+                pid = -pid;
+            const double z = std::min(0.95, std::max(0.3, 0.75 + 0.1 * _random.gaussian()));
+            addHadron(hepmc_event, hadron_vertex, pid, z * momentum.px(), z * momentum.py(), z * momentum.pz());
+            remaining_fraction -= z;
+            parton_hadrons--;
+        }
+        for (int i = 0; i < parton_hadrons; i++) {
+            // fragmentation: each hadron takes a random fraction of what is left of the parton
+            const double z = (i == parton_hadrons - 1) ? remaining_fraction : remaining_fraction * _random.uniform(0.05, 0.6);
+            remaining_fraction -= z;
+            double px = z * momentum.px(), py = z * momentum.py(), pz = z * momentum.pz();
+            rotate(px, py, pz, std::min(_random.exponential(0.3 / (1 + 10 * z)), 1.5), _random.uniform(0, 2 * M_PI));
+            addHadron(hepmc_event, hadron_vertex, lightHadronPid(), px, py, pz);
+        }
+    }
+    hepmc_event.add_vertex(hadron_vertex);
+}
+
+void SyntheticEventGenerator::addHadron(HepMC3::GenEvent& hepmc_event, HepMC3::GenVertexPtr vertex, int pid, double px, double py, double pz) {
+    HepMC3::GenParticlePtr hadron = std::make_shared<HepMC3::GenParticle>(onShell(px, py, pz, pid), pid, 1);
+    vertex->add_particle_out(hadron);
+    const int abs_pid = std::abs(pid);
+    const int sign = pid > 0 ? 1 : -1;
+    // short decay chains
+    if (abs_pid == 111)
+        decay(hepmc_event, hadron, {22, 22});
+    else if (abs_pid == 511 || abs_pid == 521)
+        // B-bar -> D pi pi
+        decay(hepmc_event, hadron, {sign * (abs_pid == 521 ? 421 : 411), sign * 211, -sign * 211, 111});
+    else if (abs_pid == 411)
+        // D+ -> K- pi+ pi+
+        decay(hepmc_event, hadron, {-sign * 321, sign * 211, sign * 211});
+    else if (abs_pid == 421)
+        // D0 -> K- pi+ pi0
+        decay(hepmc_event, hadron, {-sign * 321, sign * 211, 111});
+}
+
+void SyntheticEventGenerator::decay(HepMC3::GenEvent& hepmc_event, HepMC3::GenParticlePtr particle, const std::vector<int>& products) {
+    particle->set_status(2);
+    HepMC3::GenVertexPtr decay_vertex = std::make_shared<HepMC3::GenVertex>();
+    decay_vertex->add_particle_in(particle);
+    const HepMC3::FourVector momentum = particle->momentum();
+    double remaining_fraction = 1;
+    for (std::size_t i = 0; i < products.size(); i++) {
+        const double z = (i + 1 == products.size()) ? remaining_fraction : remaining_fraction * _random.uniform(0.2, 0.7);
+        remaining_fraction -= z;
+        double px = z * momentum.px(), py = z * momentum.py(), pz = z * momentum.pz();
+        rotate(px, py, pz, std::min(_random.exponential(0.1), 1.), _random.uniform(0, 2 * M_PI));
+        // the products can decay again (D from B, pi0)
+        addHadron(hepmc_event, decay_vertex, products[i], px, py, pz);
+    }
+    hepmc_event.add_vertex(decay_vertex);
+}
+
+int SyntheticEventGenerator::lightHadronPid() {
+    const double species = _random.uniform();
+    const int sign = _random.uniform() < 0.5 ? 1 : -1;
+    if (species < 0.55) return sign * 211;
+    if (species < 0.77) return 111;
+    if (species < 0.85) return sign * 321;
+    if (species < 0.89) return 310;
+    if (species < 0.94) return sign * 2212;
+    if (species < 0.97) return sign * 2112;
+    if (species < 0.99) return sign * 3122;
+    return sign * 11;
+}
@@ -0,0 +1,95 @@
+/**
+ * @headerfile - generates deterministic synthetic HepMC3 events for the benchmarks, so that no Pythia installation
+ *               nor the large files of the archive are needed.
+ *               The events have the same record structure as the Pythia ones used in the analysis:
+ *               beams (status 4) -> initial partons (status 21) -> hard process (status 23) -> parton shower
+ *               (status 51/71) -> strings (pid 92) -> hadrons, with short decay chains (status 2) for pi0 and
+ *               heavy-flavour hadrons, plus an underlying event from the beam remnants that is not connected to
+ *               the hard process. The kinematics only look realistic (collinear showers, limited pT, jets);
+ *               energy-momentum is not exactly conserved.
+ *               The random numbers come from a splitmix64 generator with hand-written distributions,
+ *               so the same seed gives the same events on every platform and standard library.
+ **/
+
+#ifndef SYNTHETIC_EVENT_GENERATOR_H
+#define SYNTHETIC_EVENT_GENERATOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+#include "HepMC3/FourVector.h"
+
+/**
+ * @class - deterministic random numbers (splitmix64)
+ **/
+class SyntheticRandom {
+    public:
+        SyntheticRandom(std::uint64_t seed): _state(seed) {};
+
+        std::uint64_t next();
+        /// @brief - uniform in (0, 1]
+        double uniform() {return ((next() >> 11) + 1) * 0x1.0p-53;};
+        double uniform(double min, double max) {return min + (max - min) * uniform();};
+        double exponential(double mean) {return -mean * std::log(uniform());};
+        double gaussian();
+        int poisson(double mean);
+
+    private:
+        std::uint64_t _state;
+};
+
+/**
+ * @brief - parameters of the synthetic events
+ **/
+struct SyntheticEventSettings {
+    /// @brief - window of the pT of the hard process
+    double pthat_min = 20;
+    double pthat_max = 30;
+    /// @brief - mean number of final state particles in the event
+    double mean_multiplicity = 400;
+    /// @brief - fraction of the final state particles coming from the underlying event
+    double underlying_event_fraction = 0.6;
+    /// @brief - flavour of the hard process: 5 for bbbar, 4 for ccbar, 0 for light quarks and gluons
+    int hard_flavour = 0;
+    /// @brief - mean number of partons at the end of the shower of each hard parton
+    double mean_shower_partons = 6;
+    /// @brief - probability that both hard partons hadronize in the same string
+    double shared_string_probability = 0.3;
+};
+
+/**
+ * @class - generates the synthetic events
+ **/
+class SyntheticEventGenerator {
+
+    public:
+        SyntheticEventGenerator(const SyntheticEventSettings& settings, std::uint64_t seed): _settings(settings), _random(seed) {};
+
+        /// @brief - fills the event (cleared first) with the next synthetic event
+        void generate(HepMC3::GenEvent& hepmc_event);
+
+    private:
+        SyntheticEventSettings _settings;
+        SyntheticRandom _random;
+        int _event_number = 0;
+
+        /// @brief - showers the hard parton, returning the partons at the end of the shower
+        std::vector<HepMC3::GenParticlePtr> shower(HepMC3::GenEvent& hepmc_event, HepMC3::GenParticlePtr parton);
+
+        /// @brief - hadronizes the partons of one string into number_hadrons hadrons
+        void hadronize(HepMC3::GenEvent& hepmc_event, const std::vector<HepMC3::GenParticlePtr>& partons, int number_hadrons);
+
+        /// @brief - decays the particle into the products, sharing its momentum among them
+        void decay(HepMC3::GenEvent& hepmc_event, HepMC3::GenParticlePtr particle, const std::vector<int>& products);
+
+        /// @brief - adds the final state particle, decaying it when it is unstable (pi0 and heavy-flavour hadrons)
+        void addHadron(HepMC3::GenEvent& hepmc_event, HepMC3::GenVertexPtr vertex, int pid, double px, double py, double pz);
+
+        /// @brief - draws the pid of a light hadron
+        int lightHadronPid();
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include "SyntheticEventGenerator.h"
+#include "Analysis/AllocationCounter.h"
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/Observable.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/SignalParticlesSearcher.h"
+#include "Analysis/JetClustering.h"
+#include "Analysis/CSVWriter.h"
+#include "HepMC3/GenEvent.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/// exposes the conversion to PseudoJets - the clustering itself allocates inside fastjet and is not checked
+class PseudoJetConversion: public JetClustering {
+    public:
+        PseudoJetConversion(): JetClustering(0.4, 5, fastjet::antikt_algorithm) {};
+        using JetClustering::convertParticlesToPseudoJets;
+};
+
+/// @brief - heap allocations of each stage of the event loop
+struct StageAllocations {
+    string stage;
+    AllocationCount count;
+};
+
+/// regression check: after one warm-up pass over the events, the analysis loop must not allocate any memory
+int main (int argc, char* argv[]) {
+    // usage: allocation_check [number of events]
+    const long number_events = argc > 1 ? stol(argv[1]) : 200;
+
+    // the events are generated before the check - HepMC3 itself is not part of it
+    SyntheticEventGenerator generator (SyntheticEventSettings(), 2024);
+    deque<GenEvent> hepmc_events;
+    for (long i = 0; i < number_events; i++) {
+        hepmc_events.emplace_back(Units::GEV, Units::MM);
+        generator.generate(hepmc_events.back());
+    }
+
+    // same analysis as select_hepmc_particles
+    const FinalStateSelector final_state_selector;
+    const ChargedParticlesSelector charged_particle_selector;
+    const MultipleParticleSelectors hepmc_particle_selector({&final_state_selector, &charged_particle_selector});
+    const InitialStateSelector initial_particle_selector;
+    const OutgoingParticlesFromHardProcess final_hard_process_particles;
+    const InvariantMass invariant_mass;
+    const LeadingChargedPtCut leading_charged_pt_cut (0);
+    EventAnalyzer event_analyzer;
+    event_analyzer.addParticleSelector(ParticleType::FinalParticles, &hepmc_particle_selector);
+    event_analyzer.addParticleSelector(ParticleType::InitialParticles, &initial_particle_selector);
+    event_analyzer.addParticleSelector(ParticleType::OutgoingHardProcessParticles, &final_hard_process_particles);
+    event_analyzer.addObservable("invariantMass", &invariant_mass);
+    event_analyzer.addEventCut("leading charged pT", &leading_charged_pt_cut);
+    SignalParticlesSearcher signal_particle_searcher (&hepmc_particle_selector);
+    PseudoJetConversion pseudo_jet_conversion;
+    CSVWriter csvfile ("/dev/null", 50);
+    const string q2_observable = "invariantMass";
+
+    vector<StageAllocations> stages = {{"select", {}}, {"search", {}}, {"observables", {}}, {"convert", {}}, {"write", {}}};
+    // the first pass is the warm-up, where the buffers grow to the size of the largest event
+    for (int pass = 0; pass < 2; pass++) {
+        for (StageAllocations& stage: stages)
+            stage.count = AllocationCount();
+        for (const GenEvent& hepmc_event: hepmc_events) {
+            AllocationCount start = threadAllocations();
+            event_analyzer.analyseEvent(hepmc_event);
+            stages[0].count = stages[0].count + (threadAllocations() - start);
+
+            start = threadAllocations();
+            const vector<ConstGenParticlePtr>& final_from_hard_process =
+                signal_particle_searcher.selectParticles(event_analyzer.getParticles(ParticleType::OutgoingHardProcessParticles));
+            stages[1].count = stages[1].count + (threadAllocations() - start);
+
+            start = threadAllocations();
+            const double q2 = event_analyzer.evaluateObservable(q2_observable, ParticleType::OutgoingHardProcessParticles);
+            const vector<ConstGenParticlePtr>& initial_particles = event_analyzer.getParticles(ParticleType::InitialParticles);
+            const int initial_particle_pid = initial_particles.empty() ? 0 : initial_particles.at(0)->abs_pid();
+            stages[2].count = stages[2].count + (threadAllocations() - start);
+
+            start = threadAllocations();
+            pseudo_jet_conversion.convertParticlesToPseudoJets(event_analyzer.getParticles(ParticleType::FinalParticles));
+            stages[3].count = stages[3].count + (threadAllocations() - start);
+
+            start = threadAllocations();
+            csvfile.writeEvent(q2, initial_particle_pid, final_from_hard_process);
+            stages[4].count = stages[4].count + (threadAllocations() - start);
+        }
+    }
+
+    bool failed = false;
+    cout << "Heap allocations per event after the warm-up (" << number_events << " events):" << endl;
+    for (const StageAllocations& stage: stages) {
+        cout << "  " << stage.stage << ": " << double(stage.count.allocations) / number_events << " allocations, "
+             << double(stage.count.bytes) / number_events << " bytes" << endl;
+        failed = failed || stage.count.allocations > 0;
+    }
+    cout << (failed ? "FAILED: the event loop allocates in the steady state" : "OK: no allocations in the steady state") << endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "SyntheticEventGenerator.h"
+#include "HepMC3/WriterAscii.h"
+#include "HepMC3/GenEvent.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/// writes a file with synthetic events that can replace the Pythia samples in the benchmarks and in quick checks
+int main (int argc, char* argv[]) {
+    // usage: generate_synthetic_events output.hepmc [--events N] [--multiplicity M] [--seed S] [--flavour 0|4|5] [--pthat min max]
+    if (argc < 2) {
+        cout << "usage: generate_synthetic_events output.hepmc [--events N] [--multiplicity M] [--seed S] "
+             << "[--flavour 0|4|5] [--pthat min max]" << endl;
+        return 1;
+    }
+    string output_filename = argv[1];
+    long number_events = 1000;
+    uint64_t seed = 12345;
+    SyntheticEventSettings settings;
+    for (int i = 2; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--events" && i + 1 < argc)
+            number_events = stol(argv[++i]);
+        else if (argument == "--multiplicity" && i + 1 < argc)
+            settings.mean_multiplicity = stod(argv[++i]);
+        else if (argument == "--seed" && i + 1 < argc)
+            seed = stoull(argv[++i]);
+        else if (argument == "--flavour" && i + 1 < argc)
+            settings.hard_flavour = stoi(argv[++i]);
+        else if (argument == "--pthat" && i + 2 < argc) {
+            settings.pthat_min = stod(argv[++i]);
+            settings.pthat_max = stod(argv[++i]);
+        }
+        else {
+            cout << "Unknown option " << argument << endl;
+            return 1;
+        }
+    }
+
+    WriterAscii output_file (output_filename);
+    if (output_file.failed()) {
+        cout << "Could not open " << output_filename << endl;
+        return 1;
+    }
+
+    SyntheticEventGenerator generator (settings, seed);
+    GenEvent hepmc_event (Units::GEV, Units::MM);
+    for (long evt_number = 0; evt_number < number_events; evt_number++) {
+        generator.generate(hepmc_event);
+        output_file.write_event(hepmc_event);
+    }
+    output_file.close();
+
+    cout << "Wrote " << number_events << " synthetic events to " << output_filename << endl;
+    return 0;
+}
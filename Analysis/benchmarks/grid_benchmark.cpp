@@ -0,0 +1,153 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <deque>
+#include <cmath>
+#include "SyntheticEventGenerator.h"
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/EtaPhiGrid.h"
+#include "HepMC3/GenEvent.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/// @brief - results of the queries of one event: for each particle, the number of particles in its cone and its nearest neighbour
+struct QueryResults {
+    vector<int> counts;
+    vector<int> nearest;
+};
+
+double deltaR2 (double eta1, double phi1, double eta2, double phi2) {
+    const double dphi = remainder(phi1 - phi2, 2 * M_PI);
+    return (eta1 - eta2) * (eta1 - eta2) + dphi * dphi;
+}
+
+/// every particle against every other one
+void bruteForce (const vector<ConstGenParticlePtr>& particles, double radius, vector<double>& eta, vector<double>& phi, QueryResults& results) {
+    const size_t number_particles = particles.size();
+    eta.resize(number_particles);
+    phi.resize(number_particles);
+    for (size_t i = 0; i < number_particles; i++) {
+        eta[i] = particles[i]->momentum().eta();
+        phi[i] = particles[i]->momentum().phi();
+    }
+    results.counts.assign(number_particles, 0);
+    results.nearest.assign(number_particles, -1);
+    for (size_t i = 0; i < number_particles; i++) {
+        double nearest_distance2 = 0;
+        for (size_t j = 0; j < number_particles; j++) {
+            const double distance2 = deltaR2(eta[i], phi[i], eta[j], phi[j]);
+            if (distance2 < radius * radius)
+                results.counts[i]++;
+            if (j != i && (results.nearest[i] < 0 || distance2 < nearest_distance2)) {
+                results.nearest[i] = j;
+                nearest_distance2 = distance2;
+            }
+        }
+    }
+}
+
+/// the grid is built once and reused for all the queries of the event
+void gridQueries (const vector<ConstGenParticlePtr>& particles, double radius, EtaPhiGrid& grid, QueryResults& results) {
+    grid.build(particles);
+    const int number_particles = particles.size();
+    results.counts.resize(number_particles);
+    results.nearest.resize(number_particles);
+    for (int i = 0; i < number_particles; i++) {
+        results.counts[i] = grid.countWithinDeltaR(grid.eta(i), grid.phi(i), radius);
+        results.nearest[i] = grid.nearestNeighbour(grid.eta(i), grid.phi(i), i);
+    }
+}
+
+/// compares the eta-phi grid against the brute force for the cone and nearest-neighbour queries of every particle
+int main (int argc, char* argv[]) {
+    // usage: grid_benchmark [--events N] [--multiplicity M] [--seed S] [--radius R] [--cell-size C] [--max-eta E]
+    long number_events = 200;
+    uint64_t seed = 12345;
+    double radius = 0.4, cell_size = 0.4, max_eta = 0.9;
+    SyntheticEventSettings settings;
+    settings.mean_multiplicity = 2000;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--events" && i + 1 < argc)
+            number_events = stol(argv[++i]);
+        else if (argument == "--multiplicity" && i + 1 < argc)
+            settings.mean_multiplicity = stod(argv[++i]);
+        else if (argument == "--seed" && i + 1 < argc)
+            seed = stoull(argv[++i]);
+        else if (argument == "--radius" && i + 1 < argc)
+            radius = stod(argv[++i]);
+        else if (argument == "--cell-size" && i + 1 < argc)
+            cell_size = stod(argv[++i]);
+        else if (argument == "--max-eta" && i + 1 < argc)
+            max_eta = stod(argv[++i]);
+        else {
+            cout << "Unknown option " << argument << endl;
+            return 1;
+        }
+    }
+    if (number_events <= 0 || radius <= 0 || cell_size <= 0 || max_eta <= 0) {
+        cout << "The number of events, radius, cell size and eta range must be positive" << endl;
+        return 1;
+    }
+
+    // high-multiplicity events, generated once and kept in memory with their final state particles
+    SyntheticEventGenerator generator (settings, seed);
+    const FinalStateSelector final_state_selector;
+    EventAnalyzer event_analyzer;
+    event_analyzer.addParticleSelector(ParticleType::FinalParticles, &final_state_selector);
+    deque<GenEvent> hepmc_events;
+    vector<vector<ConstGenParticlePtr>> events;
+    long total_particles = 0;
+    for (long i = 0; i < number_events; i++) {
+        hepmc_events.emplace_back(Units::GEV, Units::MM);
+        generator.generate(hepmc_events.back());
+        event_analyzer.analyseEvent(hepmc_events.back());
+        events.push_back(event_analyzer.getParticles(ParticleType::FinalParticles));
+        total_particles += events.back().size();
+    }
+
+    // brute force
+    vector<QueryResults> brute_force_results (events.size());
+    vector<double> eta, phi;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < events.size(); i++)
+        bruteForce(events[i], radius, eta, phi, brute_force_results[i]);
+    chrono::duration<double, milli> brute_force_time = chrono::steady_clock::now() - start;
+
+    // grid
+    vector<QueryResults> grid_results (events.size());
+    EtaPhiGrid grid (max_eta, cell_size);
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < events.size(); i++)
+        gridQueries(events[i], radius, grid, grid_results[i]);
+    chrono::duration<double, milli> grid_time = chrono::steady_clock::now() - start;
+
+    // the counts must be the same, and the nearest neighbours at the same distance (ties may pick another particle)
+    long mismatches = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        const vector<ConstGenParticlePtr>& particles = events[i];
+        for (size_t j = 0; j < particles.size(); j++) {
+            const int brute_force_nearest = brute_force_results[i].nearest[j], grid_nearest = grid_results[i].nearest[j];
+            bool same_nearest = brute_force_nearest == grid_nearest;
+            if (!same_nearest && brute_force_nearest >= 0 && grid_nearest >= 0) {
+                const FourVector& momentum = particles[j]->momentum();
+                const double brute_force_distance2 = deltaR2(momentum.eta(), momentum.phi(), particles[brute_force_nearest]->momentum().eta(), particles[brute_force_nearest]->momentum().phi());
+                const double grid_distance2 = deltaR2(momentum.eta(), momentum.phi(), particles[grid_nearest]->momentum().eta(), particles[grid_nearest]->momentum().phi());
+                same_nearest = abs(brute_force_distance2 - grid_distance2) <= 1e-12 * (1 + brute_force_distance2);
+            }
+            if (brute_force_results[i].counts[j] != grid_results[i].counts[j] || !same_nearest)
+                mismatches++;
+        }
+    }
+
+    cout << "Cone (R = " << radius << ") and nearest-neighbour queries of every particle, " << events.size() << " events, "
+         << double(total_particles) / events.size() << " particles/event" << endl;
+    cout << "  brute force: " << brute_force_time.count() / events.size() << " ms/event" << endl;
+    cout << "  eta-phi grid (cells of " << cell_size << ", |eta| < " << max_eta << "): " << grid_time.count() / events.size()
+         << " ms/event, " << brute_force_time.count() / grid_time.count() << "x faster" << endl;
+    cout << "  particles with different results: " << mismatches << endl;
+    return mismatches == 0 ? 0 : 1;
+}
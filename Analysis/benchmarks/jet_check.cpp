@@ -0,0 +1,71 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "SyntheticEventGenerator.h"
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/JetClustering.h"
+#include "Analysis/JetSubstructure.h"
+#include "Analysis/JetObservables.h"
+#include "HepMC3/GenEvent.h"
+#include "fastjet/Error.hh"
+
+using namespace std;
+using namespace HepMC3;
+
+/// regression check: the jets of a plain ClusterSequence (no areas, as the "jets" entries of the pipeline without
+/// subtraction) go through the jet stages, which must keep all their constituents
+int main (int argc, char* argv[]) {
+    // usage: jet_check [number of events]
+    const long number_events = argc > 1 ? stol(argv[1]) : 100;
+
+    SyntheticEventGenerator generator (SyntheticEventSettings(), 2024);
+    GenEvent hepmc_event (Units::GEV, Units::MM);
+    const FinalStateSelector final_state_selector;
+    const ChargedParticlesSelector charged_particle_selector;
+    const MultipleParticleSelectors particle_selector({&final_state_selector, &charged_particle_selector});
+    EventAnalyzer event_analyzer;
+    event_analyzer.addParticleSelector(ParticleType::FinalParticles, &particle_selector);
+    JetClustering jet_clustering (0.4, 5, fastjet::antikt_algorithm);
+    // without grooming (z_cut = 0) the groomed jet is the C/A reclustering of all the constituents
+    JetDeclustering jet_declustering (0.4, {{0., 0.}});
+    // the angularity with kappa = beta = 0 is the number of constituents
+    JetObservableSettings observable_settings;
+    observable_settings.angularities = {{0., 0.}};
+    JetObservableCalculator jet_observables (observable_settings);
+
+    long number_jets = 0;
+    bool failed = false;
+    try {
+        for (long i = 0; i < number_events; i++) {
+            generator.generate(hepmc_event);
+            event_analyzer.analyseEvent(hepmc_event);
+            for (const fastjet::PseudoJet& jet: jet_clustering.clusterJets(event_analyzer.getParticles(ParticleType::FinalParticles))) {
+                number_jets++;
+                const size_t number_constituents = jet.constituents().size();
+                if (!jet_declustering.decluster(jet) || jet_declustering.primaryLundPlane().size() >= number_constituents
+                    || abs(jet_declustering.groomedJet(0).pt() - jet.pt()) > 1e-9 * jet.pt()) {
+                    cout << "Event " << i << ": the declustering lost constituents of a jet" << endl;
+                    failed = true;
+                }
+                double multiplicity;
+                jet_observables.evaluate(jet, &multiplicity);
+                if (multiplicity != double(number_constituents)) {
+                    cout << "Event " << i << ": the jet observables lost constituents of a jet" << endl;
+                    failed = true;
+                }
+            }
+        }
+    }
+    catch (const fastjet::Error& error) {
+        cout << "fastjet error: " << error.message() << endl;
+        failed = true;
+    }
+    if (number_jets == 0) {
+        cout << "No jets in " << number_events << " events" << endl;
+        failed = true;
+    }
+    cout << (failed ? "FAILED: the jet stages do not handle the jets without areas" : "OK: " + to_string(number_jets) + " jets without areas declustered and evaluated") << endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include "Analysis/SimdKernels.h"
+
+using namespace std;
+
+
+/// @brief - the outputs of all the kernels for one level, compared bit by bit with the generic level
+struct KernelResults {
+    vector<double> distance2, axis_distance, theta, dots;
+    vector<double> pt_sums;
+    vector<int> counts;
+};
+
+bool sameBits (const vector<double>& x, const vector<double>& y) {
+    return x.size() == y.size() && (x.empty() || memcmp(x.data(), y.data(), x.size() * sizeof(double)) == 0);
+}
+
+/// @brief - the loops of the jet observables on a jet of n constituents and the cones of the grid on the particles of an event
+/// @return - the time of each kernel in ms
+vector<double> runKernels (const SimdKernels& kernels, const vector<double>& rap, const vector<double>& phi, const vector<double>& pt,
+                          size_t jet_size, int repeat, double radius, KernelResults& results) {
+    const size_t n = jet_size;
+    vector<double> times (5, 0.);
+    results.distance2.resize(n * n);
+    results.axis_distance.resize(n);
+    results.theta.resize(n * n);
+    results.dots.assign(2 * n, 0.);
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        kernels.pairwise_distance2(rap.data(), phi.data(), n, results.distance2.data());
+        kernels.axis_distance(rap.data(), phi.data(), n, rap[0], phi[0], results.axis_distance.data());
+    }
+    times[0] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++)
+        kernels.sqrt_values(results.distance2.data(), n * n, results.theta.data());
+    times[1] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    /// the sums of the EFPs: one dot2 and one dot3 per row of the matrix
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++)
+        for (size_t i = 0; i < n; i++) {
+            const double* theta_i = results.theta.data() + i * n;
+            results.dots[i] = kernels.dot2(pt.data(), theta_i, n);
+            results.dots[n + i] = kernels.dot3(pt.data(), theta_i, theta_i, n);
+        }
+    times[2] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    /// one cone around each particle of the event
+    const size_t number_particles = rap.size();
+    results.counts.assign(number_particles, 0);
+    results.pt_sums.assign(number_particles, 0.);
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < number_particles; i++)
+        results.counts[i] = kernels.count_within(rap.data(), phi.data(), number_particles, rap[i], phi[i], radius * radius);
+    times[3] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < number_particles; i++)
+        results.pt_sums[i] = kernels.pt_within(rap.data(), phi.data(), pt.data(), number_particles, rap[i], phi[i], radius * radius);
+    times[4] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return times;
+}
+
+/// times the SIMD levels supported by the CPU against the generic level, and checks that they give the same results
+int main (int argc, char* argv[]) {
+    // usage: simd_benchmark [--particles N] [--jet-size n] [--repeat R] [--radius r] [--seed S]
+    long number_particles = 4000, jet_size = 150;
+    int repeat = 200;
+    double radius = 0.4;
+    uint64_t seed = 12345;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--particles" && i + 1 < argc)
+            number_particles = stol(argv[++i]);
+        else if (argument == "--jet-size" && i + 1 < argc)
+            jet_size = stol(argv[++i]);
+        else if (argument == "--repeat" && i + 1 < argc)
+            repeat = stoi(argv[++i]);
+        else if (argument == "--radius" && i + 1 < argc)
+            radius = stod(argv[++i]);
+        else if (argument == "--seed" && i + 1 < argc)
+            seed = stoull(argv[++i]);
+        else {
+            cout << "Unknown option " << argument << endl;
+            return 1;
+        }
+    }
+    if (number_particles <= 0 || jet_size <= 0 || jet_size > number_particles || repeat <= 0 || radius <= 0) {
+        cout << "The number of particles, jet size (at most the number of particles), repetitions and radius must be positive" << endl;
+        return 1;
+    }
+
+    // particles of the acceptance, phi in [0, 2pi) as in the grid and the jets, pT falling like a spectrum
+    mt19937_64 generator (seed);
+    uniform_real_distribution<double> uniform (0., 1.);
+    vector<double> rap (number_particles), phi (number_particles), pt (number_particles);
+    for (long i = 0; i < number_particles; i++) {
+        rap[i] = -0.9 + 1.8 * uniform(generator);
+        phi[i] = 2 * M_PI * uniform(generator);
+        pt[i] = 0.15 / pow(1. - 0.99 * uniform(generator), 1.5);
+    }
+
+    const char* kernel_names[5] = {"deltaR matrix + axis", "sqrt", "dot2 + dot3", "cone count", "cone pT sum"};
+    const SimdKernels& selected_kernels = simdKernels();
+    cout << "SIMD kernels: jet of " << jet_size << " constituents (x" << repeat << "), cones of R = " << radius << " around "
+         << number_particles << " particles" << endl;
+    cout << "selected level: " << simdLevelName(selected_kernels.level) << " (ANALYSIS_SIMD_LEVEL to force a lower one)" << endl;
+    KernelResults generic_results;
+    const vector<double> generic_times = runKernels(simdKernels(GenericSimd), rap, phi, pt, jet_size, repeat, radius, generic_results);
+    bool identical = true;
+    for (int level = 0; level < NumberOfSimdLevels; level++) {
+        if (!simdLevelSupported(SimdLevel(level))) {
+            cout << "  " << simdLevelName(SimdLevel(level)) << ": not supported by this CPU or build" << endl;
+            continue;
+        }
+        KernelResults results;
+        const vector<double> times = level == GenericSimd ? generic_times : runKernels(simdKernels(SimdLevel(level)), rap, phi, pt, jet_size, repeat, radius, results);
+        const bool same = level == GenericSimd || (sameBits(results.distance2, generic_results.distance2) && sameBits(results.axis_distance, generic_results.axis_distance)
+            && sameBits(results.theta, generic_results.theta) && sameBits(results.dots, generic_results.dots)
+            && sameBits(results.pt_sums, generic_results.pt_sums) && results.counts == generic_results.counts);
+        identical = identical && same;
+        cout << "  " << simdLevelName(SimdLevel(level)) << (same ? "" : " (DIFFERENT RESULTS)") << ":" << endl;
+        for (int k = 0; k < 5; k++) {
+            char line[128];
+            snprintf(line, sizeof(line), "    %-22s %9.3f ms  %5.2fx", kernel_names[k], times[k], generic_times[k] / times[k]);
+            cout << line << endl;
+        }
+    }
+    return identical ? 0 : 1;
+}
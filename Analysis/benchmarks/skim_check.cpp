@@ -0,0 +1,161 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <set>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <unistd.h>
+#include "SyntheticEventGenerator.h"
+#include "Analysis/SkimFormat.h"
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/// @brief - the particles of the event with the status, in the order of the event
+vector<ConstGenParticlePtr> particlesWithStatus (const GenEvent& hepmc_event, int status) {
+    vector<ConstGenParticlePtr> particles;
+    for (const ConstGenParticlePtr& particle: hepmc_event.particles())
+        if (particle->status() == status)
+            particles.push_back(particle);
+    return particles;
+}
+
+/// @brief - positions (among the final particles) of the final particles coming from the particle
+set<int> finalDescendants (const ConstGenParticlePtr& particle, const vector<int>& final_index) {
+    set<int> descendants;
+    set<int> visited_vertices;
+    vector<ConstGenVertexPtr> vertices_to_visit;
+    if (particle->end_vertex())
+        vertices_to_visit.push_back(particle->end_vertex());
+    while (!vertices_to_visit.empty()) {
+        const ConstGenVertexPtr vertex = vertices_to_visit.back();
+        vertices_to_visit.pop_back();
+        if (!visited_vertices.insert(vertex->id()).second)
+            continue;
+        for (const ConstGenParticlePtr& child: vertex->particles_out()) {
+            if (child->status() == 1)
+                descendants.insert(final_index[child->id() - 1]);
+            if (child->end_vertex())
+                vertices_to_visit.push_back(child->end_vertex());
+        }
+    }
+    return descendants;
+}
+
+/// @brief - position of each particle (index id - 1) among the final particles, -1 for the others
+vector<int> finalIndex (const GenEvent& hepmc_event) {
+    vector<int> final_index (hepmc_event.particles().size(), -1);
+    int number_final = 0;
+    for (const ConstGenParticlePtr& particle: hepmc_event.particles())
+        if (particle->status() == 1)
+            final_index[particle->id() - 1] = number_final++;
+    return final_index;
+}
+
+/// @brief - an event with more hard process particles than the 32 bits of the ancestor masks: each hard particle
+///          decays to two final particles, the first two also share a third one, and one final particle has no ancestor
+void manyHardParticlesEvent (GenEvent& hepmc_event, int number_hard) {
+    hepmc_event.clear();
+    hepmc_event.set_units(Units::GEV, Units::MM);
+    GenVertexPtr hard_vertex = make_shared<GenVertex>();
+    for (int i = 0; i < 2; i++)
+        hard_vertex->add_particle_in(make_shared<GenParticle>(FourVector(0, 0, i == 0 ? 100 : -100, 100), 21, 21));
+    hepmc_event.add_vertex(hard_vertex);
+    vector<GenVertexPtr> decays;
+    for (int hard = 0; hard < number_hard; hard++) {
+        GenParticlePtr hard_particle = make_shared<GenParticle>(FourVector(1 + hard, 1, 1, 2 + hard), 21, 23);
+        hard_vertex->add_particle_out(hard_particle);
+        decays.push_back(make_shared<GenVertex>());
+        decays.back()->add_particle_in(hard_particle);
+        decays.back()->add_particle_out(make_shared<GenParticle>(FourVector(0.5 + hard, 0.5, 0.5, 1 + hard), 211, 1));
+        decays.back()->add_particle_out(make_shared<GenParticle>(FourVector(0.5 + hard, 0.5, 0.5, 1 + hard), -211, 1));
+        hepmc_event.add_vertex(decays.back());
+    }
+    GenVertexPtr shared = make_shared<GenVertex>();
+    for (int hard = 0; hard < 2; hard++) {
+        GenParticlePtr shower = make_shared<GenParticle>(FourVector(1, 1, 1, 2), 21, 51);
+        decays[hard]->add_particle_out(shower);
+        shared->add_particle_in(shower);
+    }
+    shared->add_particle_out(make_shared<GenParticle>(FourVector(1, 1, 1, 2), 321, 1));
+    hepmc_event.add_vertex(shared);
+    hepmc_event.add_particle(make_shared<GenParticle>(FourVector(1, 0, 0, 1), 2212, 1));
+}
+
+/// @brief - compares the reduced event read from the skim with the original one
+/// @return - the description of the first difference, empty if there is none
+string compareEvents (const GenEvent& original, const GenEvent& skimmed) {
+    const int statuses[3] = {21, 23, 1};
+    for (int status: statuses) {
+        const vector<ConstGenParticlePtr> original_particles = particlesWithStatus(original, status), skimmed_particles = particlesWithStatus(skimmed, status);
+        if (original_particles.size() != skimmed_particles.size())
+            return "different number of status " + to_string(status) + " particles";
+        for (size_t i = 0; i < original_particles.size(); i++)
+            if (original_particles[i]->pid() != skimmed_particles[i]->pid())
+                return "different pid of the status " + to_string(status) + " particle " + to_string(i);
+    }
+    /// the final particles of the first 32 hard particles are kept, the others have no descendants in the skim
+    const vector<ConstGenParticlePtr> original_hard = particlesWithStatus(original, 23), skimmed_hard = particlesWithStatus(skimmed, 23);
+    const vector<int> original_final_index = finalIndex(original), skimmed_final_index = finalIndex(skimmed);
+    for (size_t hard = 0; hard < original_hard.size(); hard++) {
+        const set<int> expected = hard < 32 ? finalDescendants(original_hard[hard], original_final_index) : set<int>();
+        if (finalDescendants(skimmed_hard[hard], skimmed_final_index) != expected)
+            return "different final particles from the hard particle " + to_string(hard);
+    }
+    return "";
+}
+
+/// regression check: the events read back from a skim have the particles and the hard process descendants of the originals
+int main (int argc, char* argv[]) {
+    // usage: skim_check [number of events]
+    const long number_events = argc > 1 ? stol(argv[1]) : 200;
+    const char* temporary_directory = getenv("TMPDIR");
+    const string skim_filename = string(temporary_directory ? temporary_directory : "/tmp") + "/skim_check_" + to_string(getpid()) + ".skim";
+
+    // synthetic events, then events with more hard particles than the bits of the masks
+    SyntheticEventGenerator generator (SyntheticEventSettings(), 2024);
+    deque<GenEvent> hepmc_events;
+    for (long i = 0; i < number_events; i++) {
+        hepmc_events.emplace_back(Units::GEV, Units::MM);
+        generator.generate(hepmc_events.back());
+    }
+    const int many_hard_particles[3] = {32, 33, 40};
+    for (int number_hard: many_hard_particles) {
+        hepmc_events.emplace_back(Units::GEV, Units::MM);
+        manyHardParticlesEvent(hepmc_events.back(), number_hard);
+    }
+
+    SkimWriter writer (skim_filename);
+    for (const GenEvent& hepmc_event: hepmc_events)
+        writer.write_event(hepmc_event);
+    writer.close();
+    if (writer.failed()) {
+        cout << "FAILED: could not write " << skim_filename << endl;
+        return 1;
+    }
+
+    bool failed = false;
+    SkimReader reader (skim_filename);
+    GenEvent skimmed_event;
+    size_t events_read = 0;
+    for (; events_read < hepmc_events.size() && reader.read_event(skimmed_event); events_read++) {
+        const string difference = compareEvents(hepmc_events[events_read], skimmed_event);
+        if (!difference.empty()) {
+            cout << "Event " << events_read << ": " << difference << endl;
+            failed = true;
+        }
+    }
+    reader.close();
+    std::remove(skim_filename.c_str());
+    if (events_read != hepmc_events.size() || reader.readFailed()) {
+        cout << "Read " << events_read << " out of " << hepmc_events.size() << " events" << endl;
+        failed = true;
+    }
+    cout << (failed ? "FAILED: the skim does not reproduce the events" : "OK: the skim reproduces the events") << endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,353 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <deque>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <unistd.h>
+#include <thread>
+#include "SyntheticEventGenerator.h"
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/Observable.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/SignalParticlesSearcher.h"
+#include "Analysis/JetClustering.h"
+#include "Analysis/JetSubstructure.h"
+#include "Analysis/JetObservables.h"
+#include "Analysis/CSVWriter.h"
+#include "Analysis/SkimFormat.h"
+#include "Analysis/Instrumentation.h"
+#include "HepMC3/ReaderAscii.h"
+#include "HepMC3/WriterAscii.h"
+#include "HepMC3/GenEvent.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/// @brief - settings of the run, written in every result line
+struct BenchmarkRun {
+    long number_events = 2000;
+    int repeats = 5;
+    uint64_t seed = 12345;
+    SyntheticEventSettings settings;
+    string label = "local";
+    long timestamp = 0;
+    /// @brief - file of the events, empty for the synthetic events
+    string input_filename;
+};
+
+/// @brief - timing of one stage
+struct StageResult {
+    string stage;
+    long events;
+    long particles;
+    double seconds;
+};
+
+/// runs the stage `repeats` times and keeps the fastest run (the least disturbed by the rest of the machine)
+double bestTime (int repeats, const function<void()>& stage) {
+    double best = -1;
+    for (int i = 0; i < repeats; i++) {
+        auto start = chrono::steady_clock::now();
+        stage();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+/// writes the result as one JSON object per line, so the results of many runs can be appended to the same file
+void writeResult (ostream& output, const BenchmarkRun& run, const StageResult& result) {
+    char line[1024];
+    snprintf(line, sizeof(line),
+             "{\"stage\": \"%s\", \"events\": %ld, \"particles\": %ld, \"seconds\": %.6g, \"events_per_second\": %.6g, "
+             "\"ns_per_particle\": %.6g, \"seed\": %llu, \"multiplicity\": %g, \"repeats\": %d, \"label\": %s, \"input\": %s, \"timestamp\": %ld}",
+             result.stage.c_str(), result.events, result.particles, result.seconds, result.events / result.seconds,
+             result.particles > 0 ? 1e9 * result.seconds / result.particles : 0., (unsigned long long) run.seed,
+             run.settings.mean_multiplicity, run.repeats, jsonString(run.label).c_str(),
+             jsonString(run.input_filename.empty() ? "synthetic" : run.input_filename).c_str(), run.timestamp);
+    output << line << endl;
+}
+
+/// per-stage benchmarks of the analysis chain of select_hepmc_particles on synthetic events (or the events of a file)
+int main (int argc, char* argv[]) {
+    // usage: stage_benchmarks [--events N] [--repeats R] [--multiplicity M] [--seed S] [--flavour 0|4|5] [--label L] [--output results.jsonl]
+    //                         [--hepmc-file events.hepmc]
+    // --hepmc-file runs all the stages on the first N events of an existing file instead of the synthetic events (the file is only read)
+    BenchmarkRun run;
+    string output_filename;
+    string& input_filename = run.input_filename;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--events" && i + 1 < argc)
+            run.number_events = stol(argv[++i]);
+        else if (argument == "--repeats" && i + 1 < argc)
+            run.repeats = stoi(argv[++i]);
+        else if (argument == "--multiplicity" && i + 1 < argc)
+            run.settings.mean_multiplicity = stod(argv[++i]);
+        else if (argument == "--seed" && i + 1 < argc)
+            run.seed = stoull(argv[++i]);
+        else if (argument == "--flavour" && i + 1 < argc)
+            run.settings.hard_flavour = stoi(argv[++i]);
+        else if (argument == "--label" && i + 1 < argc)
+            run.label = argv[++i];
+        else if (argument == "--output" && i + 1 < argc)
+            output_filename = argv[++i];
+        else if (argument == "--hepmc-file" && i + 1 < argc)
+            input_filename = argv[++i];
+        else {
+            cout << "Unknown option " << argument << endl;
+            return 1;
+        }
+    }
+    if (run.number_events <= 0 || run.repeats <= 0) {
+        cout << "The number of events and repeats must be positive" << endl;
+        return 1;
+    }
+    run.timestamp = time(nullptr);
+
+    // the events are generated (or read from the file) once and kept in memory (deque: no copies of the events)
+    deque<GenEvent> hepmc_events;
+    long total_particles = 0;
+    if (input_filename.empty()) {
+        SyntheticEventGenerator generator (run.settings, run.seed);
+        for (long i = 0; i < run.number_events; i++) {
+            hepmc_events.emplace_back(Units::GEV, Units::MM);
+            generator.generate(hepmc_events.back());
+        }
+    }
+    else {
+        ReaderAscii hepmc_file (input_filename);
+        for (long i = 0; i < run.number_events; i++) {
+            hepmc_events.emplace_back(Units::GEV, Units::MM);
+            hepmc_file.read_event(hepmc_events.back());
+            if (hepmc_file.failed()) {
+                hepmc_events.pop_back();
+                break;
+            }
+        }
+        if (hepmc_events.empty()) {
+            cout << "No events could be read from " << input_filename << endl;
+            return 1;
+        }
+        if (long(hepmc_events.size()) < run.number_events)
+            cout << "Only " << hepmc_events.size() << " events in " << input_filename << ", the stages run on them" << endl;
+        run.number_events = hepmc_events.size();
+    }
+    for (const GenEvent& hepmc_event: hepmc_events)
+        total_particles += hepmc_event.particles().size();
+
+    // and written to a file and to a skim for the reading stages, in a directory of the benchmark removed at the end
+    const char* temporary_root = getenv("TMPDIR");
+    string temporary_directory = string(temporary_root && *temporary_root ? temporary_root : "/tmp") + "/stage_benchmarks_XXXXXX";
+    if (!mkdtemp(&temporary_directory[0])) {
+        cout << "Could not create a temporary directory for the synthetic events" << endl;
+        return 1;
+    }
+    const string synthetic_filename = temporary_directory + "/events.hepmc";
+    const string skim_filename = temporary_directory + "/events.skim";
+    const string hepmc_filename = input_filename.empty() ? synthetic_filename : input_filename;
+    {
+        SkimWriter skim_output (skim_filename);
+        for (const GenEvent& hepmc_event: hepmc_events)
+            skim_output.write_event(hepmc_event);
+        skim_output.close();
+    }
+    if (input_filename.empty()) {
+        WriterAscii hepmc_output (synthetic_filename);
+        for (const GenEvent& hepmc_event: hepmc_events)
+            hepmc_output.write_event(hepmc_event);
+        hepmc_output.close();
+    }
+    auto removeTemporaryFiles = [&]() {
+        remove(synthetic_filename.c_str());
+        remove(skim_filename.c_str());
+        rmdir(temporary_directory.c_str());
+    };
+
+    // same selection as select_hepmc_particles
+    const FinalStateSelector final_state_selector;
+    const ChargedParticlesSelector charged_particle_selector;
+    const MultipleParticleSelectors hepmc_particle_selector({&final_state_selector, &charged_particle_selector});
+    const InitialStateSelector initial_particle_selector;
+    const OutgoingParticlesFromHardProcess final_hard_process_particles;
+    const InvariantMass invariant_mass;
+    EventAnalyzer event_analyzer;
+    event_analyzer.addParticleSelector(ParticleType::FinalParticles, &hepmc_particle_selector);
+    event_analyzer.addParticleSelector(ParticleType::InitialParticles, &initial_particle_selector);
+    event_analyzer.addParticleSelector(ParticleType::OutgoingHardProcessParticles, &final_hard_process_particles);
+    SignalParticlesSearcher signal_particle_searcher (&hepmc_particle_selector);
+    JetClustering jet_clustering (0.4, 5, fastjet::antikt_algorithm);
+
+    // inputs of the later stages, computed once so each stage is timed alone
+    vector<vector<ConstGenParticlePtr>> final_particles, hard_particles, signal_particles;
+    vector<double> q2s;
+    vector<int> initial_pids;
+    long number_final_particles = 0, number_hard_particles = 0, number_signal_particles = 0;
+    for (const GenEvent& hepmc_event: hepmc_events) {
+        event_analyzer.analyseEvent(hepmc_event);
+        final_particles.push_back(event_analyzer.getParticles(ParticleType::FinalParticles));
+        hard_particles.push_back(event_analyzer.getParticles(ParticleType::OutgoingHardProcessParticles));
+        signal_particles.push_back(signal_particle_searcher.selectParticles(hard_particles.back()));
+        const vector<ConstGenParticlePtr>& initial_particles = event_analyzer.getParticles(ParticleType::InitialParticles);
+        initial_pids.push_back(initial_particles.empty() ? 0 : initial_particles.at(0)->abs_pid());
+        q2s.push_back(invariant_mass.evaluateObservable(hard_particles.back()));
+        number_final_particles += final_particles.back().size();
+        number_hard_particles += hard_particles.back().size();
+        number_signal_particles += signal_particles.back().size();
+    }
+
+    vector<StageResult> results;
+    const long n = run.number_events;
+
+    long events_read = 0, particles_read = 0;
+    double seconds = bestTime(run.repeats, [&]() {
+        ReaderAscii hepmc_file (hepmc_filename);
+        GenEvent hepmc_event (Units::GEV, Units::MM);
+        events_read = 0;
+        particles_read = 0;
+        // the events of the other stages (the first n of the given file)
+        while (events_read < n) {
+            hepmc_file.read_event(hepmc_event);
+            if (hepmc_file.failed()) break;
+            events_read++;
+            particles_read += hepmc_event.particles().size();
+        }
+    });
+    if (events_read != n)
+        cout << "Read " << events_read << " events out of " << n << " from " << hepmc_filename << endl;
+    if (events_read == 0) {
+        cout << "No events could be read from " << hepmc_filename << endl;
+        removeTemporaryFiles();
+        return 1;
+    }
+    results.push_back({"read", events_read, particles_read, seconds});
+
+    // the same events from the skim (normalised by the particles of the full events, to compare with the read stage)
+    seconds = bestTime(run.repeats, [&]() {
+        SkimReader skim_file (skim_filename);
+        GenEvent hepmc_event (Units::GEV, Units::MM);
+        events_read = 0;
+        while (skim_file.read_event(hepmc_event))
+            events_read++;
+    });
+    if (events_read != n)
+        cout << "Read " << events_read << " events out of " << n << " from " << skim_filename << endl;
+    results.push_back({"read_skim", events_read, total_particles, seconds});
+
+    seconds = bestTime(run.repeats, [&]() {
+        for (const GenEvent& hepmc_event: hepmc_events)
+            event_analyzer.analyseEvent(hepmc_event);
+    });
+    results.push_back({"analyse", n, total_particles, seconds});
+
+    long selected = 0;
+    seconds = bestTime(run.repeats, [&]() {
+        selected = 0;
+        for (const vector<ConstGenParticlePtr>& particles: hard_particles)
+            selected += signal_particle_searcher.selectParticles(particles).size();
+    });
+    // the cost grows with the size of the decay graph below the hard process, normalised here by the event size
+    results.push_back({"search", n, total_particles, seconds});
+
+    double sum_q2 = 0;
+    seconds = bestTime(run.repeats, [&]() {
+        sum_q2 = 0;
+        for (const vector<ConstGenParticlePtr>& particles: hard_particles)
+            sum_q2 += invariant_mass.evaluateObservable(particles);
+    });
+    results.push_back({"invariant_mass", n, number_hard_particles, seconds});
+
+    size_t number_jets = 0;
+    seconds = bestTime(run.repeats, [&]() {
+        number_jets = 0;
+        for (const vector<ConstGenParticlePtr>& particles: final_particles)
+            number_jets += jet_clustering.clusterJets(particles).size();
+    });
+    results.push_back({"cluster", n, number_final_particles, seconds});
+
+    // C/A declustering of the jets with two SoftDrop settings, normalised by the constituents of the jets
+    // the jets refer to their cluster sequence, so each event keeps its own (a deque does not move them)
+    const fastjet::JetDefinition jet_definition (fastjet::antikt_algorithm, 0.4);
+    deque<fastjet::ClusterSequence> cluster_sequences;
+    vector<vector<fastjet::PseudoJet>> jets;
+    vector<fastjet::PseudoJet> pseudo_jets;
+    long number_constituents = 0;
+    for (const vector<ConstGenParticlePtr>& particles: final_particles) {
+        pseudo_jets.clear();
+        for (const ConstGenParticlePtr& particle: particles) {
+            const FourVector& momentum = particle->momentum();
+            pseudo_jets.emplace_back(momentum.px(), momentum.py(), momentum.pz(), momentum.e());
+            pseudo_jets.back().set_user_index(particle->pid());
+        }
+        cluster_sequences.emplace_back(pseudo_jets, jet_definition);
+        jets.push_back(fastjet::sorted_by_pt(cluster_sequences.back().inclusive_jets(5)));
+        for (const fastjet::PseudoJet& jet: jets.back())
+            number_constituents += jet.constituents().size();
+    }
+    JetDeclustering jet_declustering (0.4, {{0., 0.1}, {1., 0.1}});
+    size_t number_splittings = 0;
+    seconds = bestTime(run.repeats, [&]() {
+        number_splittings = 0;
+        for (const vector<fastjet::PseudoJet>& event_jets: jets)
+            for (const fastjet::PseudoJet& jet: event_jets) {
+                jet_declustering.decluster(jet);
+                number_splittings += jet_declustering.primaryLundPlane().size();
+            }
+    });
+    results.push_back({"decluster", n, number_constituents, seconds});
+
+    // jet shapes of all the jets as one list, in one thread and in all the cores
+    vector<fastjet::PseudoJet> all_jets;
+    for (const vector<fastjet::PseudoJet>& event_jets: jets)
+        all_jets.insert(all_jets.end(), event_jets.begin(), event_jets.end());
+    JetObservableSettings observable_settings;
+    observable_settings.angularities = {{1., 0.5}, {1., 1.}, {1., 2.}};
+    observable_settings.correlator_betas = {1., 2.};
+    observable_settings.efp_betas = {1.};
+    vector<double> jet_features;
+    vector<int> thread_counts = {1};
+    if (thread::hardware_concurrency() > 1)
+        thread_counts.push_back(thread::hardware_concurrency());
+    for (int threads: thread_counts) {
+        JetObservableCalculator jet_observables (observable_settings, threads);
+        seconds = bestTime(run.repeats, [&]() {
+            jet_observables.evaluate(all_jets, jet_features);
+        });
+        results.push_back({threads == 1 ? "jet_observables" : "jet_observables_threads", n, number_constituents, seconds});
+    }
+
+    seconds = bestTime(run.repeats, [&]() {
+        CSVWriter csvfile ("/dev/null", 50);
+        for (long i = 0; i < n; i++)
+            csvfile.writeEvent(q2s[i], initial_pids[i], signal_particles[i]);
+        csvfile.close();
+    });
+    results.push_back({"write", n, number_signal_particles, seconds});
+
+    // keeps the compiler from dropping the loops
+    if (selected < 0 || sum_q2 < 0 || number_jets > size_t(number_final_particles) || number_splittings > size_t(number_constituents))
+        cout << "Unexpected stage outputs" << endl;
+
+    removeTemporaryFiles();
+
+    ofstream output_file;
+    if (!output_filename.empty()) {
+        output_file.open(output_filename, ios::app);
+        if (!output_file.is_open()) {
+            cout << "Could not open " << output_filename << endl;
+            return 1;
+        }
+    }
+    ostream& output = output_filename.empty() ? cout : output_file;
+    for (const StageResult& result: results)
+        writeResult(output, run, result);
+    if (!output_filename.empty())
+        cout << "Appended " << results.size() << " results to " << output_filename << endl;
+    return 0;
+}
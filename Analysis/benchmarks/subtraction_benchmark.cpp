@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <deque>
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/JetClustering.h"
+#include "Analysis/EventAnalyzer.h"
+#include "HepMC3/ReaderAscii.h"
+#include "HepMC3/GenEvent.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/// times the jet clustering over all the stored events and returns the cost per event in microseconds
+double timeClustering (JetClustering& jet_clustering, const vector<vector<ConstGenParticlePtr>>& events, size_t& number_jets) {
+    number_jets = 0;
+    auto start = chrono::steady_clock::now();
+    for (const vector<ConstGenParticlePtr>& particles: events)
+        number_jets += jet_clustering.clusterJets(particles).size();
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count() / events.size();
+}
+
+/// compares the cost of the subtracted jet clustering against the unsubtracted one
+int main (int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "usage: subtraction_benchmark file.hepmc [number of events]" << endl;
+        return 1;
+    }
+    const size_t max_events = argc > 2 ? stoul(argv[2]) : 1000;
+
+    // selects the final state charged particles
+    const FinalStateSelector final_state_selector;
+    const ChargedParticlesSelector charged_particle_selector;
+    const MultipleParticleSelectors particle_selector({&final_state_selector, &charged_particle_selector});
+    EventAnalyzer event_analyzer;
+    event_analyzer.addParticleSelector(ParticleType::FinalParticles, &particle_selector);
+
+    // the events are kept in memory so that only the clustering is timed (deque: no copies of the events)
+    deque<GenEvent> hepmc_events;
+    vector<vector<ConstGenParticlePtr>> events;
+    ReaderAscii hepmc_file (argv[1]);
+    while (events.size() < max_events) {
+        hepmc_events.emplace_back(HepMC3::Units::GEV, HepMC3::Units::MM);
+        hepmc_file.read_event(hepmc_events.back());
+        if (hepmc_file.failed()) {
+            hepmc_events.pop_back();
+            break;
+        }
+        event_analyzer.analyseEvent(hepmc_events.back());
+        events.push_back(event_analyzer.getParticles(ParticleType::FinalParticles));
+    }
+    if (events.empty()) {
+        cout << "No events read from " << argv[1] << endl;
+        return 1;
+    }
+
+    JetClustering plain_clustering (0.4, 5, fastjet::antikt_algorithm);
+    SubtractedJetClustering grid_clustering (0.4, 5, fastjet::antikt_algorithm, GridMedianEstimator);
+    SubtractedJetClustering kt_clustering (0.4, 5, fastjet::antikt_algorithm, KtJetMedianEstimator);
+    // kT jets with the same radius as the rho estimation share the clustering
+    SubtractedJetClustering shared_kt_clustering (0.2, 5, fastjet::kt_algorithm, KtJetMedianEstimator);
+
+    vector<pair<string, JetClustering*>> clusterings = {
+        {"anti-kt R=0.4, no subtraction", &plain_clustering},
+        {"anti-kt R=0.4, grid-median rho", &grid_clustering},
+        {"anti-kt R=0.4, kt-median rho", &kt_clustering},
+        {"kt R=0.2, shared kt-median rho", &shared_kt_clustering}
+    };
+
+    cout << "Clustering cost per event over " << events.size() << " events" << endl;
+    double reference_cost = 0;
+    for (auto& clustering: clusterings) {
+        size_t number_jets;
+        const double cost = timeClustering(*clustering.second, events, number_jets);
+        if (reference_cost == 0)
+            reference_cost = cost;
+        cout << "  " << clustering.first << ": " << cost << " us/event, " << cost / reference_cost << "x, "
+             << double(number_jets) / events.size() << " jets/event" << endl;
+    }
+
+    return 0;
+}
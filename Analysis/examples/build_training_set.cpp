@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Analysis/TrainingSet.h"
+
+using namespace std;
+
+
+/// builds the labelled, class-balanced and shuffled training shards from the outputs of select_hepmc_particles
+/// (see TrainingSet.h), without loading the samples in memory
+int main (int argc, char* argv[]) {
+    // usage: build_training_set [--input-dir dir] [--suffix suffix] [--output prefix] [--shard-size N] [--buffer N] [--seed S]
+    //                           [--max-per-class N] [--async-output] [--class name file ... [--class name file ...]]
+    string input_dir = "/sampa/archive/caducka/jetsml/";
+    string suffix = "_from_hard_process.csv";
+    string output_prefix = "/sampa/archive/caducka/jetsml/training";
+    long shard_size = 100000;
+    long buffer_size = 200000;
+    uint64_t seed = 1;
+    long max_per_class = -1;
+    bool async_output = false;
+    // classes given with --class, in the order of their labels
+    vector<pair<string, vector<string>>> classes;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--input-dir" && i + 1 < argc)
+            input_dir = argv[++i];
+        else if (argument == "--suffix" && i + 1 < argc)
+            suffix = argv[++i];
+        else if (argument == "--output" && i + 1 < argc)
+            output_prefix = argv[++i];
+        else if (argument == "--shard-size" && i + 1 < argc)
+            shard_size = stol(argv[++i]);
+        else if (argument == "--buffer" && i + 1 < argc)
+            buffer_size = stol(argv[++i]);
+        else if (argument == "--seed" && i + 1 < argc)
+            seed = stoull(argv[++i]);
+        else if (argument == "--max-per-class" && i + 1 < argc)
+            max_per_class = stol(argv[++i]);
+        else if (argument == "--async-output")
+            async_output = true;
+        else if (argument == "--class" && i + 1 < argc)
+            classes.push_back({argv[++i], {}});
+        else if (!classes.empty() && argument.compare(0, 2, "--") != 0)
+            classes.back().second.push_back(argument);
+        else {
+            cout << "Unknown argument " << argument << endl;
+            return 1;
+        }
+    }
+    if (shard_size <= 0 || buffer_size <= 0) {
+        cout << "The shard size and the buffer must have at least one row" << endl;
+        return 1;
+    }
+
+    // by default the classes are the processes of select_hepmc_particles, with all their pT bins
+    if (classes.empty()) {
+        const vector<pair<string, vector<string>>> samples = {
+            {"bbbar", {"bbbar_prod_40_60", "bbbar_prod_90_110"}},
+            {"ccbar", {"ccbar_prod_20_30", "ccbar_prod_40_60", "ccbar_prod_90_110"}},
+            {"light", {"light_prod_20_30", "light_prod_40_60", "light_prod_90_110"}},
+            {"soft", {"soft_prod_20_30", "soft_prod_40_60", "soft_prod_90_110"}}
+        };
+        for (const auto& sample: samples) {
+            classes.push_back({sample.first, {}});
+            for (const string& filename: sample.second)
+                classes.back().second.push_back(input_dir + filename + suffix);
+        }
+    }
+
+    TrainingSetBuilder builder (output_prefix, shard_size, buffer_size, seed, async_output);
+    builder.setMaxRowsPerClass(max_per_class);
+    for (const auto& training_class: classes) {
+        cout << "class " << training_class.first << ": " << training_class.second.size() << " files" << endl;
+        if (!builder.addClass(training_class.first, training_class.second))
+            return 1;
+    }
+    if (!builder.build())
+        return 1;
+
+    cout << builder.rowsPerClass() << " rows per class, " << builder.rowsPerClass() * long(classes.size()) << " rows in "
+         << builder.numberShards() << " shards " << output_prefix << "_<i>.csv (labels in " << output_prefix << "_summary.txt)" << endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "Analysis/CSVConversion.h"
+
+using namespace std;
+
+
+/// @brief - the .npy file next to the CSV file
+string npyFilename (const string& csv_filename) {
+    const string extension = ".csv";
+    if (csv_filename.size() > extension.size() && csv_filename.compare(csv_filename.size() - extension.size(), extension.size(), extension) == 0)
+        return csv_filename.substr(0, csv_filename.size() - extension.size()) + ".npy";
+    return csv_filename + ".npy";
+}
+
+void printSummary (const string& action, const string& filename, const CSVConversionSummary& summary) {
+    char line[256];
+    snprintf(line, sizeof(line), "%s %s: %ld rows x %ld columns, %.1f MB in %.2f s (%.0f MB/s)", action.c_str(), filename.c_str(),
+             summary.rows, summary.columns, summary.input_bytes / 1e6, summary.seconds, summary.seconds > 0 ? summary.input_bytes / 1e6 / summary.seconds : 0.);
+    cout << line;
+    if (summary.short_rows > 0)
+        cout << ", " << summary.short_rows << " zero padded rows";
+    cout << endl;
+}
+
+/// converts the CSV files of CSVWriter into float32 .npy files (see CSVConversion.h)
+int main (int argc, char* argv[]) {
+    // usage: csv_to_npy [--threads N] [--validate | --check] file.csv ...
+    int number_threads = 0;
+    bool convert = true, validate = false;
+    vector<string> csv_filenames;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--threads" && i + 1 < argc)
+            number_threads = stoi(argv[++i]);
+        else if (argument == "--validate")
+            validate = true;
+        else if (argument == "--check") {
+            convert = false;
+            validate = true;
+        }
+        else
+            csv_filenames.push_back(argument);
+    }
+    if (csv_filenames.empty()) {
+        cout << "usage: csv_to_npy [--threads N] [--validate | --check] file.csv ..." << endl;
+        cout << "  writes file.npy next to each file.csv (np.load(\"file.npy\", mmap_mode=\"r\") in Python)" << endl;
+        cout << "  --validate compares the values of the .npy files with the CSV files after the conversion" << endl;
+        cout << "  --check only compares the existing .npy files with the CSV files" << endl;
+        return 1;
+    }
+
+    bool success = true;
+    for (const string& csv_filename: csv_filenames) {
+        const string npy_filename = npyFilename(csv_filename);
+        CSVConversionSummary summary;
+        if (convert) {
+            if (!convertCSVToNpy(csv_filename, npy_filename, number_threads, summary)) {
+                success = false;
+                continue;
+            }
+            printSummary("converted", csv_filename, summary);
+        }
+        if (validate) {
+            const bool valid = validateNpy(csv_filename, npy_filename, number_threads, summary);
+            printSummary(valid ? "validated" : "FAILED", npy_filename, summary);
+            if (!valid) {
+                cout << summary.mismatches << " values of " << npy_filename << " differ from " << csv_filename << endl;
+                success = false;
+            }
+        }
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/Observable.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/CSVWriter.h"
+#include "Analysis/SignalParticlesSearcher.h"
+#include "Analysis/BoundedQueue.h"
+#include "Analysis/PythiaEventSource.h"
+#include "HepMC3/GenEvent.h"
+#include "ProcessSettings.h"
+
+using namespace std;
+using namespace HepMC3;
+
+/**
+ * Generates a sample with Pythia and writes the CSV of select_hepmc_particles directly, without the HepMC3 file.
+ * The sample is split in shards as in generate_events (one Pythia instance per shard, with the same seeds and numbers
+ * of events), so it only depends on the base seed and the number of shards - not on the number of threads or on the
+ * machine. The generator threads take the shards one after the other, convert each event to a GenEvent and pass it
+ * through a bounded queue to the analysis threads, which run the analysis chain of select_hepmc_particles and write the CSV. The GenEvents are recycled through a second queue, so the number of
+ * events in memory is fixed. With more than one thread the order of the events in the CSV is not reproducible,
+ * but the set of events is.
+ * The filter options drop the events that fail the cuts of the GenerationFilter before the conversion; the number of
+ * events is then the number of accepted events and the filter efficiency is printed for the normalisation.
+ *
+ * usage: generate_select_particles --process <bbbar|ccbar|light|soft> --pthat-min <GeV> --pthat-max <GeV> --output <csv file>
+ *                                  [--events N] [--shards N] [--generators N] [--analysis-threads N] [--queue-size N]
+ *                                  [--seed S]
+ *                                  [--min-charged N] [--charged-pt-min GeV] [--charged-eta-max eta]
+ *                                  [--jet-pt-min GeV] [--jet-radius R] [--jet-eta-max eta]
+ **/
+
+/// @brief - what each shard generated, for the cross section of the sample
+struct ShardStatistics {
+    long generated_events = 0;
+    long tested_events = 0;
+    double sigma_mb = 0;
+};
+
+/// selectors, observable and searcher of select_hepmc_particles - each analysis thread has its own
+class AnalysisChain {
+    public:
+        AnalysisChain(): _particle_selector({&_final_state_selector, &_charged_particle_selector}), _signal_particle_searcher(&_particle_selector) {
+            _event_analyzer.addParticleSelector(ParticleType::FinalParticles, &_particle_selector);
+            _event_analyzer.addParticleSelector(ParticleType::InitialParticles, &_initial_particle_selector);
+            _event_analyzer.addParticleSelector(ParticleType::OutgoingHardProcessParticles, &_hard_process_selector);
+            _event_analyzer.addObservable(_q2_observable, &_invariant_mass);
+        };
+
+        /// analyses the event and writes it in the CSV file (the writer is shared by the analysis threads)
+        void analyseEvent(const GenEvent& hepmc_event, CSVWriter& csvfile, mutex& csv_mutex) {
+            if (!_event_analyzer.analyseEvent(hepmc_event)) return;
+            const vector<ConstGenParticlePtr>& initial_particles = _event_analyzer.getParticles(ParticleType::InitialParticles);
+            const vector<ConstGenParticlePtr>& hard_proc_particles = _event_analyzer.getParticles(ParticleType::OutgoingHardProcessParticles);
+            const vector<ConstGenParticlePtr>& final_from_hard_process = _signal_particle_searcher.selectParticles(hard_proc_particles);
+            const double q2 = _event_analyzer.evaluateObservable(_q2_observable, ParticleType::OutgoingHardProcessParticles);
+            const int initial_particle_pid = initial_particles.empty() ? 0 : initial_particles.at(0)->abs_pid();
+
+            lock_guard<mutex> lock (csv_mutex);
+            csvfile.writeEvent(q2, initial_particle_pid, final_from_hard_process);
+        };
+
+    private:
+        const FinalStateSelector _final_state_selector;
+        const ChargedParticlesSelector _charged_particle_selector;
+        const MultipleParticleSelectors _particle_selector;
+        const InitialStateSelector _initial_particle_selector;
+        const OutgoingParticlesFromHardProcess _hard_process_selector;
+        const InvariantMass _invariant_mass;
+        const string _q2_observable = "invariantMass";
+        EventAnalyzer _event_analyzer;
+        SignalParticlesSearcher _signal_particle_searcher;
+};
+
+int main (int argc, char* argv[]) {
+    string process, csv_filename;
+    double pthat_min = -1, pthat_max = -1;
+    long number_events = 500000;
+    // fixed default, so the sample does not depend on the machine where it is generated
+    int number_shards = 16;
+    int number_generators = 0;
+    int number_analysis_threads = 1;
+    int queue_size = 256;
+    uint64_t base_seed = 1;
+    GenerationFilterSettings filter_settings;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string option = argv[i], value = argv[i + 1];
+        if (option == "--process") process = value;
+        else if (option == "--pthat-min") pthat_min = stod(value);
+        else if (option == "--pthat-max") pthat_max = stod(value);
+        else if (option == "--output") csv_filename = value;
+        else if (option == "--events") number_events = stol(value);
+        else if (option == "--shards") number_shards = stoi(value);
+        else if (option == "--generators") number_generators = stoi(value);
+        else if (option == "--analysis-threads") number_analysis_threads = stoi(value);
+        else if (option == "--queue-size") queue_size = stoi(value);
+        else if (option == "--seed") base_seed = stoull(value);
+        else if (filter_settings.parseOption(option, value)) continue;
+        else {
+            cout << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    vector<string> settings;
+    if (!sampleSettings(process, pthat_min, pthat_max, settings)) {
+        cout << "Unknown process '" << process << "' (bbbar, ccbar, light or soft)" << endl;
+        return 1;
+    }
+    if (csv_filename.empty() || pthat_min < 0 || pthat_max <= pthat_min || number_events <= 0 || number_shards <= 0 || number_analysis_threads <= 0) {
+        cout << "usage: generate_select_particles --process <bbbar|ccbar|light|soft> --pthat-min <GeV> --pthat-max <GeV> --output <csv file>" << endl
+             << "                                 [--events N] [--shards N] [--generators N] [--analysis-threads N] [--queue-size N]" << endl
+             << "                                 [--seed S]" << endl
+             << "                                 [--min-charged N] [--charged-pt-min GeV] [--charged-eta-max eta]" << endl
+             << "                                 [--jet-pt-min GeV] [--jet-radius R] [--jet-eta-max eta]" << endl;
+        return 1;
+    }
+
+    if (number_generators <= 0)
+        number_generators = min<int>(number_shards, max(1u, thread::hardware_concurrency()));
+
+    // kept after the Pythia instance of each shard is deleted
+    vector<ShardStatistics> shard_statistics (number_shards);
+
+    // the GenEvents go around the two queues: empty ones to the generators, filled ones to the analysis threads
+    const int number_hepmc_events = queue_size + number_generators + number_analysis_threads;
+    vector<unique_ptr<GenEvent>> hepmc_events;
+    BoundedQueue<GenEvent*> empty_events (number_hepmc_events), filled_events (queue_size);
+    for (int i = 0; i < number_hepmc_events; i++) {
+        hepmc_events.push_back(make_unique<GenEvent>(Units::GEV, Units::MM));
+        empty_events.push(hepmc_events.back().get());
+    }
+
+    CSVWriter csvfile (csv_filename, 50);
+    mutex csv_mutex;
+    atomic<long> analysed_events (0);
+    atomic<int> running_generators (number_generators);
+    atomic<bool> generation_failed (false);
+
+    cout << "Generating and analysing " << number_events << " " << process << " events with pTHat in [" << pthat_min << ", " << pthat_max
+         << "] GeV in " << number_shards << " shards with " << number_generators << " generator and " << number_analysis_threads << " analysis threads" << endl;
+
+    // each generator thread takes the next shard not generated yet
+    atomic<int> next_shard (0);
+    vector<thread> generator_threads;
+    for (int generator = 0; generator < number_generators; generator++) {
+        generator_threads.emplace_back([&]() {
+            for (int shard = next_shard++; shard < number_shards; shard = next_shard++) {
+                // one Pythia instance per shard, with the seed of the corresponding shard of generate_events,
+                // alive only while the shard is generated
+                unique_ptr<PythiaEventSource> source = make_unique<PythiaEventSource>(settings, shardSeed(base_seed, shard), filter_settings);
+                const long events = shardEvents(number_events, shard, number_shards);
+                bool success = source->initialize();
+                for (long i = 0; success && i < events; i++) {
+                    GenEvent* hepmc_event;
+                    if (!empty_events.pop(hepmc_event)) break;
+                    success = source->nextEvent(*hepmc_event);
+                    // an event that could not be generated goes back to the empty ones
+                    if (!(success ? filled_events.push(hepmc_event) : empty_events.push(hepmc_event))) break;
+                }
+                if (!success) {
+                    cout << "Shard " << shard << " stopped after " << source->generatedEvents() << " events" << endl;
+                    generation_failed = true;
+                }
+                shard_statistics[shard] = {source->generatedEvents(), source->testedEvents(), source->sigmaGen()};
+            }
+            // the last generator to finish lets the analysis threads end once the queue is empty
+            if (--running_generators == 0)
+                filled_events.close();
+        });
+    }
+
+    vector<thread> analysis_threads;
+    for (int i = 0; i < number_analysis_threads; i++) {
+        analysis_threads.emplace_back([&]() {
+            AnalysisChain analysis_chain;
+            GenEvent* hepmc_event;
+            while (filled_events.pop(hepmc_event)) {
+                analysis_chain.analyseEvent(*hepmc_event, csvfile, csv_mutex);
+                empty_events.push(hepmc_event);
+                const long events = ++analysed_events;
+                if (events % 10000 == 0)
+                    cout << "Reached " << events << " events" << endl;
+            }
+        });
+    }
+
+    for (thread& worker: generator_threads)
+        worker.join();
+    for (thread& worker: analysis_threads)
+        worker.join();
+
+    if (!csvfile.close()) {
+        cout << "Failed to write " << csv_filename << endl;
+        return 1;
+    }
+
+    // cross section of the sample, combined from the shards as in the manifest of generate_events
+    long accepted_events = 0, tested_events = 0;
+    double sigma_sum = 0;
+    for (const ShardStatistics& statistics: shard_statistics) {
+        accepted_events += statistics.generated_events;
+        tested_events += statistics.tested_events;
+        sigma_sum += statistics.tested_events * statistics.sigma_mb;
+    }
+    const double sigma = tested_events > 0 ? sigma_sum / tested_events : 0.;
+    const double efficiency = tested_events > 0 ? double(accepted_events) / tested_events : 0.;
+    cout << "Analysed " << analysed_events << " events, sigma = " << sigma << " mb, filter efficiency = " << efficiency
+         << ", sigma of the accepted events = " << sigma * efficiency << " mb" << endl;
+    return generation_failed ? 1 : 0;
+}
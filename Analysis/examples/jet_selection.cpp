@@ -34,6 +34,8 @@ int main () {
     const InitialStateSelector initial_part_selector;
     // define the selector for the outgoing particles from the hard process
     const OutgoingParticlesFromHardProcess hard_process_selector;
+    // define the selector for the heavy-flavour hadrons that label the jets
+    const HeavyFlavourHadronSelector heavy_flavour_selector;
 
      // define the observable we want to compute
     const InvariantMass invariant_mass;
@@ -43,6 +45,7 @@ int main () {
     event_analyzer.addParticleSelector(ParticleType::FinalParticles, &final_part_selector);
     event_analyzer.addParticleSelector(ParticleType::InitialParticles, &initial_part_selector);
     event_analyzer.addParticleSelector(ParticleType::OutgoingHardProcessParticles, &hard_process_selector);
+    event_analyzer.addParticleSelector(ParticleType::HeavyFlavourHadrons, &heavy_flavour_selector);
 
     // adds the observables
     event_analyzer.addObservable("invariantMass", &invariant_mass);
@@ -52,6 +55,8 @@ int main () {
 
     // vector to store the final state particles and the jets
     vector<PseudoJet> jets;
+    // partons and heavy-flavour hadrons clustered as ghosts to label the jets
+    vector<ConstGenParticlePtr> truth_particles;
 
     // defining how to cluster the jets
     JetClustering jet_cluster(0.4, 20, fastjet::antikt_algorithm);
@@ -74,8 +79,11 @@ int main () {
         double q2 = event_analyzer.evaluateObservable("invariantMass", ParticleType::OutgoingHardProcessParticles);
         int initial_particle_pid =  event_analyzer.getParticles(ParticleType::InitialParticles).at(0)->abs_pid();
 
-        // reconstructing the jets
-        jets = jet_cluster.clusterJets(final_particles_signal);
+        // reconstructing and labelling the jets
+        const vector<ConstGenParticlePtr>& heavy_flavour_hadrons = event_analyzer.getParticles(ParticleType::HeavyFlavourHadrons);
+        truth_particles.assign(hard_proc_particles.begin(), hard_proc_particles.end());
+        truth_particles.insert(truth_particles.end(), heavy_flavour_hadrons.begin(), heavy_flavour_hadrons.end());
+        jets = jet_cluster.clusterJets(final_particles_signal, truth_particles);
 
         cout << "Event number " << evt_number << endl;
         cout << "Number of final state particles in the event: " << final_state_particles.size() << endl;
@@ -83,12 +91,15 @@ int main () {
         cout << "Number of jets in the event: " << jets.size() << endl;
         cout << "q^2 = " << q2 << endl;
         cout << "initial PID: " << initial_particle_pid << endl;
+        for (size_t i = 0; i < jets.size(); i++)
+            cout << "Jet pT = " << jets[i].pt() << " flavour: " << jet_cluster.jetFlavours()[i].flavour
+                 << (jet_cluster.jetFlavours()[i].ghost_matched ? " (ghost)" : " (deltaR)") << endl;
         // cout << "Jets properties:" << endl;
         for(auto jet: final_particles_signal) {
             cout << "Jet pT = " << jet->momentum().pt() << endl;
             // cout << "Jet constituents:" << endl;
             // for (auto constituent: jet.constituents())
-                // cout << "-- PID: " << constituent.user_info<HepMC3Info>().pid() << " pT: " << constituent.pt() << endl;
+                // cout << "-- PID: " << JetClustering::pid(constituent) << " pT: " << constituent.pt() << endl;
             // cout << "--------------------------------------" << endl;
         }
         cout << "+++++++++++++++++++++++++++++++++++++++++++" << endl;
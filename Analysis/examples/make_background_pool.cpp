@@ -0,0 +1,28 @@
+#include <iostream>
+#include <string>
+#include "Analysis/UnderlyingEventOverlay.h"
+
+using namespace std;
+
+
+/// reads the final state particles of the first events of a soft sample into a pool cache (see UnderlyingEventOverlay.h),
+/// which the overlay of run_pipeline then maps instead of reading the HepMC3 file again
+int main (int argc, char* argv[]) {
+    // usage: make_background_pool <soft hepmc file> <number of events> <pool file>
+    if (argc != 4) {
+        cout << "usage: make_background_pool <soft hepmc file> <number of events> <pool file>" << endl;
+        return 1;
+    }
+    const string pool_filename = argv[3];
+    if (!isPoolFilename(pool_filename)) {
+        cout << "The pool file must have the .pool extension" << endl;
+        return 1;
+    }
+    const long number_events = stol(argv[2]);
+    BackgroundPool pool;
+    if (number_events <= 0 || !pool.load(argv[1], number_events) || !pool.save(pool_filename))
+        return 1;
+    cout << argv[1] << " -> " << pool_filename << ": " << pool.numberEvents() << " events, "
+         << double(pool.numberParticles()) / pool.numberEvents() << " particles/event" << endl;
+    return 0;
+}
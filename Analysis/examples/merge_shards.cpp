@@ -0,0 +1,145 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "Analysis/EventSharding.h"
+
+using namespace std;
+
+
+/// copies number_rows lines from the input to the output
+/// @return - number of lines copied (smaller than number_rows if the input ended before)
+long copyRows (ifstream& input, ofstream& output, long number_rows) {
+    string line;
+    long copied = 0;
+    while (copied < number_rows && getline(input, line)) {
+        output << line << "\n";
+        copied++;
+    }
+    return copied;
+}
+
+/// checks that the shards come from the same file, that every shard is present once and that every event was read once
+/// @return - total number of events in the input file, or -1 if the shards are not consistent
+long checkShards (const vector<ShardProvenance>& shards) {
+    const ShardProvenance& reference = shards.front();
+    vector<int> shard_counter (reference.shard.count, 0);
+    for (const ShardProvenance& shard: shards) {
+        if (shard.input_file != reference.input_file || shard.shard.count != reference.shard.count || shard.block_size != reference.block_size) {
+            cout << "Shard " << shard.output_file << " does not come from the same sharding as " << reference.output_file << endl;
+            return -1;
+        }
+        if (shard.shard.index < 0 || shard.shard.index >= shard.shard.count) {
+            cout << "Shard " << shard.output_file << " has an invalid index " << shard.shard.index << endl;
+            return -1;
+        }
+        shard_counter[shard.shard.index]++;
+    }
+    for (int index = 0; index < reference.shard.count; index++) {
+        if (shard_counter[index] != 1) {
+            cout << "Shard " << index << "/" << reference.shard.count << (shard_counter[index] == 0 ? " is missing" : " is duplicated") << endl;
+            return -1;
+        }
+    }
+
+    /// the file ends inside the last block read by any shard
+    long total_events = 0;
+    for (const ShardProvenance& shard: shards) {
+        if (shard.events_per_block.empty())
+            continue;
+        const long last_block = shard.shard.index + (long(shard.events_per_block.size()) - 1) * shard.shard.count;
+        total_events = max(total_events, last_block * shard.block_size + shard.events_per_block.back());
+    }
+    /// every shard must have read all the events of its blocks
+    for (const ShardProvenance& shard: shards) {
+        long read_events = 0;
+        for (long events: shard.events_per_block)
+            read_events += events;
+        if (read_events != shard.expectedEvents(total_events)) {
+            cout << "Shard " << shard.output_file << " read " << read_events << " events instead of " << shard.expectedEvents(total_events) << endl;
+            return -1;
+        }
+    }
+    return total_events;
+}
+
+int main (int argc, char* argv[]) {
+    vector<string> arguments (argv + 1, argv + argc);
+    bool interleave = false;
+    if (!arguments.empty() && (arguments.front() == "--interleave" || arguments.front() == "--concatenate")) {
+        interleave = arguments.front() == "--interleave";
+        arguments.erase(arguments.begin());
+    }
+    if (arguments.size() < 2) {
+        cout << "usage: merge_shards [--concatenate | --interleave] output.csv shard_0.csv ... shard_N-1.csv" << endl;
+        cout << "  --concatenate (default) writes the shards one after the other" << endl;
+        cout << "  --interleave writes the events in the same order as the input file" << endl;
+        return 1;
+    }
+
+    // reading the provenance of each shard
+    vector<ShardProvenance> shards (arguments.size() - 1);
+    for (size_t i = 1; i < arguments.size(); i++) {
+        if (!ShardProvenance::read(ShardProvenance::provenanceFilename(arguments[i]), shards[i - 1])) {
+            cout << "Missing or incomplete provenance for " << arguments[i] << endl;
+            return 1;
+        }
+        shards[i - 1].output_file = arguments[i];
+    }
+    long total_events = checkShards(shards);
+    if (total_events < 0)
+        return 1;
+    sort(shards.begin(), shards.end(), [](const ShardProvenance& s1, const ShardProvenance& s2) {return s1.shard.index < s2.shard.index;});
+
+    // opening the shard outputs
+    vector<ifstream> inputs;
+    for (const ShardProvenance& shard: shards) {
+        inputs.emplace_back(shard.output_file);
+        if (!inputs.back().is_open()) {
+            cout << "Could not open " << shard.output_file << endl;
+            return 1;
+        }
+    }
+    ofstream output (arguments.front());
+
+    long total_rows = 0;
+    const long number_shards = shards.size();
+    if (interleave) {
+        /// block b of the input file is the block b / N of the shard b % N
+        long number_blocks = (total_events + shards.front().block_size - 1) / shards.front().block_size;
+        for (long block = 0; block < number_blocks; block++) {
+            const ShardProvenance& shard = shards[block % number_shards];
+            const long expected_rows = shard.rows_per_block[block / number_shards];
+            if (copyRows(inputs[block % number_shards], output, expected_rows) != expected_rows) {
+                cout << "Shard " << shard.output_file << " has fewer rows than in its provenance" << endl;
+                return 1;
+            }
+            total_rows += expected_rows;
+        }
+    }
+    else {
+        for (long index = 0; index < number_shards; index++) {
+            long expected_rows = 0;
+            for (long rows: shards[index].rows_per_block)
+                expected_rows += rows;
+            if (copyRows(inputs[index], output, expected_rows) != expected_rows) {
+                cout << "Shard " << shards[index].output_file << " has fewer rows than in its provenance" << endl;
+                return 1;
+            }
+            total_rows += expected_rows;
+        }
+    }
+    /// no shard can have rows left
+    string line;
+    for (long index = 0; index < number_shards; index++) {
+        if (getline(inputs[index], line)) {
+            cout << "Shard " << shards[index].output_file << " has more rows than in its provenance" << endl;
+            return 1;
+        }
+    }
+
+    cout << "Merged " << number_shards << " shards of " << shards.front().input_file << ": "
+         << total_events << " events, " << total_rows << " rows written to " << arguments.front() << endl;
+    return output.good() ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Analysis/Pipeline.h"
+#include "Analysis/EventSharding.h"
+
+using namespace std;
+
+
+int main (int argc, char* argv[]) {
+    // usage: run_pipeline config [--shard i/N] [--output-dir dir] [input files]
+    if (argc < 2) {
+        cout << "usage: run_pipeline config [--shard i/N] [--output-dir dir] [input files]" << endl;
+        return 1;
+    }
+    PipelineConfig config;
+    if (!PipelineConfig::read(argv[1], config))
+        return 1;
+
+    // the command line overrides the config
+    vector<string> inputs;
+    for (int i = 2; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--shard" && i + 1 < argc) {
+            if (!ShardSpec::parse(argv[++i], config.shard)) {
+                cout << "Invalid shard " << argv[i] << ", expected i/N with 0 <= i < N" << endl;
+                return 1;
+            }
+        }
+        else if (argument == "--output-dir" && i + 1 < argc)
+            config.output_dir = argv[++i];
+        else
+            inputs.push_back(argument);
+    }
+    if (!inputs.empty())
+        config.inputs = inputs;
+    if (config.inputs.empty()) {
+        cout << "No input files" << endl;
+        return 1;
+    }
+
+    // the analysis is built once and every input is read once
+    PipelineRunner runner (config);
+    if (!runner.configured())
+        return 1;
+    return runner.runAll() ? 0 : 1;
+}
@@ -1,11 +1,19 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <sstream>
+#include <cstdlib>
 #include "Analysis/ParticleSelector.h"
 #include "Analysis/Observable.h"
 #include "Analysis/EventAnalyzer.h"
+#include "Analysis/EventCut.h"
 #include "Analysis/CSVWriter.h"
 #include "Analysis/SignalParticlesSearcher.h"
+#include "Analysis/EventSharding.h"
+#include "Analysis/HepMCInput.h"
+#include "Analysis/Instrumentation.h"
+#include "Analysis/DetectorResponse.h"
 #include "HepMC3/Reader.h"
 #include "HepMC3/ReaderAscii.h"
 #include "HepMC3/GenEvent.h"
@@ -15,14 +23,40 @@ using namespace std;
 using namespace HepMC3;
 
 
-void runCSVWriter (string filename) {
-    cout << "analysing file " << filename << endl;
+/// @brief - reads a comma-separated list of pids, e.g. "21,1,2" (the sign is ignored, as in the initial-parton cut)
+/// @return - false if the list is empty or an entry is not a number
+bool parsePids (const string& list, vector<int>& pids) {
+    pids.clear();
+    stringstream entries (list);
+    string entry;
+    while (getline(entries, entry, ',')) {
+        char* end;
+        const long pid = strtol(entry.c_str(), &end, 10);
+        if (entry.empty() || *end != '\0' || pid == 0)
+            return false;
+        pids.push_back(abs(int(pid)));
+    }
+    return !pids.empty();
+}
 
-    // reading the HepMC3 file
-    string hepmc3_filename = "/sampa/archive/caducka/jetsml/" + filename + ".hepmc";
+void runCSVWriter (string filename, const ShardSpec& shard, long block_size, bool async_output, DetectorResponse* detector_response,
+                   const EventSampling& sampling, const vector<EventCutEntry>& event_cuts) {
+    cout << "analysing file " << filename;
+    if (shard.isSharded())
+        cout << " (shard " << shard.index << "/" << shard.count << ")";
+    if (sampling.isSampling())
+        cout << " (" << sampling.description() << ")";
+    cout << endl;
+
+    // reading the HepMC3 file (or its .gz / .zst compressed copy)
+    string hepmc3_filename = resolveInputFilename("/sampa/archive/caducka/jetsml/" + filename + ".hepmc");
     // my test
     // string hepmc3_filename = "/Users/martines/Desktop/Physics/pythia8312/examples/ccbar_production_pt_10_35_GeV.hepmc";
-    ReaderAscii hepmc_file (hepmc3_filename);
+    // the file is read and decompressed on a read-ahead thread, the events out of the sample never reach ReaderAscii
+    shared_ptr<HepMCInputStream> hepmc_input = openHepMCInput(hepmc3_filename, sampling);
+    ReaderAscii hepmc_file (hepmc_input);
+    // reads only the events of the shard
+    ShardedReader sharded_reader (hepmc_file, shard, block_size);
     // stores the current event 
     GenEvent hepmc_event(HepMC3::Units::GEV, HepMC3::Units::MM);
 
@@ -51,51 +85,177 @@ void runCSVWriter (string filename) {
     event_analyzer.addParticleSelector(ParticleType::OutgoingHardProcessParticles, &final_hard_process_particles);
 
     // adding the observables
-    event_analyzer.addObservable("invariantMass", &invariant_mass);
+    const string q2_observable = "invariantMass";
+    event_analyzer.addObservable(q2_observable, &invariant_mass);
+
+    // event-level cuts applied before the particle classification (none by default - all events are written)
+    for (const EventCutEntry& cut_entry: event_cuts)
+        event_analyzer.addEventCut(cut_entry.name, cut_entry.cut);
 
     // creating the final particles searcher
     SignalParticlesSearcher signal_particle_searcher (&hepmc_particle_selector);
 
-    // creating the CSV file
-    CSVWriter csvfile ("/sampa/archive/caducka/jetsml/" + filename + "_from_hard_process.csv", 50);
+    // creating the CSV file - each shard writes its own file
+    string csv_filename = "/sampa/archive/caducka/jetsml/" + filename + "_from_hard_process";
+    // the tracks of the detector response go to their own file
+    if (detector_response)
+        csv_filename += "_detector";
+    // and the samples to theirs
+    if (sampling.isSampling())
+        csv_filename += "_sampled";
+    // and the events that pass the cuts to theirs
+    if (!event_cuts.empty())
+        csv_filename += "_cut";
+    if (shard.isSharded())
+        csv_filename += "_shard_" + to_string(shard.index) + "_of_" + to_string(shard.count);
+    csv_filename += ".csv";
+    CSVWriter csvfile (csv_filename, 50, async_output);
+    // reconstructed tracks of the event (the memory is reused in every event)
+    DetectorTracks tracks;
     // CSVWriter csvfile ("/Users/martines/Desktop/Physics/pythia8312/examples/ccbar_production_pt_10_35_GeV.csv", 50);
 
+    // timers of the stages, progress line and summary of the file (see Instrumentation.h)
+    EventLoopMonitor monitor (filename, hepmc_input->fileSize());
+
     // looping over all the events in the file
     int evt_number = 0; // simple counter to keep track on the number of evts
-    while (!hepmc_file.failed()) {
-        // current event
-        hepmc_file.read_event(hepmc_event);
-        
+    while (true) {
         // If reading failed - exit loop
-        if(hepmc_file.failed()) break;
+        StageTimer read_timer (monitor, ReadStage);
+        if (!sharded_reader.readEvent(hepmc_event)) break;
+        read_timer.stop();
+
+        // without the instrumentation only the number of events is printed
+        if (!EventLoopMonitor::enabled && evt_number % 10000 == 0)
+            cout << "Reached " << evt_number << " events" << endl;
+        evt_number++;
+        monitor.countEvent(hepmc_event.particles().size());
+        if (monitor.progressDue()) {
+            monitor.setBytesRead(hepmc_input->fileOffset());
+            monitor.printProgress();
+        }
 
-        // selecting the particles
-        event_analyzer.analyseEvent(hepmc_event);
+        // selecting the particles - skips the event if it fails the event-level cuts
+        StageTimer select_timer (monitor, SelectStage);
+        if (!event_analyzer.analyseEvent(hepmc_event)) continue;
+        select_timer.stop();
 
-        // final state particles 
-        const vector<ConstGenParticlePtr>& final_state_particles = event_analyzer.getParticles(ParticleType::FinalParticles);
         // initial state particles
         const vector<ConstGenParticlePtr>& initial_particles = event_analyzer.getParticles(ParticleType::InitialParticles);
         // particles from the hard process
         const vector<ConstGenParticlePtr>& hard_proc_particles = event_analyzer.getParticles(ParticleType::OutgoingHardProcessParticles);
         // final particles stable particles from the hard process
+        StageTimer search_timer (monitor, SearchStage);
         const vector<ConstGenParticlePtr>& final_from_hard_process = signal_particle_searcher.selectParticles(hard_proc_particles);
+        search_timer.stop();
 
         // get the energy and initial particle pid
-        double q2 = event_analyzer.evaluateObservable("invariantMass", ParticleType::OutgoingHardProcessParticles);
+        StageTimer observables_timer (monitor, ObservablesStage);
+        double q2 = event_analyzer.evaluateObservable(q2_observable, ParticleType::OutgoingHardProcessParticles);
         int initial_particle_pid = initial_particles.at(0)->abs_pid();
-
-        if (evt_number % 10000 == 0)
-            cout << "Reached " << evt_number << " events" << endl;
+        observables_timer.stop();
         
+        // efficiency and smearing of the particles
+        if (detector_response) {
+            StageTimer detector_timer (monitor, DetectorStage);
+            detector_response->apply(final_from_hard_process, hepmc_input->fileEventIndex(sharded_reader.eventIndex()), tracks);
+        }
+
         // writing event in the file
-        csvfile.writeEvent(q2, initial_particle_pid, final_from_hard_process);
+        StageTimer write_timer (monitor, WriteStage);
+        if (detector_response)
+            csvfile.writeEvent(q2, initial_particle_pid, tracks);
+        else
+            csvfile.writeEvent(q2, initial_particle_pid, final_from_hard_process);
+        sharded_reader.addOutputRow();
+        write_timer.stop();
+        monitor.countWrittenEvent(detector_response ? tracks.size() : final_from_hard_process.size());
+    }
+
+    event_analyzer.printCutFlow();
+
+    // waits for the output to be written
+    {
+        StageTimer write_timer (monitor, WriteStage);
+        if (!csvfile.close())
+            cout << "Failed to write " << csv_filename << endl;
+    }
 
-        evt_number++;   
+    // summary of the stages, next to the CSV file
+    monitor.setBytesRead(hepmc_input->fileOffset());
+    monitor.setBytesWritten(csvfile.bytesWritten());
+    monitor.writeSummary(cout);
+    if (!monitor.writeSummary(csv_filename + ".stats.json"))
+        cout << "Could not write the summary of " << csv_filename << endl;
+
+    // provenance of the shard, needed by merge_shards
+    if (shard.isSharded()) {
+        ShardProvenance& provenance = sharded_reader.provenance();
+        provenance.input_file = hepmc3_filename;
+        provenance.output_file = csv_filename;
+        if (!provenance.write(ShardProvenance::provenanceFilename(csv_filename)))
+            cout << "Could not write the provenance of " << csv_filename << endl;
     }
 }
 
-int main () {
+int main (int argc, char* argv[]) {
+    // usage: select_hepmc_particles [--shard i/N] [--block-size B] [--async-output] [--detector response file] [--detector-seed S]
+    //                               [--prescale N] [--first N] [--fraction f] [--sample-seed S]
+    //                               [--q2-window min max] [--initial-pid 21,1,2,...] [--min-leading-pt GeV] [--min-multiplicity N]
+    //                               [sample names]
+    ShardSpec shard;
+    long block_size = 1000;
+    bool async_output = false;
+    string detector_filename;
+    uint64_t detector_seed = 1;
+    // events read from each file: every Nth event, the first N events and a random fraction (all by default)
+    EventSampling sampling;
+    // event-level cuts (see EventCut.h), negative values for the cuts that are not applied
+    double q2_min = -1, q2_max = -1, min_leading_pt = -1;
+    int min_multiplicity = -1;
+    vector<int> initial_pids;
+    vector<string> samples;
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "--shard" && i + 1 < argc) {
+            if (!ShardSpec::parse(argv[++i], shard)) {
+                cout << "Invalid shard " << argv[i] << ", expected i/N with 0 <= i < N" << endl;
+                return 1;
+            }
+        }
+        else if (argument == "--block-size" && i + 1 < argc)
+            block_size = stol(argv[++i]);
+        else if (argument == "--async-output")
+            async_output = true;
+        else if (argument == "--detector" && i + 1 < argc)
+            detector_filename = argv[++i];
+        else if (argument == "--detector-seed" && i + 1 < argc)
+            detector_seed = stoull(argv[++i]);
+        else if (argument == "--prescale" && i + 1 < argc)
+            sampling.prescale = stol(argv[++i]);
+        else if (argument == "--first" && i + 1 < argc)
+            sampling.max_events = stol(argv[++i]);
+        else if (argument == "--fraction" && i + 1 < argc)
+            sampling.fraction = stod(argv[++i]);
+        else if (argument == "--sample-seed" && i + 1 < argc)
+            sampling.seed = stoull(argv[++i]);
+        else if (argument == "--q2-window" && i + 2 < argc) {
+            q2_min = stod(argv[++i]);
+            q2_max = stod(argv[++i]);
+        }
+        else if (argument == "--initial-pid" && i + 1 < argc) {
+            if (!parsePids(argv[++i], initial_pids)) {
+                cout << "Invalid initial pids " << argv[i] << ", expected --initial-pid pid1,pid2,..." << endl;
+                return 1;
+            }
+        }
+        else if (argument == "--min-leading-pt" && i + 1 < argc)
+            min_leading_pt = stod(argv[++i]);
+        else if (argument == "--min-multiplicity" && i + 1 < argc)
+            min_multiplicity = stoi(argv[++i]);
+        else
+            samples.push_back(argument);
+    }
 
     vector<string> filenames = {
         "bbbar_prod_40_60", "bbbar_prod_90_110", 
@@ -104,8 +264,52 @@ int main () {
         "soft_prod_20_30", "soft_prod_40_60", "soft_prod_90_110"   
     };
 
+    // the samples given in the command line replace the default list
+    if (!samples.empty())
+        filenames = samples;
+
+    if (block_size <= 0) {
+        cout << "Invalid block size " << block_size << ", expected --block-size N >= 1" << endl;
+        return 1;
+    }
+
+    if (sampling.prescale < 1 || sampling.max_events < -1 || !(sampling.fraction > 0 && sampling.fraction <= 1)) {
+        cout << "Invalid sampling, expected --prescale N >= 1, --first N >= 0 and --fraction f in (0, 1]" << endl;
+        return 1;
+    }
+
+    if ((q2_min != -1 || q2_max != -1) && !(q2_min >= 0 && q2_max > q2_min)) {
+        cout << "Invalid q2 window [" << q2_min << ", " << q2_max << "), expected --q2-window min max with 0 <= min < max" << endl;
+        return 1;
+    }
+
+    // the cuts are applied in this order, the cut flow of each file is printed at its end
+    vector<unique_ptr<EventCut>> cuts;
+    vector<EventCutEntry> event_cuts;
+    if (q2_max > 0) {
+        cuts.emplace_back(new Q2WindowCut(q2_min, q2_max));
+        event_cuts.push_back({"q2 window", cuts.back().get(), 0});
+    }
+    if (!initial_pids.empty()) {
+        cuts.emplace_back(new InitialPartonCut(initial_pids));
+        event_cuts.push_back({"initial parton", cuts.back().get(), 0});
+    }
+    if (min_leading_pt >= 0) {
+        cuts.emplace_back(new LeadingChargedPtCut(min_leading_pt));
+        event_cuts.push_back({"leading charged pT", cuts.back().get(), 0});
+    }
+    if (min_multiplicity >= 0) {
+        cuts.emplace_back(new ChargedMultiplicityCut(min_multiplicity));
+        event_cuts.push_back({"charged multiplicity", cuts.back().get(), 0});
+    }
+
+    // parametric detector response applied to the particles before the output (see DetectorResponse.h)
+    DetectorResponse detector_response (detector_seed);
+    if (!detector_filename.empty() && !detector_response.read(detector_filename))
+        return 1;
+
     for (string filename: filenames)
-        runCSVWriter(filename);        
+        runCSVWriter(filename, shard, block_size, async_output, detector_filename.empty() ? nullptr : &detector_response, sampling, event_cuts);
     
     return 0;
 }
\ No newline at end of file
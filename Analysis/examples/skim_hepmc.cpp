@@ -0,0 +1,64 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Analysis/HepMCInput.h"
+#include "Analysis/SkimFormat.h"
+#include "HepMC3/ReaderAscii.h"
+#include "HepMC3/GenEvent.h"
+
+using namespace std;
+using namespace HepMC3;
+
+
+/// converts a HepMC3 file (possibly compressed) to a skim with the status 21, 23 and 1 particles (see SkimFormat.h)
+/// @return - false if the input could not be read or the skim could not be written
+bool skimFile (const string& input_filename, const string& skim_filename) {
+    const string hepmc3_filename = resolveInputFilename(input_filename);
+    shared_ptr<HepMCInputStream> hepmc_input = openHepMCInput(hepmc3_filename);
+    if (!hepmc_input->is_open()) {
+        cout << "Could not open " << input_filename << endl;
+        return false;
+    }
+    ReaderAscii hepmc_file (hepmc_input);
+    SkimWriter skim_file (skim_filename);
+    GenEvent hepmc_event (Units::GEV, Units::MM);
+
+    long number_events = 0;
+    while (true) {
+        hepmc_file.read_event(hepmc_event);
+        if (hepmc_file.failed()) break;
+        skim_file.write_event(hepmc_event);
+        if (++number_events % 10000 == 0)
+            cout << "Reached " << number_events << " events" << endl;
+    }
+    skim_file.close();
+
+    if (hepmc_input->readFailed() || skim_file.failed()) {
+        cout << "Failed to skim " << hepmc3_filename << endl;
+        return false;
+    }
+    // the size on disk of the input, compressed or not
+    cout << hepmc3_filename << " -> " << skim_filename << ": " << number_events << " events, " << hepmc_input->fileSize()
+         << " -> " << skim_file.bytesWritten() << " bytes (" << double(hepmc_input->fileSize()) / skim_file.bytesWritten() << "x smaller)" << endl;
+    return true;
+}
+
+int main (int argc, char* argv[]) {
+    // usage: skim_hepmc <hepmc file> [skim file] - the skim is the input without its extensions + .skim by default
+    if (argc < 2) {
+        cout << "usage: skim_hepmc <hepmc file> [skim file]" << endl;
+        return 1;
+    }
+    string input_filename = argv[1];
+    string skim_filename;
+    if (argc > 2)
+        skim_filename = argv[2];
+    else {
+        skim_filename = input_filename;
+        for (const string extension: {".gz", ".zst", ".hepmc3", ".hepmc"})
+            if (skim_filename.size() > extension.size() && skim_filename.compare(skim_filename.size() - extension.size(), extension.size(), extension) == 0)
+                skim_filename.erase(skim_filename.size() - extension.size());
+        skim_filename += ".skim";
+    }
+    return skimFile(input_filename, skim_filename) ? 0 : 1;
+}
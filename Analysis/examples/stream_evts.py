@@ -0,0 +1,25 @@
+"""
+Streams the events of a HepMC3 file through the C++ analysis chain (python bindings built with `make python`).
+Each batch is a dict of NumPy arrays backed by the C++ buffers:
+    q2 [n], initial_pid [n], number_particles [n], kinematics [n, max_particles, 3] (pt, eta, phi), pid [n, max_particles]
+"""
+
+import sys
+import numpy as np
+import jetml_analysis
+
+
+if __name__ == "__main__":
+    # path to the file
+    filename = sys.argv[1] if len(sys.argv) > 1 else "/sampa/archive/caducka/jetsml/ccbar_prod_20_30.hepmc"
+
+    total_events, total_particles = 0, 0
+    for batch in jetml_analysis.EventStream(filename, max_particles=50, batch_size=4096):
+        total_events += len(batch["q2"])
+        total_particles += np.sum(batch["number_particles"])
+        # same layout as the CSV files: q2, pid, 50 x (pt, eta, phi, pid)
+        # csv_like = np.concatenate([batch["q2"][:, None], batch["initial_pid"][:, None],
+        #                            np.concatenate([batch["kinematics"], batch["pid"][..., None]], axis=2).reshape(len(batch["q2"]), -1)], axis=1)
+
+    print(f"Number of events: {total_events}")
+    print(f"Average number of final state particles from hard process: {total_particles / max(total_events, 1):.2f}")
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "Analysis/ParticleProperties.h"
+
+using namespace std;
+
+/// writes the PID property table as a python module, so Preprocessing uses exactly the same values
+int main (int argc, char* argv[]) {
+    string filename = argc > 1 ? argv[1] : "../Preprocessing/pid_table.py";
+    ofstream output_file (filename);
+    if (!output_file.is_open()) {
+        cout << "Could not open " << filename << endl;
+        return 1;
+    }
+
+    output_file << "\"\"\"\n"
+                << "PID property table generated by Analysis/examples/write_pid_table.cpp\n"
+                << "from Analysis/include/Analysis/ParticleProperties.h - do not edit by hand.\n"
+                << "Regenerate it with `make pid_table` in the Analysis folder.\n"
+                << "\"\"\"\n\n";
+
+    output_file << "TABLE_SIZE = " << ParticleProperties::table_size << "\n\n";
+
+    // the enums
+    output_file << "# species identified by ALICE\n"
+                << "OTHER_SPECIES, ELECTRON, MUON, PION, KAON, PROTON = "
+                << int(ParticleProperties::OtherSpecies) << ", " << int(ParticleProperties::Electron) << ", "
+                << int(ParticleProperties::Muon) << ", " << int(ParticleProperties::Pion) << ", "
+                << int(ParticleProperties::Kaon) << ", " << int(ParticleProperties::Proton) << "\n\n";
+    output_file << "# flags with the type and quark content of the particle\n"
+                << "KNOWN = " << ParticleProperties::Known << "\n"
+                << "QUARK = " << ParticleProperties::Quark << "\n"
+                << "LEPTON = " << ParticleProperties::Lepton << "\n"
+                << "GAUGE_BOSON = " << ParticleProperties::GaugeBoson << "\n"
+                << "MESON = " << ParticleProperties::Meson << "\n"
+                << "BARYON = " << ParticleProperties::Baryon << "\n"
+                << "DIQUARK = " << ParticleProperties::Diquark << "\n"
+                << "CHARM = " << ParticleProperties::Charm << "\n"
+                << "BOTTOM = " << ParticleProperties::Bottom << "\n\n";
+
+    // only the known entries are written, all the others are zero
+    output_file << "# (table index, three times the charge, flags, species) for every known entry\n"
+                << "ENTRIES = [\n";
+    for (int code = 0; code < ParticleProperties::table_size; code++) {
+        const ParticleProperties::PIDInfo& entry = ParticleProperties::pid_table[code];
+        if (!(entry.flags & ParticleProperties::Known))
+            continue;
+        output_file << "    (" << code << ", " << int(entry.charge3) << ", " << entry.flags << ", " << int(entry.species) << "),\n";
+    }
+    output_file << "]\n";
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+/**
+ * @headerfile - counts the heap allocations made by each thread.
+ *               The counting replaces the global operator new and delete, so it is only active in the programs
+ *               linked with AllocationCounter.o (the allocation check in benchmarks/, and select_hepmc_particles
+ *               built with make COUNT_ALLOCATIONS=1, where the instrumentation reports them per stage).
+ *               The counters are thread local: the allocations of the read-ahead and the output threads are not
+ *               attributed to the stages of the event loop.
+ **/
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+/// @brief - number of allocations and of bytes requested
+struct AllocationCount {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+
+    AllocationCount operator+(const AllocationCount& other) const {return {allocations + other.allocations, bytes + other.bytes};};
+    AllocationCount operator-(const AllocationCount& other) const {return {allocations - other.allocations, bytes - other.bytes};};
+};
+
+/// @brief - allocations made by the calling thread since it started
+AllocationCount threadAllocations();
+
+#endif
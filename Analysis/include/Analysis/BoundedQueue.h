@@ -0,0 +1,67 @@
+/**
+ * @headerfile - queue with a maximum size shared by producer and consumer threads.
+ *               push waits while the queue is full, so a fast producer cannot run ahead of the consumers
+ *               by more than the capacity, and pop waits while it is empty.
+ *               Once the producers are done the queue is closed: the items left are still popped, then pop returns false.
+ **/
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+template <typename T>
+class BoundedQueue {
+    public:
+        explicit BoundedQueue(std::size_t capacity): _capacity(capacity > 0 ? capacity : 1) {};
+
+        /// @brief - adds the item, waiting while the queue is full
+        /// @return - false if the queue was closed (the item is not added)
+        bool push(T item) {
+            std::unique_lock<std::mutex> lock (_mutex);
+            _not_full.wait(lock, [this] {return _items.size() < _capacity || _closed;});
+            if (_closed)
+                return false;
+            _items.push_back(std::move(item));
+            lock.unlock();
+            _not_empty.notify_one();
+            return true;
+        };
+
+        /// @brief - takes the oldest item, waiting while the queue is empty
+        /// @return - false if the queue is closed and empty
+        bool pop(T& item) {
+            std::unique_lock<std::mutex> lock (_mutex);
+            _not_empty.wait(lock, [this] {return !_items.empty() || _closed;});
+            if (_items.empty())
+                return false;
+            item = std::move(_items.front());
+            _items.pop_front();
+            lock.unlock();
+            _not_full.notify_one();
+            return true;
+        };
+
+        /// @brief - no more items can be pushed, the waiting threads are woken up
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock (_mutex);
+                _closed = true;
+            }
+            _not_full.notify_all();
+            _not_empty.notify_all();
+        };
+
+        std::size_t capacity() const {return _capacity;};
+
+    private:
+        const std::size_t _capacity;
+        std::deque<T> _items;
+        bool _closed = false;
+        std::mutex _mutex;
+        std::condition_variable _not_full, _not_empty;
+};
+
+#endif
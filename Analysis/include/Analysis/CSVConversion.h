@@ -0,0 +1,44 @@
+/**
+ * @headerfile - converts the CSV files of CSVWriter (q2, initial pid, then (pt, eta, phi, pid) of each particle, zero padded)
+ *               into NumPy .npy files of float32, one row per event, that Python maps without parsing:
+ *                   data = np.load("bbbar_prod_40_60_from_hard_process.npy", mmap_mode="r")    # shape (events, columns)
+ *               The CSV file is mapped with mmap and split into one chunk per thread at line boundaries. A first
+ *               parallel pass counts the rows of each chunk, which gives the row where each chunk starts, and a second
+ *               parallel pass parses the values with std::from_chars straight into the mapped output file, so the
+ *               parsing scales with the threads and nothing is copied. The number of columns is the one of the first row;
+ *               shorter rows are zero padded (like the particles of CSVWriter) and longer rows are an error.
+ *               The validation reads both files again and compares every value of the .npy file with the value parsed
+ *               from the CSV file by strtof, an independent parser.
+ **/
+
+#ifndef CSV_CONVERSION_H
+#define CSV_CONVERSION_H
+
+#include <iostream>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class - result of a conversion or of a validation
+ **/
+struct CSVConversionSummary {
+    long rows = 0;
+    long columns = 0;
+    /// @brief - rows with fewer columns than the first one (zero padded)
+    long short_rows = 0;
+    /// @brief - values of the .npy file that differ from the CSV file (validation only)
+    long mismatches = 0;
+    std::uint64_t input_bytes = 0;
+    double seconds = 0;
+};
+
+/// @brief - writes the .npy file with the values of the CSV file
+/// @param number_threads - threads that parse the chunks (0 for the number of cores)
+/// @return - false if a file could not be read or written or a value could not be parsed (the problem is printed)
+bool convertCSVToNpy(const std::string& csv_filename, const std::string& npy_filename, int number_threads, CSVConversionSummary& summary);
+
+/// @brief - compares the values of the .npy file with the ones of the CSV file (prints the first mismatches)
+/// @return - false if the files could not be read, their shapes differ or a value differs
+bool validateNpy(const std::string& csv_filename, const std::string& npy_filename, int number_threads, CSVConversionSummary& summary);
+
+#endif
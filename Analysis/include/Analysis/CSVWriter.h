@@ -8,21 +8,42 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <fstream>
+#include <cstdio>
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/FourVector.h"
+#include "Analysis/FileWriter.h"
+#include "Analysis/DetectorResponse.h"
 
 class CSVWriter {
 
     public:
-        CSVWriter(std::string filename, int number_particles): filename_(filename), max_number_particles(number_particles), output_file(filename){};
+        /// @param filename - name of the CSV file
+        /// @param number_particles - number of particles stored for each event (zero padded)
+        /// @param async_output - true to write the file on a dedicated I/O thread (see FileWriter)
+        /// @param buffer_size - size of each of the two output buffers in the asynchronous mode
+        CSVWriter(std::string filename, int number_particles, bool async_output = false, std::size_t buffer_size = FileWriter::default_buffer_size):
+            filename_(filename), max_number_particles(number_particles), output_file(filename, async_output, buffer_size){};
         ~CSVWriter() {output_file.close();};
 
         /// @brief - writes the event into the CSV file
         /// @param event_q2 - invariant mass of the event
         /// @param initial_part_pid - pid of the initial particle
         /// @param final_particles -  vector with the final particles in the event (assumed that it's already ordered by pT)
-        void writeEvent(double event_q2, int initial_part_pid, std::vector<HepMC3::ConstGenParticlePtr> final_particles);
+        void writeEvent(double event_q2, int initial_part_pid, const std::vector<HepMC3::ConstGenParticlePtr>& final_particles);
+
+        /// @brief - writes the event with the reconstructed tracks instead of the particles (same columns, see DetectorResponse.h)
+        /// @param tracks - the tracks of the detector response, ordered by pT
+        void writeEvent(double event_q2, int initial_part_pid, const DetectorTracks& tracks);
+
+        /// @brief - writes everything left and closes the file
+        /// @return - false if any write failed
+        bool close() {return output_file.close();};
+
+        /// @brief - true if a write failed
+        bool failed() const {return output_file.failed();};
+
+        /// @brief - number of bytes written to the file
+        std::uint64_t bytesWritten() const {return output_file.bytesWritten();};
 
     private:
         /// @brief - name to give to the file
@@ -30,7 +51,22 @@ class CSVWriter {
         /// @brief - maximum number of particles to store in each event
         int max_number_particles;
         /// @brief - file to store the particles
-        std::ofstream output_file;
+        FileWriter output_file;
+        /// @brief - the event line is formatted here before being written (the memory is reused in every event)
+        std::string line_;
+
+        /// @brief - adds a value to the line with the same format as std::ostream (6 significant digits)
+        void addValue(double value);
+        void addValue(int value);
+
+        /// @brief - starts the line with the event information
+        void addEventValues(double event_q2, int initial_part_pid);
+
+        /// @brief - adds the pt, eta, phi and pid of a particle
+        void addParticle(double pt, double eta, double phi, int pid);
+
+        /// @brief - pads the line to the maximum number of particles and writes it
+        void finishLine(int number_particles);
 
         /// @brief - adds zero padded particles to the file
         /// @param numberZeroPaddedPart - number of zero padded particles to add
@@ -38,4 +74,4 @@ class CSVWriter {
 };
 
 
-#endif 
\ No newline at end of file
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @headerfile - fast parametric detector response for the charged particles: pT and eta dependent tracking efficiency
+ *               and resolution smearing, applied to the selected particles between the selection and the output.
+ *               The tables are read from a file with one "keyword values ..." entry per line ('#' starts a comment):
+ *                   pt_bins <edges>            (GeV, increasing)
+ *                   eta_bins <edges>           (increasing)
+ *                   efficiency <values>        probability to reconstruct the particle
+ *                   pt_resolution <values>     relative resolution sigma(pT) / pT        (0 if not given)
+ *                   eta_resolution <values>    absolute resolution of eta               (0 if not given)
+ *                   phi_resolution <values>    absolute resolution of phi               (0 if not given)
+ *               Each table has (number of pT bins) x (number of eta bins) values, all the eta bins of the first pT bin first.
+ *               The values of a keyword repeated on several lines are appended, so a table can have one line per pT bin.
+ *               The particles below the first pT edge or outside the eta bins are not reconstructed, and the ones above
+ *               the last pT edge use the last pT bin.
+ *
+ *               The random numbers come from Philox4x32-10, a counter-based generator: the numbers of a particle only depend
+ *               on the seed, the position of the event in the file and the id of the particle in the event, so the response
+ *               of an event is the same whatever the thread, the shard or the order in which the events are processed.
+ *               The event goes through the stages (gather, bins, random numbers, efficiency and smearing, compaction)
+ *               as loops over flat arrays: only the gather touches the HepMC3 particles, and the other loops have no
+ *               dependency between particles, so the compiler can vectorise them.
+ **/
+
+#ifndef DETECTOR_RESPONSE_H
+#define DETECTOR_RESPONSE_H
+
+#include <iostream>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/FourVector.h"
+
+/**
+ * @brief - the reconstructed tracks of an event, ordered by pT
+ **/
+struct DetectorTracks {
+    std::vector<double> pt;
+    std::vector<double> eta;
+    std::vector<double> phi;
+    std::vector<int> pid;
+    /// @brief - position of the generated particle in the vector given to the response
+    std::vector<int> particle;
+
+    std::size_t size() const {return pt.size();};
+};
+
+/**
+ * @class - applies the efficiency and the smearing to the particles of the events. The buffers of the stages are
+ *          members reused in every event, so each thread needs its own instance (they give the same tracks).
+ **/
+class DetectorResponse {
+
+    public:
+        /// @param seed - key of the random numbers
+        DetectorResponse(std::uint64_t seed = 1): _seed(seed) {};
+
+        /// @brief - reads the tables of the response
+        /// @return - false if the file could not be read or the tables are not valid (the problem is printed)
+        bool read(const std::string& filename);
+
+        /// @brief - reconstructs the particles of the event
+        /// @param event_index - position of the event in the file, which fixes the random numbers with the particle ids
+        /// @param tracks - cleared and filled with the reconstructed particles, ordered by the smeared pT
+        void apply(const std::vector<HepMC3::ConstGenParticlePtr>& particles, long event_index, DetectorTracks& tracks);
+
+        int numberPtBins() const {return int(_pt_edges.size()) - 1;};
+        int numberEtaBins() const {return int(_eta_edges.size()) - 1;};
+        std::uint64_t seed() const {return _seed;};
+
+    private:
+        std::uint64_t _seed;
+        std::vector<double> _pt_edges;
+        std::vector<double> _eta_edges;
+        /// @brief - the tables, index pt bin * number of eta bins + eta bin
+        std::vector<double> _efficiency;
+        std::vector<double> _pt_resolution;
+        std::vector<double> _eta_resolution;
+        std::vector<double> _phi_resolution;
+
+        /// @brief - buffers of the current event, one entry per particle
+        std::vector<double> _pt, _eta, _phi;
+        std::vector<int> _pid;
+        std::vector<std::uint32_t> _id;
+        /// @brief - bin of the tables (-1 outside the acceptance)
+        std::vector<int> _bin;
+        /// @brief - the 8 random numbers of each particle, uniform in (0, 1)
+        std::vector<double> _uniform;
+        /// @brief - 1 if the particle is reconstructed, and the positions of the reconstructed particles
+        std::vector<unsigned char> _reconstructed;
+        std::vector<int> _kept;
+};
+
+#endif
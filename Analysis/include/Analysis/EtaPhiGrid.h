@@ -0,0 +1,86 @@
+/**
+ * @headerfile - uniform eta-phi tiling of the particles of one event, for the neighbourhood queries of the observables.
+ *               The particles are sorted into the cells with a counting sort (O(N), no allocation once the buffers
+ *               fit the largest event), and the positions are stored cell by cell, so a query only reads the cells
+ *               that overlap the cone instead of all the particles of the event:
+ *                   - all the particles within deltaR < r of a point
+ *                   - the nearest particle to a point
+ *               The phi cells wrap around at 2pi. The particles beyond |eta| = max_eta go to the first and last
+ *               rows, so they are still found by the queries (only more slowly).
+ *               deltaR is measured in (eta, phi), as the acceptance of the analysis.
+ **/
+
+#ifndef ETA_PHI_GRID_H
+#define ETA_PHI_GRID_H
+
+#include <vector>
+#include "HepMC3/GenParticle.h"
+#include "Analysis/SimdKernels.h"
+
+
+class EtaPhiGrid {
+
+    public:
+        /// @param max_eta - the rows of the grid cover -max_eta < eta < max_eta
+        /// @param cell_size - requested size of the cells in eta and phi (rounded so that the cells fill the ranges)
+        EtaPhiGrid(double max_eta = 0.9, double cell_size = 0.2);
+
+        /// @brief - fills the grid with the particles of the event, replacing the previous ones
+        void build(const std::vector<HepMC3::ConstGenParticlePtr>& particles);
+
+        /// @brief - indices (in the vector given to build) of the particles with deltaR < r from (eta, phi), in no particular order
+        /// @param indices - cleared and filled with the particles
+        void withinDeltaR(double eta, double phi, double r, std::vector<int>& indices) const;
+
+        /// @brief - number and scalar pT sum of the particles with deltaR < r from (eta, phi), with the SIMD kernels
+        int countWithinDeltaR(double eta, double phi, double r) const;
+        double ptWithinDeltaR(double eta, double phi, double r) const;
+
+        /// @brief - index of the particle closest to (eta, phi), skipping the particle exclude_index
+        /// @return - -1 if there is no other particle
+        int nearestNeighbour(double eta, double phi, int exclude_index = -1) const;
+
+        /// @brief - position of the particle (index in the vector given to build), phi in [0, 2pi)
+        double eta(int index) const {return _particle_eta[index];};
+        double phi(int index) const {return _particle_phi[index];};
+
+        int numberParticles() const {return int(_particle_eta.size());};
+        double maxEta() const {return _max_eta;};
+
+    private:
+        double _max_eta;
+        int _number_eta;
+        int _number_phi;
+        double _eta_size;
+        double _phi_size;
+
+        /// @brief - position of each particle, in the order of the input
+        std::vector<double> _particle_eta;
+        std::vector<double> _particle_phi;
+        std::vector<double> _particle_pt;
+        std::vector<int> _particle_cell;
+
+        /// @brief - the particles of cell c are [_cell_start[c], _cell_start[c + 1]) of the sorted arrays
+        std::vector<int> _cell_start;
+        std::vector<double> _sorted_eta;
+        std::vector<double> _sorted_phi;
+        std::vector<double> _sorted_pt;
+        std::vector<int> _sorted_index;
+
+        /// @brief - the cone masks of the count and the pT sum, at the SIMD level of the CPU
+        const SimdKernels* _kernels;
+
+        int etaCell(double eta) const;
+        int phiCell(double phi) const;
+
+        /// @brief - calls visit(first sorted position, end sorted position) for each contiguous range of the cells that
+        ///          overlap the cone around (eta, phi), with phi in [0, 2pi)
+        template<typename RangeVisitor>
+        void visitCellRanges(double eta, double phi, double r, RangeVisitor visit) const;
+
+        /// @brief - calls visit(sorted position) for every particle with deltaR < r from (eta, phi)
+        template<typename Visitor>
+        void visitWithinDeltaR(double eta, double phi, double r, Visitor visit) const;
+};
+
+#endif
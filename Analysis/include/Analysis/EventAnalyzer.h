@@ -13,13 +13,23 @@
 #include <algorithm>   
 #include "Analysis/ParticleSelector.h"
 #include "Analysis/Observable.h"
+#include "Analysis/EventCut.h"
+#include "Analysis/EtaPhiGrid.h"
 #include "HepMC3/GenEvent.h"
 #include "HepMC3/GenParticle.h"
 
-enum ParticleType {FinalParticles, InitialParticles, OutgoingHardProcessParticles};
+enum ParticleType {FinalParticles, InitialParticles, OutgoingHardProcessParticles, HeavyFlavourHadrons};
 using Particles = std::map<ParticleType, std::vector<HepMC3::ConstGenParticlePtr>>;
 using ParticleSelection = std::map<ParticleType, const ParticleSelector*>;
 using ObservablesMap = std::map<std::string, const Observable*>;
+using GridsMap = std::map<ParticleType, EtaPhiGrid>;
+
+/// @brief - event-level cut of the pre-filter and the number of events that passed it
+struct EventCutEntry {
+    std::string name;
+    const EventCut* cut;
+    long passed_events;
+};
 
 class EventAnalyzer {
 
@@ -34,14 +44,37 @@ class EventAnalyzer {
         /// @param observable - pointer to the Observable instance
         void addObservable (std::string observable_name, const Observable* observable) {observables[observable_name] = observable;};
 
-        /// @brief - performs the analysis on the event - select the particles
-        void analyseEvent (const HepMC3::GenEvent& hepmc3_event);
+        /// @brief - adds a new event-level cut to the pre-filter (cuts are applied in the order they are added)
+        /// @param cut_name - name to identify the cut in the cut flow
+        /// @param cut - pointer to the EventCut instance
+        void addEventCut (std::string cut_name, const EventCut* cut) {event_cuts.push_back({cut_name, cut, 0});};
+
+        /// @brief - builds an eta-phi grid of the selected particles of the type in each event (see EtaPhiGrid.h)
+        /// @param max_eta - eta range of the grid (the acceptance of the particles)
+        /// @param cell_size - size of the cells in eta and phi (about the radius of the queries)
+        void enableGrid (ParticleType particle_type, double max_eta, double cell_size) {grids[particle_type] = EtaPhiGrid(max_eta, cell_size);};
+
+        /// @brief - performs the analysis on the event - applies the pre-filter and selects the particles
+        /// @return - false if the event was rejected by the pre-filter (no particles are selected in this case)
+        bool analyseEvent (const HepMC3::GenEvent& hepmc3_event);
+
+        /// @brief - returns the event-level quantities used by the pre-filter (only filled when there are cuts)
+        const EventSummary& getEventSummary () const {return event_summary;};
+
+        /// @brief - prints the number of events that passed each cut of the pre-filter
+        void printCutFlow (std::ostream& output = std::cout) const;
+
+        /// @brief - sets the counts of the cut flow to zero (to count each input file on its own)
+        void resetCutFlow ();
 
         /// @brief - returns the particles from a given selection type
         const std::vector<HepMC3::ConstGenParticlePtr>& getParticles (ParticleType particle_type) const;
 
-        /// @brief - returns the value of the observable evaluated on a vector of selected particles 
-        double evaluateObservable (std::string observable_name, ParticleType particle_type) const;
+        /// @brief - returns the grid of the particles of the current event, in the order of getParticles (nullptr if it is not enabled)
+        const EtaPhiGrid* getGrid (ParticleType particle_type) const;
+
+        /// @brief - returns the value of the observable evaluated on a vector of selected particles (with their grid if it is enabled)
+        double evaluateObservable (const std::string& observable_name, ParticleType particle_type) const;
 
     private:
         /// @brief - map to store the particles that must be selected on the event
@@ -50,11 +83,22 @@ class EventAnalyzer {
         ParticleSelection selection_criterias;
         /// @brief - stores all allowed observables by name
         ObservablesMap  observables;
+        /// @brief - eta-phi grids of the selected particles, rebuilt in each event
+        GridsMap grids;
+        /// @brief - cuts of the pre-filter
+        std::vector<EventCutEntry> event_cuts;
+        /// @brief - event-level quantities of the current event
+        EventSummary event_summary;
+        /// @brief - number of events given to the analyzer
+        long analysed_events = 0;
+
+        /// @brief - applies the pre-filter cuts, stopping at the first cut that fails
+        bool passEventCuts (const HepMC3::GenEvent& hepmc3_event);
         
         /// @brief - clears all the vectors - this has to be done at each event 
         void resetVectors ();
 };
 
-bool compareParticles (HepMC3::ConstGenParticlePtr part1, HepMC3::ConstGenParticlePtr part2);
+bool compareParticles (const HepMC3::ConstGenParticlePtr& part1, const HepMC3::ConstGenParticlePtr& part2);
 
 #endif
\ No newline at end of file
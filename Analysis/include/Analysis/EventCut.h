@@ -0,0 +1,107 @@
+/**
+ * @headerfile - Declaration of the EventCut interface and its concrete implementations.
+ *               The cuts act on the EventSummary, a handful of event-level quantities collected in a single
+ *               cheap loop over the particles. They are evaluated by the EventAnalyzer before the particle
+ *               classification, so rejected events never reach the expensive stages of the analysis.
+ **/
+
+#ifndef EVENT_CUT_H
+#define EVENT_CUT_H
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/FourVector.h"
+#include "Analysis/ParticleProperties.h"
+
+/**
+ * @class - event-level quantities used by the pre-filter
+ **/
+class EventSummary {
+    public:
+        /// @brief - collects the quantities from the particles of the event
+        void fill(const HepMC3::GenEvent& hepmc3_event);
+
+        /// @brief - invariant mass of the outgoing particles from the hard process (status 23)
+        double q2() const {return hard_process_momentum.m();};
+
+        /// @brief - total momentum of the outgoing particles from the hard process
+        HepMC3::FourVector hard_process_momentum;
+        /// @brief - absolute value of the pid of the initial particle (status 21) with the highest pT
+        int initial_particle_pid = 0;
+        /// @brief - pT of the leading final state charged particle (e, mu, pi, K, p)
+        double leading_charged_pt = 0;
+        /// @brief - number of final state charged particles (e, mu, pi, K, p)
+        int charged_multiplicity = 0;
+};
+
+/**
+* @class - Declaration of the EventCut interface.
+*          Its only method returns true if the event must be kept and false otherwise.
+**/
+class EventCut {
+    public:
+        virtual ~EventCut() {};
+
+        /// @brief - Indicates wether the event passes the cut or not.
+        /// @param summary - event-level quantities of the event.
+        virtual bool passCut(const EventSummary& summary) const = 0;
+};
+
+/**
+ * @class - accepts the events with q2 (invariant mass of the hard process) inside the window [q2_min, q2_max)
+ **/
+class Q2WindowCut: public EventCut {
+    public:
+        Q2WindowCut(double q2_min, double q2_max): _q2_min(q2_min), _q2_max(q2_max) {};
+
+        bool passCut(const EventSummary& summary) const override;
+
+    private:
+        double _q2_min, _q2_max;
+};
+
+/**
+ * @class - accepts the events where the initial particle has one of the given pids (absolute value)
+ **/
+class InitialPartonCut: public EventCut {
+    public:
+        InitialPartonCut(const std::vector<int>& pids): _pids(pids) {};
+
+        bool passCut(const EventSummary& summary) const override;
+
+    private:
+        std::vector<int> _pids;
+};
+
+/**
+ * @class - accepts the events where the leading charged particle has pT greater or equal than the minimum
+ **/
+class LeadingChargedPtCut: public EventCut {
+    public:
+        LeadingChargedPtCut(double min_pt): _min_pt(min_pt) {};
+
+        bool passCut(const EventSummary& summary) const override {return summary.leading_charged_pt >= _min_pt;};
+
+    private:
+        double _min_pt;
+};
+
+/**
+ * @class - accepts the events with the number of final state charged particles inside [min, max]
+ **/
+class ChargedMultiplicityCut: public EventCut {
+    public:
+        ChargedMultiplicityCut(int min_multiplicity, int max_multiplicity = std::numeric_limits<int>::max()):
+            _min_multiplicity(min_multiplicity), _max_multiplicity(max_multiplicity) {};
+
+        bool passCut(const EventSummary& summary) const override;
+
+    private:
+        int _min_multiplicity, _max_multiplicity;
+};
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @headerfile - splits the events of one HepMC3 file among N jobs (shards).
+ *               The events are grouped in blocks of consecutive events and block b belongs to shard b % N,
+ *               so the assignment only depends on the event position in the file and needs no previous scan.
+ *               Each shard reads its own blocks and skips the others with Reader::skip, which does not build GenEvents
+ *               (ReaderAscii for the HepMC3 files, SkimReader for the skims).
+ *               The provenance of each shard output (which blocks were read and how many rows were written)
+ *               is stored next to it, so the merge can check that no event is missing or duplicated.
+ **/
+
+#ifndef EVENT_SHARDING_H
+#define EVENT_SHARDING_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include "HepMC3/Reader.h"
+#include "HepMC3/GenEvent.h"
+
+/**
+ * @class - index of the shard and total number of shards
+ **/
+class ShardSpec {
+    public:
+        ShardSpec(int index = 0, int count = 1): index(index), count(count) {};
+
+        /// @brief - reads the shard from the format "i/N" (i = 0, ..., N - 1)
+        /// @return - false if the text is not a valid shard
+        static bool parse(const std::string& text, ShardSpec& shard);
+
+        /// @brief - true if the shard owns the block
+        bool ownsBlock(long block) const {return block % count == index;};
+
+        /// @brief - true if the events are split among more than one job
+        bool isSharded() const {return count > 1;};
+
+        int index;
+        int count;
+};
+
+/**
+ * @class - provenance of the output of a shard
+ **/
+class ShardProvenance {
+    public:
+        /// @brief - writes the provenance as "key value" lines
+        bool write(const std::string& filename) const;
+
+        /// @brief - reads the provenance written by write
+        /// @return - false if the file is missing or incomplete
+        static bool read(const std::string& filename, ShardProvenance& provenance);
+
+        /// @brief - name of the file with the provenance of an output file
+        static std::string provenanceFilename(const std::string& output_filename) {return output_filename + ".meta";};
+
+        /// @brief - number of events in the file owned by the shard, given the total number of events in the file
+        long expectedEvents(long total_events) const;
+
+        std::string input_file;
+        std::string output_file;
+        ShardSpec shard;
+        long block_size = 0;
+        /// @brief - number of events read and of rows written in each block of the shard (blocks shard.index, shard.index + N, ...)
+        std::vector<long> events_per_block;
+        std::vector<long> rows_per_block;
+};
+
+/**
+ * @class - reads only the events that belong to the shard
+ **/
+class ShardedReader {
+    public:
+        /// @param block_size - events per block, must be positive (the reader fails otherwise)
+        ShardedReader(HepMC3::Reader& hepmc_file, const ShardSpec& shard, long block_size);
+
+        /// @brief - true if the block size is invalid, no event is read then
+        bool failed() const {return _failed;};
+
+        /// @brief - reads the next event of the shard, skipping the events of the other shards
+        /// @return - false if there are no events left or the reader failed
+        bool readEvent(HepMC3::GenEvent& hepmc_event);
+
+        /// @brief - position in the file of the last event read
+        long eventIndex() const {return _event_index;};
+
+        /// @brief - counts one output row for the last event read
+        void addOutputRow() {_provenance.rows_per_block.back()++;};
+
+        /// @brief - provenance of the events read so far
+        ShardProvenance& provenance() {return _provenance;};
+
+    private:
+        HepMC3::Reader& _hepmc_file;
+        ShardSpec _shard;
+        long _block_size;
+        /// @brief - position in the file of the last event read (-1 before the first event)
+        long _event_index;
+        ShardProvenance _provenance;
+        bool _failed;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @headerfile - reads a HepMC3 file and runs the analysis chain of select_hepmc_particles
+ *               (EventAnalyzer + SignalParticlesSearcher) on it, filling batches of events stored in flat buffers.
+ *               The buffers are laid out as C-contiguous arrays so they can be handed to NumPy without copies.
+ **/
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/Observable.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/SignalParticlesSearcher.h"
+#include "Analysis/HepMCInput.h"
+#include "HepMC3/ReaderAscii.h"
+#include "HepMC3/GenEvent.h"
+
+/**
+ * @class - batch of events in the same layout as the CSV files, zero padded up to the maximum number of particles
+ **/
+class EventBatch {
+    public:
+        /// @brief - number of events in the batch
+        std::size_t size() const {return q2.size();};
+
+        /// @brief - invariant mass of the hard process [n_events]
+        std::vector<double> q2;
+        /// @brief - pid of the initial particle [n_events]
+        std::vector<std::int32_t> initial_pid;
+        /// @brief - number of stored particles, before the zero padding [n_events]
+        std::vector<std::int32_t> number_particles;
+        /// @brief - (pt, eta, phi) of the final particles from the hard process [n_events, max_particles, 3]
+        std::vector<float> kinematics;
+        /// @brief - pid of the final particles from the hard process [n_events, max_particles]
+        std::vector<std::int32_t> pid;
+};
+
+/**
+ * @class - streams batches of analysed events out of a HepMC3 file
+ **/
+class EventStream {
+
+    public:
+        EventStream(const std::string& filename, int max_number_particles);
+
+        /// @brief - fills the batch with up to batch_size events (the batch is cleared first)
+        /// @return - false if there are no events left in the file
+        bool nextBatch(EventBatch& batch, std::size_t batch_size);
+
+        /// @brief - maximum number of particles stored per event
+        int maxNumberParticles() const {return _max_number_particles;};
+
+    private:
+        int _max_number_particles;
+
+        /// @brief - HepMC3 file (possibly compressed) and the current event
+        std::shared_ptr<HepMCInputStream> _hepmc_input;
+        HepMC3::ReaderAscii _hepmc_file;
+        HepMC3::GenEvent _hepmc_event;
+
+        /// @brief - the selectors, observable and searcher of the analysis chain
+        const FinalStateSelector _final_state_selector;
+        const ChargedParticlesSelector _charged_particle_selector;
+        const MultipleParticleSelectors _particle_selector;
+        const InitialStateSelector _initial_particle_selector;
+        const OutgoingParticlesFromHardProcess _hard_process_selector;
+        const InvariantMass _invariant_mass;
+        EventAnalyzer _event_analyzer;
+        SignalParticlesSearcher _signal_particle_searcher;
+
+        /// @brief - appends the current event to the batch
+        void addEvent(EventBatch& batch);
+};
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @headerfile - writes text to a file, either directly on the calling thread or asynchronously.
+ *               In the asynchronous mode there are two buffers: the analysis thread fills one of them while a
+ *               dedicated I/O thread writes the other one to the file. When the buffer being filled is full and the
+ *               I/O thread is still writing the other one, the analysis thread waits (backpressure), so the memory
+ *               used is bounded by twice the buffer size.
+ **/
+
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+class FileWriter {
+
+    public:
+        /// @brief - default size of each buffer in the asynchronous mode
+        static constexpr std::size_t default_buffer_size = 1 << 22;
+
+        /// @param filename - name of the file to write
+        /// @param async - true to write the file on a dedicated I/O thread
+        /// @param buffer_size - size of each of the two buffers in the asynchronous mode
+        FileWriter(const std::string& filename, bool async = false, std::size_t buffer_size = default_buffer_size);
+        ~FileWriter() {close();};
+
+        FileWriter(const FileWriter&) = delete;
+        FileWriter& operator=(const FileWriter&) = delete;
+
+        /// @brief - true if the file could be opened
+        bool is_open() const {return _is_open;};
+
+        /// @brief - appends the text to the file
+        void write(const char* data, std::size_t size);
+        void write(const std::string& text) {write(text.data(), text.size());};
+
+        /// @brief - writes everything left and closes the file (waits for the I/O thread)
+        /// @return - false if any write failed
+        bool close();
+
+        /// @brief - true if a write failed (in the asynchronous mode the error may be reported one buffer later)
+        bool failed() const {return _failed;};
+
+        /// @brief - description of the first error
+        std::string errorMessage();
+
+        /// @brief - number of times the analysis thread had to wait for the I/O thread
+        long stalls() const {return _stalls;};
+
+        /// @brief - number of bytes given to write (in the asynchronous mode some may still be in the buffers)
+        std::uint64_t bytesWritten() const {return _bytes_written;};
+
+    private:
+        std::string _filename;
+        bool _async;
+        std::size_t _buffer_size;
+        bool _is_open;
+        bool _closed = false;
+        std::ofstream _output_file;
+
+        /// @brief - buffer filled by the analysis thread and buffer written by the I/O thread
+        std::string _filling_buffer, _flushing_buffer;
+        /// @brief - true while the flushing buffer has data the I/O thread did not write yet
+        bool _flush_pending = false;
+        bool _stop = false;
+        std::atomic<bool> _failed {false};
+        bool _error_reported = false;
+        std::string _error_message;
+        long _stalls = 0;
+        std::uint64_t _bytes_written = 0;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::thread _io_thread;
+
+        /// @brief - hands the filled buffer to the I/O thread, waiting if it is still busy with the previous one
+        void swapBuffers();
+
+        /// @brief - writes the data to the file and records the first error
+        void writeToFile(const char* data, std::size_t size);
+
+        /// @brief - loop of the I/O thread
+        void ioLoop();
+
+        /// @brief - prints the error once
+        void reportError();
+};
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @headerfile - opens HepMC3 ASCII files that may be compressed with gzip or zstd.
+ *               The compression is detected from the magic bytes of the file (or from the extension if the file
+ *               is too short). A read-ahead thread reads and decompresses the file into a ring of chunks while
+ *               ReaderAscii parses the previous ones, so the parsing never waits on the disk or on the decompression.
+ *               Uncompressed files go through the same read-ahead, which hides the latency of network file systems.
+ *               zstd support needs the ANALYSIS_WITH_ZSTD flag (WITH_ZSTD=1 in the Makefile).
+ *
+ *               The stream can also read only a sample of the events (every Nth event, the first N events, a random
+ *               fraction). ReaderAscii parses every event it is given, even the ones it skips, so the events out of the
+ *               sample are removed before it: a filter between the read-ahead buffer and ReaderAscii looks only at the
+ *               first character of each line ('E' starts an event) and drops the lines of the events out of the sample
+ *               without tokenising them, so the cost of the events out of the sample is the speed of memchr.
+ **/
+
+#ifndef HEPMC_INPUT_H
+#define HEPMC_INPUT_H
+
+#include <iostream>
+#include <cstdio>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <streambuf>
+#include <istream>
+#include "HepMC3/ReaderAscii.h"
+
+enum Compression {NoCompression, GzipCompression, ZstdCompression};
+
+/// @brief - detects the compression of the file from its magic bytes or, if it cannot be read, from its extension
+Compression detectCompression(const std::string& filename);
+
+/// @brief - returns the file name, or the name with a .gz or .zst extension if only the compressed file exists
+std::string resolveInputFilename(const std::string& filename);
+
+/**
+ * @class - source of the (decompressed) bytes of the file
+ **/
+class InputSource {
+    public:
+        virtual ~InputSource() {};
+
+        /// @brief - reads up to size decompressed bytes into the buffer
+        /// @return - number of bytes read, 0 at the end of the file and -1 on error
+        virtual long read(char* buffer, std::size_t size) = 0;
+
+        /// @brief - number of bytes read from the file on disk (compressed bytes for compressed files)
+        virtual std::uint64_t fileOffset() const = 0;
+};
+
+/// @brief - creates the source for the file given its compression (nullptr if the file cannot be opened)
+std::unique_ptr<InputSource> makeInputSource(const std::string& filename, Compression compression);
+
+/**
+ * @class - stream buffer filled by a read-ahead thread
+ **/
+class ReadAheadStreamBuf: public std::streambuf {
+    public:
+        /// @param source - where the bytes come from
+        /// @param chunk_size - size of each chunk
+        /// @param number_chunks - number of chunks in the ring (how far the thread can read ahead)
+        ReadAheadStreamBuf(std::unique_ptr<InputSource> source, std::size_t chunk_size = 1 << 22, int number_chunks = 4);
+        ~ReadAheadStreamBuf();
+
+        /// @brief - true if reading or decompressing the file failed
+        bool failed() const {return _failed;};
+
+        /// @brief - number of bytes read from the file on disk
+        std::uint64_t fileOffset() const {return _file_offset;};
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        std::unique_ptr<InputSource> _source;
+
+        /// @brief - ring of chunks, the reader thread fills them in order and the parser consumes them in the same order
+        std::vector<std::vector<char>> _chunks;
+        std::vector<std::size_t> _chunk_sizes;
+        std::size_t _next_to_fill = 0, _next_to_read = 0;
+        /// @brief - number of chunks filled and not released by the parser (including the one being parsed)
+        int _filled_chunks = 0;
+        bool _holds_chunk = false;
+        bool _end_of_file = false, _stop = false;
+        std::atomic<bool> _failed {false};
+        std::atomic<std::uint64_t> _file_offset {0};
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::thread _reader_thread;
+
+        /// @brief - loop of the read-ahead thread
+        void readLoop();
+};
+
+/**
+ * @class - events of the file that are read, by their position in the file (all the conditions must hold)
+ **/
+class EventSampling {
+    public:
+        /// @brief - true if the event is in the sample
+        bool keepsEvent(long event) const;
+
+        /// @brief - true if no event at this position or after it is in the sample
+        bool isPastLastEvent(long event) const {return max_events >= 0 && event >= max_events;};
+
+        /// @brief - true if some events are left out
+        bool isSampling() const {return prescale > 1 || max_events >= 0 || fraction < 1;};
+
+        /// @brief - the conditions in words, for the output of the programs
+        std::string description() const;
+
+        /// @brief - keeps the events 0, N, 2N, ...
+        long prescale = 1;
+        /// @brief - keeps only the first max_events events of the file (-1 for all)
+        long max_events = -1;
+        /// @brief - probability to keep an event, drawn from the seed and the position of the event (the same events
+        ///          are kept in every run and in every shard)
+        double fraction = 1;
+        std::uint64_t seed = 1;
+};
+
+/**
+ * @class - stream buffer that passes to the reader only the lines of the events in the sample (and the header and
+ *          footer lines of the file). The kept lines are compacted in place in the buffer, so nothing is copied twice.
+ **/
+class EventSamplingStreamBuf: public std::streambuf {
+    public:
+        /// @param source - the bytes of the whole file (must outlive the filter)
+        EventSamplingStreamBuf(std::streambuf* source, const EventSampling& sampling, std::size_t chunk_size = 1 << 20);
+
+        /// @brief - position in the file of the event given to the reader in position passed_event
+        long fileEventIndex(long passed_event) const {return _passed_events[passed_event];};
+
+        /// @brief - number of events found in the file so far and number given to the reader
+        long scannedEvents() const {return _next_event;};
+        long passedEvents() const {return _passed_events.size();};
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        std::streambuf* _source;
+        EventSampling _sampling;
+        std::vector<char> _buffer;
+        /// @brief - state at the end of the previous chunk: at the start of a line, and inside lines that are passed
+        bool _at_line_start = true;
+        bool _passing = true;
+        /// @brief - the end of the file or the end of the sample was reached
+        bool _finished = false;
+        /// @brief - position in the file of the next event
+        long _next_event = 0;
+        /// @brief - positions in the file of the events given to the reader
+        std::vector<long> _passed_events;
+};
+
+/**
+ * @class - input stream over a (possibly compressed) HepMC3 file, to be given to HepMC3::ReaderAscii
+ **/
+class HepMCInputStream: public std::istream {
+    public:
+        /// @param sampling - events given to the reader (all by default)
+        HepMCInputStream(const std::string& filename, const EventSampling& sampling = EventSampling());
+
+        /// @brief - true if the file was opened
+        bool is_open() const {return _buffer != nullptr;};
+
+        Compression compression() const {return _compression;};
+
+        /// @brief - size of the file on disk and number of bytes read from it so far (for progress estimates)
+        std::uint64_t fileSize() const {return _file_size;};
+        std::uint64_t fileOffset() const {return _buffer ? _buffer->fileOffset() : 0;};
+
+        /// @brief - true if reading or decompressing the file failed
+        bool readFailed() const {return _buffer && _buffer->failed();};
+
+        /// @brief - position in the file of the event read in position event (the same without sampling)
+        long fileEventIndex(long event) const {return _sampling_buffer ? _sampling_buffer->fileEventIndex(event) : event;};
+
+        /// @brief - number of events of the file scanned so far (only counted with sampling, -1 otherwise)
+        long scannedEvents() const {return _sampling_buffer ? _sampling_buffer->scannedEvents() : -1;};
+
+    private:
+        Compression _compression;
+        std::uint64_t _file_size;
+        std::unique_ptr<ReadAheadStreamBuf> _buffer;
+        /// @brief - filter of the events in front of _buffer (only with sampling)
+        std::unique_ptr<EventSamplingStreamBuf> _sampling_buffer;
+};
+
+/// @brief - opens the stream over the file (use resolveInputFilename to find compressed copies)
+std::shared_ptr<HepMCInputStream> openHepMCInput(const std::string& filename, const EventSampling& sampling = EventSampling());
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @headerfile - timers and counters for the stages of the event loop (read, select, search, observables, cluster and
+ *               write), with a periodic progress line and a JSON summary at the end of each file.
+ *               The instrumentation is compiled in with -DANALYSIS_WITH_INSTRUMENTATION (make WITH_INSTRUMENTATION=1,
+ *               the default). Without it all the methods below are empty inline functions and the compiler removes
+ *               them, so the event loop can keep the calls in both builds.
+ *               When enabled, each scoped timer costs two reads of the steady clock (tens of ns), which is
+ *               negligible next to the microseconds to milliseconds that each stage takes per event.
+ *               With -DANALYSIS_COUNT_ALLOCATIONS (make COUNT_ALLOCATIONS=1) the timers also count the heap
+ *               allocations of each stage (see AllocationCounter.h).
+ **/
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+#include "Analysis/AllocationCounter.h"
+#endif
+
+/// @brief - stages of the event loop
+enum EventLoopStage {ReadStage, OverlayStage, SelectStage, SearchStage, ObservablesStage, ClusterStage, DetectorStage, WriteStage, NumberOfStages};
+
+/// @brief - name of the stage in the progress line and in the summary
+const char* stageName(EventLoopStage stage);
+
+/// @brief - the string as a JSON string, quoted and with the quotes, backslashes and control characters escaped
+std::string jsonString(const std::string& value);
+
+#ifdef ANALYSIS_WITH_INSTRUMENTATION
+
+/**
+ * @class - accumulates the time spent in each stage and the throughput counters of the loop over one file
+ **/
+class EventLoopMonitor {
+    public:
+        static constexpr bool enabled = true;
+
+        /// @param name - name of the sample (written in the summary)
+        /// @param file_size - size of the input file on disk, used for the ETA (0 if unknown)
+        /// @param progress_interval - number of events between progress lines
+        EventLoopMonitor(const std::string& name, std::uint64_t file_size, long progress_interval = 10000);
+
+        /// @brief - adds the elapsed time to the stage
+        void addTime(EventLoopStage stage, std::chrono::steady_clock::duration elapsed) {_stage_time[stage] += elapsed;};
+
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+        /// @brief - adds the heap allocations made during the stage
+        void addAllocations(EventLoopStage stage, const AllocationCount& count) {
+            _stage_allocations[stage].allocations += count.allocations;
+            _stage_allocations[stage].bytes += count.bytes;
+        };
+#endif
+
+        /// @brief - counts an event read from the file with its number of particles
+        void countEvent(std::size_t particles) {_events++; _particles += particles;};
+
+        /// @brief - counts an event written to the output with its number of particles
+        void countWrittenEvent(std::size_t particles) {_written_events++; _written_particles += particles;};
+
+        /// @brief - updates the number of bytes read from the file on disk and written to the output
+        void setBytesRead(std::uint64_t bytes) {_bytes_read = bytes;};
+        void setBytesWritten(std::uint64_t bytes) {_bytes_written = bytes;};
+
+        /// @brief - true every progress_interval events
+        bool progressDue() const {return _progress_interval > 0 && _events % _progress_interval == 0;};
+
+        /// @brief - prints the events, rate, fraction of the file read and ETA in one line
+        void printProgress(std::ostream& output = std::cout) const;
+
+        /// @brief - writes the summary of the loop as a JSON object
+        void writeSummary(std::ostream& output) const;
+
+        /// @brief - writes the summary to a file
+        /// @return - false if the file could not be written
+        bool writeSummary(const std::string& filename) const;
+
+    private:
+        std::string _name;
+        std::uint64_t _file_size;
+        long _progress_interval;
+        std::chrono::steady_clock::time_point _start;
+        std::chrono::steady_clock::duration _stage_time[NumberOfStages] {};
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+        AllocationCount _stage_allocations[NumberOfStages];
+#endif
+        long _events = 0, _written_events = 0;
+        std::uint64_t _particles = 0, _written_particles = 0;
+        std::uint64_t _bytes_read = 0, _bytes_written = 0;
+
+        /// @brief - seconds since the creation of the monitor
+        double elapsedSeconds() const;
+};
+
+/**
+ * @class - adds the time between its construction and destruction to a stage of the monitor
+ **/
+class StageTimer {
+    public:
+        StageTimer(EventLoopMonitor& monitor, EventLoopStage stage): _monitor(monitor), _stage(stage), _start(std::chrono::steady_clock::now()) {
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+            _start_allocations = threadAllocations();
+#endif
+        };
+        ~StageTimer() {stop();};
+
+        /// @brief - stops the timer before the end of the scope (the time is only added once)
+        void stop() {
+            if (!_running)
+                return;
+            _monitor.addTime(_stage, std::chrono::steady_clock::now() - _start);
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+            _monitor.addAllocations(_stage, threadAllocations() - _start_allocations);
+#endif
+            _running = false;
+        };
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        EventLoopMonitor& _monitor;
+        EventLoopStage _stage;
+        std::chrono::steady_clock::time_point _start;
+        bool _running = true;
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+        AllocationCount _start_allocations;
+#endif
+};
+
+#else
+
+/// no-op versions when the instrumentation is compiled out
+class EventLoopMonitor {
+    public:
+        static constexpr bool enabled = false;
+
+        EventLoopMonitor(const std::string&, std::uint64_t, long = 10000) {};
+        void addTime(EventLoopStage, std::chrono::steady_clock::duration) {};
+        void countEvent(std::size_t) {};
+        void countWrittenEvent(std::size_t) {};
+        void setBytesRead(std::uint64_t) {};
+        void setBytesWritten(std::uint64_t) {};
+        bool progressDue() const {return false;};
+        void printProgress(std::ostream& = std::cout) const {};
+        void writeSummary(std::ostream&) const {};
+        bool writeSummary(const std::string&) const {return true;};
+};
+
+class StageTimer {
+    public:
+        StageTimer(EventLoopMonitor&, EventLoopStage) {};
+        void stop() {};
+};
+
+#endif
+
+#endif
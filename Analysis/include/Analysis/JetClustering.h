@@ -8,54 +8,167 @@
 #define JET_CLUSTERING_H
 
 #include <vector>
+#include <memory>
 #include "fastjet/PseudoJet.hh"
 #include "fastjet/ClusterSequence.hh"
 #include "HepMC3/GenParticle.h"
 #include "fastjet/ClusterSequenceArea.hh"
+#include "fastjet/Selector.hh"
+#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
+#include "fastjet/tools/JetMedianBackgroundEstimator.hh"
+#include "fastjet/tools/Subtractor.hh"
 #include "HepMC3/FourVector.h"
+#include "Analysis/ParticleProperties.h"
 
 
+/// @brief - truth flavour of a jet (the pid of the quark for b and c)
+enum JetFlavour {NoFlavour = 0, LightFlavour = 1, CharmFlavour = 4, BottomFlavour = 5, GluonFlavour = 21};
+
 /**
- * @class - Subclassing UserInfo class to store the particle
- *          information from the HepMC3::GenParticle class.  
+ * @brief - truth label of a jet
  **/
-class HepMC3Info: public fastjet::PseudoJet::UserInfoBase {
-
-    public:
-        /// @brief - we can store the pid number and the respective eletric charge from the particle 
-        HepMC3Info (const int pid): _pid(pid){};
-        
-        /// access to the pid number and eletric charge
-        const int pid() const {return _pid;};
-
-    private:
-        const int _pid;
+struct JetFlavourInfo {
+    JetFlavour flavour;
+    /// @brief - pid of the hadron or parton that gave the label (0 if none)
+    int pid;
+    /// @brief - true if the label comes from a ghost inside the jet, false for the deltaR fallback
+    bool ghost_matched;
 };
 
-
 /**
- * @class - reconstruct the jets out of the HepMC3::GenParticles
+ * @class - reconstruct the jets out of the HepMC3::GenParticles.
+ *          The jets can be labelled with the truth particles (the status 23 partons and the weakly decaying heavy-flavour
+ *          hadrons), which are clustered together with the particles as ghosts: their momentum is scaled down so they
+ *          do not change the jets, and each one ends in the jet it points to. A jet with a b hadron ghost is a b jet,
+ *          then a jet with a c hadron ghost is a c jet, otherwise the hardest parton ghost gives the flavour. A jet without
+ *          ghosts gets the flavour of the closest parton within the jet radius. The ghosts are found in the constituents
+ *          of the jets, so there is no separate matching of the jets and the partons.
  **/
 class JetClustering {
     
     public:
         JetClustering(double jet_radius, double min_pt, fastjet::JetAlgorithm jet_algorithm):  _min_pt(min_pt), _jet_definition(jet_algorithm, jet_radius) {};
+        virtual ~JetClustering() {};
 
         /// @brief - performs the jet reconstruction out of the HepMC3 particles
         /// @param particles - vector with the particles that must be used for the jet reconstruction
-        std::vector<fastjet::PseudoJet> clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles);
+        std::vector<fastjet::PseudoJet> clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles) {return clusterJets(particles, _no_truth_particles);};
 
+        /// @brief - performs the jet reconstruction and labels the jets (see jetFlavours)
+        /// @param truth_particles - partons and heavy-flavour hadrons added as ghosts (an empty vector labels nothing)
+        virtual std::vector<fastjet::PseudoJet> clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles,
+                                                             const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles);
 
-    private:
+        /// @brief - labels of the jets of the last clustering with truth particles, in the order of the jets
+        const std::vector<JetFlavourInfo>& jetFlavours () const {return _jet_flavours;};
+
+        /// @brief - radius of the jets
+        double jetRadius () const {return _jet_definition.R();};
+
+        /// @brief - true for the ghosts of the truth particles, which the users of the constituents must skip
+        static bool isTruthGhost (const fastjet::PseudoJet& constituent) {return constituent.user_index() < truth_ghost_index + max_truth_ghosts;};
+
+        /// @brief - number of constituents of the jet without the truth ghosts
+        static int numberConstituents (const fastjet::PseudoJet& jet);
+
+        /// @brief - pid and eletric charge of a jet constituent (the pid is stored as the user index of the PseudoJet,
+        ///          which needs no allocation per particle, unlike a UserInfoBase)
+        static int pid (const fastjet::PseudoJet& constituent) {return constituent.user_index();};
+        static double charge (const fastjet::PseudoJet& constituent) {return ParticleProperties::charge(constituent.user_index());};
+
+
+    protected:
         /// @brief - the minimum jet pt
         double _min_pt;
 
         /// @brief - the jet definition will be the same for every jet
         fastjet::JetDefinition _jet_definition;
-        fastjet::ClusterSequence _cluster_seq;
 
         /// @brief - Converts the HepMC3_Particles to a vector of PseudoJet objects
-        std::vector<fastjet::PseudoJet> convertParticlesToPseudoJets(const std::vector<HepMC3::ConstGenParticlePtr> &particles) const;
+        /// @return - the vector is a member reused in every event, valid until the next conversion
+        const std::vector<fastjet::PseudoJet>& convertParticlesToPseudoJets(const std::vector<HepMC3::ConstGenParticlePtr> &particles);
+
+        /// @brief - buffer with the PseudoJets of the current event
+        std::vector<fastjet::PseudoJet> _pseudo_jets;
+
+        /// @brief - appends the ghosts of the truth particles to the PseudoJets of the event
+        void addTruthGhosts (const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles);
+
+        /// @brief - labels the jets from the truth ghosts in their constituents, with the deltaR fallback
+        void labelJets (const std::vector<fastjet::PseudoJet>& jets, const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles);
+
+        /// @brief - labels of the jets of the last event
+        std::vector<JetFlavourInfo> _jet_flavours;
+
+        /// @brief - the user index of the truth ghost i is truth_ghost_index + i, below any pid (the pid is the user index of the particles)
+        static constexpr int truth_ghost_index = -2147483647 - 1;
+        static constexpr int max_truth_ghosts = 1000000;
+        /// @brief - factor applied to the momentum of the truth particles
+        static constexpr double ghost_scale = 1e-18;
+        static const std::vector<HepMC3::ConstGenParticlePtr> _no_truth_particles;
+
+    private:
+        fastjet::ClusterSequence _cluster_seq;
+};
+
+
+/// @brief - estimators of the underlying event density rho
+enum BackgroundEstimator {GridMedianEstimator, KtJetMedianEstimator};
+
+/**
+ * @brief - parameters of the area and of the rho estimation (ALICE charged-jet defaults)
+ **/
+struct BackgroundSettings {
+    /// @brief - acceptance of the particles (tracks): the particles with |eta| above it are dropped, and the ghosts
+    ///          of the areas and the rho estimation cover |rapidity| up to it
+    double max_rapidity = 0.9;
+    /// @brief - area of each ghost used to compute the jet areas
+    double ghost_area = 0.005;
+    /// @brief - size of the cells for the grid-median estimator
+    double grid_spacing = 0.55;
+    /// @brief - radius of the kT jets for the jet-median estimator
+    double kt_radius = 0.2;
+    /// @brief - number of leading kT jets excluded from the median
+    unsigned int n_hardest_removed = 2;
+};
+
+/**
+ * @class - reconstructs the jets with their areas and subtracts the underlying event, pT -> pT - rho * A.
+ *          The grid-median estimator needs no clustering. The kT-median estimator reuses the jet clustering
+ *          when the jets are themselves kT jets with the same radius, otherwise it clusters the kT jets once more.
+ *          The particles outside the acceptance of the settings are not clustered, as there are no ghosts there.
+ **/
+class SubtractedJetClustering: public JetClustering {
+
+    public:
+        SubtractedJetClustering(double jet_radius, double min_pt, fastjet::JetAlgorithm jet_algorithm, BackgroundEstimator estimator, const BackgroundSettings& settings = BackgroundSettings());
+
+        using JetClustering::clusterJets;
+
+        /// @brief - performs the jet reconstruction and returns the subtracted jets with pT greater than the min pt
+        /// @param particles - vector with the particles that must be used for the jet reconstruction
+        /// @param truth_particles - ghosts that label the jets (they are not used for the rho estimation)
+        std::vector<fastjet::PseudoJet> clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles,
+                                                     const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles) override;
+
+        /// @brief - underlying event density and its fluctuation in the last event
+        double rho () const {return _background_estimator->rho();};
+        double sigma () const {return _background_estimator->sigma();};
+
+    private:
+        /// @brief - type of the rho estimation
+        BackgroundEstimator _estimator_type;
+        /// @brief - |eta| acceptance of the particles
+        double _max_eta;
+        /// @brief - true if the kT-median estimator uses the same clustering as the jets
+        bool _shared_clustering;
+
+        fastjet::AreaDefinition _area_definition;
+        std::unique_ptr<fastjet::ClusterSequenceArea> _cluster_seq_area;
+        std::unique_ptr<fastjet::BackgroundEstimatorBase> _background_estimator;
+        fastjet::Subtractor _subtractor;
+        /// @brief - the particles without the truth ghosts, for the rho estimation
+        std::vector<fastjet::PseudoJet> _background_particles;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * @headerfile - many jet shape observables from the constituents in one pass.
+ *               Unlike the Observable interface, which computes one value from the HepMC3 particles, all the features
+ *               of a jet are computed together from a structure of arrays (z, rapidity, phi) of its constituents and a
+ *               single matrix of the pairwise distances deltaR_ij^2, shared by all the observables:
+ *                   angularities    lambda(kappa, beta) = sum_i z_i^kappa (deltaR_i,jet / R)^beta
+ *                   correlators     e2(beta) = sum_{i<j} z_i z_j theta_ij,  e3(beta) = sum_{i<j<k} z_i z_j z_k theta_ij theta_ik theta_jk,
+ *                                   C2 = e3 / e2^2 and D2 = e3 / e2^3, with theta_ij = deltaR_ij^beta
+ *                   energy flow polynomials (EFPs) - the prime (connected) multigraphs up to degree 3, summed over all the
+ *                                   constituents at each vertex with theta_ij = deltaR_ij^beta on each edge:
+ *                                   degree 1: edge,  degree 2: double edge, wedge,  degree 3: triple edge, double edge + edge, triangle,
+ *                                   path of 4 vertices, star of 3 edges
+ *               with z_i = pt_i / sum pt. Only the triangle (and e3) needs the O(n^3) loop, the other EFPs are built from the
+ *               row sums sum_j z_j theta_ij^k of the matrix. The inner loops run over contiguous arrays with independent accumulators,
+ *               so they vectorise.
+ **/
+
+#ifndef JET_OBSERVABLES_H
+#define JET_OBSERVABLES_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include "fastjet/PseudoJet.hh"
+#include "Analysis/SimdKernels.h"
+
+
+/**
+ * @brief - the observables computed for each jet. The features are in the order angularities, then (e2, e3, C2, D2) of each
+ *          correlator beta, then the EFPs of each EFP beta (1, 3 or 8 values for a maximum degree of 1, 2 or 3).
+ **/
+struct JetObservableSettings {
+    /// @brief - radius of the jets, which normalises the distances to the axis in the angularities
+    double jet_radius = 0.4;
+    /// @brief - (kappa, beta) of each angularity
+    std::vector<std::pair<double, double>> angularities;
+    std::vector<double> correlator_betas;
+    std::vector<double> efp_betas;
+    int efp_max_degree = 3;
+
+    /// @brief - number of features of each jet
+    int numberFeatures() const;
+
+    /// @brief - name of each feature, e.g. lambda_k1_b0.5, c2_b1 or efp_b1_wedge
+    std::vector<std::string> featureNames() const;
+
+    /// @brief - reads the observables from words "angularity <kappa> <beta>", "ecf <beta>" and "efp <beta> <max degree>"
+    /// @return - false if a word is not an observable, the values are missing or the EFPs have different maximum degrees
+    bool parse(const std::vector<std::string>& words, std::size_t first);
+};
+
+/**
+ * @class - computes the features of the jets. The buffers of each thread are members reused for every jet,
+ *          so they only allocate until they fit the largest jet.
+ **/
+class JetObservableCalculator {
+
+    public:
+        /// @param number_threads - threads used by the evaluation of a list of jets
+        JetObservableCalculator(const JetObservableSettings& settings, int number_threads = 1);
+
+        int numberFeatures() const {return _number_features;};
+        const JetObservableSettings& settings() const {return _settings;};
+
+        /// @brief - computes the features of one jet in the calling thread
+        /// @param features - the numberFeatures() values are written here
+        void evaluate(const fastjet::PseudoJet& jet, double* features);
+
+        /// @brief - computes the features of the jets, one row of numberFeatures() values per jet. The jets are shared
+        ///          between the threads, so a long list (e.g. the jets of a block of events) spreads the work best.
+        void evaluate(const std::vector<fastjet::PseudoJet>& jets, std::vector<double>& features);
+
+    private:
+        /// @brief - constituents of the jet as a structure of arrays, the distance matrices and the row sums
+        struct Workspace {
+            std::vector<double> z, rap, phi, axis_distance;
+            /// @brief - deltaR_ij^2 and theta_ij = deltaR_ij^beta, n x n row major
+            std::vector<double> distance2, theta;
+            /// @brief - sum_j z_j theta_ij, sum_j z_j theta_ij^2, sum_j z_j theta_ij^3 and z_i times the first
+            std::vector<double> row_sum1, row_sum2, row_sum3, z_row_sum1;
+        };
+
+        JetObservableSettings _settings;
+        int _number_features;
+        int _number_threads;
+        std::vector<Workspace> _workspaces;
+        /// @brief - the betas of the correlators and EFPs without repetitions, each theta matrix is built once
+        std::vector<double> _betas;
+        /// @brief - the loops over the distance matrices, at the SIMD level of the CPU
+        const SimdKernels* _kernels;
+
+        /// @brief - fills the arrays of the constituents (without the ghosts of the area and of the truth particles) and the distance matrix
+        void fillConstituents(const fastjet::PseudoJet& jet, Workspace& workspace) const;
+
+        /// @brief - computes all the features of the jet
+        void evaluateJet(const fastjet::PseudoJet& jet, Workspace& workspace, double* features) const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @headerfile - Cambridge/Aachen declustering of the jets: primary Lund plane and SoftDrop grooming.
+ *               The constituents of a jet are reclustered once with C/A. The primary branch is then followed
+ *               from the full jet, always into the harder (higher pt) of the two parents, and each step is one
+ *               splitting of the primary Lund plane:
+ *                   delta = deltaR(harder, softer),  kt = pt_softer * delta,  z = pt_softer / (pt_harder + pt_softer),
+ *                   psi = azimuth of the softer branch around the harder one in the (rapidity, phi) plane
+ *               The splittings go from the widest angle to the narrowest one. SoftDrop needs no other clustering:
+ *               the groomed jet is the first node of the primary branch whose splitting has z > z_cut * (delta / R)^beta,
+ *               so all the (beta, z_cut) settings are evaluated over the same splittings.
+ **/
+
+#ifndef JET_SUBSTRUCTURE_H
+#define JET_SUBSTRUCTURE_H
+
+#include <vector>
+#include <string>
+#include "fastjet/PseudoJet.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/JetDefinition.hh"
+
+
+/**
+ * @brief - parameters of the SoftDrop condition z > z_cut * (delta / R)^beta
+ **/
+struct SoftDropSettings {
+    double beta = 0.;
+    double z_cut = 0.1;
+};
+
+/**
+ * @brief - one splitting of the primary Lund plane
+ **/
+struct LundSplitting {
+    /// @brief - the Lund plane coordinates
+    double ln_one_over_delta;
+    double ln_kt;
+    double z;
+    double psi;
+    /// @brief - opening angle and relative transverse momentum of the splitting
+    double delta;
+    double kt;
+};
+
+/**
+ * @brief - SoftDrop observables of a jet for one (beta, z_cut) setting
+ **/
+struct SoftDropResult {
+    /// @brief - momentum fraction and opening angle of the first splitting that passes (0 if none passes)
+    double z_g;
+    double r_g;
+    /// @brief - number of splittings of the primary branch that pass the condition
+    int n_sd;
+    /// @brief - position of the groomed jet in the primary branch
+    int groomed_index;
+};
+
+/**
+ * @class - declusters the jets one at a time. The constituents, splittings and primary branch are members
+ *          reused for every jet, so they only allocate until they fit the largest jet.
+ **/
+class JetDeclustering {
+
+    public:
+        /// @param jet_radius - radius R of the jets, which normalises the angles of the SoftDrop condition
+        /// @param softdrop_settings - the (beta, z_cut) settings evaluated for each jet
+        JetDeclustering(double jet_radius, const std::vector<SoftDropSettings>& softdrop_settings);
+
+        /// @brief - reclusters the constituents of the jet (without the ghosts of the area and of the truth particles) with C/A and declusters the primary branch
+        /// @return - false if the jet has no constituents
+        bool decluster(const fastjet::PseudoJet& jet);
+
+        /// @brief - splittings of the primary branch of the last jet, from the widest angle on
+        const std::vector<LundSplitting>& primaryLundPlane() const {return _splittings;};
+
+        /// @brief - SoftDrop observables of the last jet, in the order of the settings
+        const std::vector<SoftDropResult>& softDrop() const {return _softdrop_results;};
+
+        /// @brief - groomed jet of the last jet for the setting (the last node of the primary branch, a single constituent, if no splitting passes)
+        const fastjet::PseudoJet& groomedJet(int setting) const {return _primary_branch[_softdrop_results[setting].groomed_index];};
+
+        const std::vector<SoftDropSettings>& softDropSettings() const {return _softdrop_settings;};
+        double jetRadius() const {return _jet_radius;};
+
+        /// @brief - description of the settings, e.g. "beta=0 zcut=0.1"
+        static std::string description(const SoftDropSettings& settings);
+
+    private:
+        double _jet_radius;
+        std::vector<SoftDropSettings> _softdrop_settings;
+        /// @brief - C/A with a radius large enough to merge all the constituents in a single jet
+        fastjet::JetDefinition _ca_definition;
+        fastjet::ClusterSequence _cluster_seq;
+
+        /// @brief - buffers of the current jet
+        std::vector<fastjet::PseudoJet> _constituents;
+        /// @brief - nodes of the primary branch: the full C/A jet, then the harder parent of each splitting
+        std::vector<fastjet::PseudoJet> _primary_branch;
+        std::vector<LundSplitting> _splittings;
+        std::vector<SoftDropResult> _softdrop_results;
+
+        /// @brief - evaluates the SoftDrop settings over the splittings of the primary branch
+        void groom();
+};
+
+#endif
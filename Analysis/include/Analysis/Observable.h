@@ -10,14 +10,24 @@
 #include <vector>
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/FourVector.h"
+#include "Analysis/EtaPhiGrid.h"
 
 
 class Observable {
     public:
+        virtual ~Observable() {};
+
         /// @brief evaluates the observable for a set of hepmc3 particles
         /// @param particles - vector with the particles
         /// @return - the value of the observable
         virtual double evaluateObservable(const std::vector<HepMC3::ConstGenParticlePtr>& particles) const = 0;
+
+        /// @brief evaluates the observable with the eta-phi grid built from the same particles
+        ///        (the observables with neighbourhood queries use it, the others ignore it)
+        /// @param grid - grid built from the particles, in the same order
+        virtual double evaluateObservableOnGrid(const std::vector<HepMC3::ConstGenParticlePtr>& particles, const EtaPhiGrid& grid) const {
+            return evaluateObservable(particles);
+        };
 };
 
 /// @brief - computes the invarian mass of a vector of particles
@@ -26,5 +36,18 @@ class InvariantMass: public Observable {
         double evaluateObservable(const std::vector<HepMC3::ConstGenParticlePtr>& particles) const;
 };
 
+/// @brief - density of particles around the leading (highest pT) particle: number of the other particles
+///          with deltaR < radius in (eta, phi), divided by the area pi * radius^2 of the cone
+class LeadingParticleDensity: public Observable {
+    public:
+        LeadingParticleDensity(double radius): _radius(radius) {};
+
+        double evaluateObservable(const std::vector<HepMC3::ConstGenParticlePtr>& particles) const;
+        double evaluateObservableOnGrid(const std::vector<HepMC3::ConstGenParticlePtr>& particles, const EtaPhiGrid& grid) const;
+
+    private:
+        double _radius;
+};
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+ * @headerfile - compile-time table with the properties of the particles given their PID.
+ *               For each PID it stores the electric charge, the type of the particle (quark, lepton, meson, baryon, ...),
+ *               its heavy-flavour content and the species class used by ALICE for the identified tracks.
+ *               The table is a dense array indexed by the last four digits of |PID| (n_q1 n_q2 n_q3 n_J),
+ *               so the lookup is a single array access. The radial and orbital digits (n_r, n_L) do not change
+ *               the charge nor the quark content, so excited states share the entry of their ground state. The species
+ *               is the exception: it only applies to the ground states themselves (|PID| below 10000), so e.g. the
+ *               b1(1235)+ (10213) or the K1(1270)+ (10323) are not taken as pions or kaons.
+ *               Analysis/examples/write_pid_table.cpp writes the same table for the Python side (Preprocessing/pid_table.py).
+ **/
+
+#ifndef PARTICLE_PROPERTIES_H
+#define PARTICLE_PROPERTIES_H
+
+#include <array>
+#include <cstdint>
+
+namespace ParticleProperties {
+
+    /// @brief - species of the charged particles identified by ALICE
+    enum ParticleSpecies: std::uint8_t {OtherSpecies = 0, Electron, Muon, Pion, Kaon, Proton};
+
+    /// @brief - flags describing the type and the quark content of the particle
+    enum ParticleFlags: std::uint16_t {
+        Known = 1 << 0, Quark = 1 << 1, Lepton = 1 << 2, GaugeBoson = 1 << 3,
+        Meson = 1 << 4, Baryon = 1 << 5, Diquark = 1 << 6, Charm = 1 << 7, Bottom = 1 << 8
+    };
+
+    /// @brief - properties of the particle (the antiparticle has the opposite charge)
+    struct PIDInfo {
+        /// three times the electric charge of the particle
+        std::int8_t charge3;
+        /// ALICE species class
+        std::uint8_t species;
+        /// combination of ParticleFlags
+        std::uint16_t flags;
+    };
+
+    /// @brief - number of entries in the table: last four digits of the PID
+    constexpr int table_size = 10000;
+
+    /// @brief - three times the charge of the quarks d, u, s, c, b, t
+    constexpr std::array<int, 7> quark_charge3 = {0, -1, 2, -1, 2, -1, 2};
+
+    /// @brief - builds the entry of the table for the (positive) PID code
+    constexpr PIDInfo buildEntry(int code) {
+        PIDInfo entry {0, OtherSpecies, 0};
+        const int nq1 = (code / 1000) % 10, nq2 = (code / 100) % 10, nq3 = (code / 10) % 10, nJ = code % 10;
+        // heavy-flavour content from the quark digits
+        std::uint16_t flavour = 0;
+        for (int nq: {nq1, nq2, nq3}) {
+            if (nq == 4) flavour |= Charm;
+            if (nq == 5) flavour |= Bottom;
+        }
+
+        if (code >= 1 && code <= 6) {
+            // quarks
+            entry.charge3 = quark_charge3[code];
+            entry.flags = Known | Quark | (code == 4 ? Charm : 0) | (code == 5 ? Bottom : 0);
+        }
+        else if (code >= 11 && code <= 16) {
+            // charged leptons have odd codes, neutrinos even codes
+            entry.charge3 = (code % 2 == 1) ? -3 : 0;
+            entry.flags = Known | Lepton;
+        }
+        else if (code >= 21 && code <= 25) {
+            // gluon, photon, Z, W+ and higgs
+            entry.charge3 = (code == 24) ? 3 : 0;
+            entry.flags = Known | GaugeBoson;
+        }
+        else if (code == 130 || code == 310) {
+            // K0_L and K0_S do not follow the numbering scheme
+            entry.flags = Known | Meson;
+        }
+        else if (nq1 == 0 && nq2 >= 1 && nq2 <= 5 && nq3 >= 1 && nq3 <= nq2 && nJ % 2 == 1) {
+            // mesons - the heavier quark is an antiquark when it is down-type
+            entry.charge3 = (nq2 == 3 || nq2 == 5) ? quark_charge3[nq3] - quark_charge3[nq2] : quark_charge3[nq2] - quark_charge3[nq3];
+            entry.flags = Known | Meson | flavour;
+        }
+        else if (nq1 >= 1 && nq1 <= 5 && nq2 >= 1 && nq2 <= nq1 && nq3 >= 1 && nq3 <= nq1 && nJ > 0 && nJ % 2 == 0) {
+            // baryons
+            entry.charge3 = quark_charge3[nq1] + quark_charge3[nq2] + quark_charge3[nq3];
+            entry.flags = Known | Baryon | flavour;
+        }
+        else if (nq1 >= 1 && nq1 <= 5 && nq2 >= 1 && nq2 <= nq1 && nq3 == 0 && nJ % 2 == 1) {
+            // diquarks
+            entry.charge3 = quark_charge3[nq1] + quark_charge3[nq2];
+            entry.flags = Known | Diquark | flavour;
+        }
+
+        // species identified by ALICE
+        switch (code) {
+            case 11: entry.species = Electron; break;
+            case 13: entry.species = Muon; break;
+            case 211: entry.species = Pion; break;
+            case 321: entry.species = Kaon; break;
+            case 2212: entry.species = Proton; break;
+        }
+        return entry;
+    }
+
+    /// @brief - builds the full table at compile time
+    constexpr std::array<PIDInfo, table_size> buildTable() {
+        std::array<PIDInfo, table_size> table {};
+        for (int code = 0; code < table_size; code++)
+            table[code] = buildEntry(code);
+        return table;
+    }
+
+    /// @brief - the PID property table (entry 0 is the unknown particle)
+    inline constexpr std::array<PIDInfo, table_size> pid_table = buildTable();
+
+    /// @brief - position of the PID in the table (0 for PIDs outside the hadron numbering scheme, e.g. nuclei or BSM)
+    constexpr int tableIndex(int pid) {
+        const int abs_pid = pid < 0 ? -pid : pid;
+        return abs_pid < 1000000 ? abs_pid % table_size : 0;
+    }
+
+    /// @brief - returns the properties of the particle
+    constexpr const PIDInfo& info(int pid) {return pid_table[tableIndex(pid)];}
+
+    /// @brief - three times the electric charge of the particle
+    constexpr int charge3(int pid) {return pid < 0 ? -info(pid).charge3 : info(pid).charge3;}
+
+    /// @brief - electric charge of the particle
+    constexpr double charge(int pid) {return charge3(pid) / 3.;}
+
+    constexpr bool isCharged(int pid) {return info(pid).charge3 != 0;}
+    constexpr bool isKnown(int pid) {return info(pid).flags & Known;}
+    constexpr bool isMeson(int pid) {return info(pid).flags & Meson;}
+    constexpr bool isBaryon(int pid) {return info(pid).flags & Baryon;}
+    constexpr bool isHadron(int pid) {return info(pid).flags & (Meson | Baryon);}
+    constexpr bool hasCharm(int pid) {return info(pid).flags & Charm;}
+    constexpr bool hasBottom(int pid) {return info(pid).flags & Bottom;}
+    constexpr bool isHeavyFlavourHadron(int pid) {return isHadron(pid) && (info(pid).flags & (Charm | Bottom));}
+
+    /// @brief - ALICE species class of the particle (only the ground states, the excited states are OtherSpecies)
+    constexpr ParticleSpecies species(int pid) {
+        return (pid < 0 ? -pid : pid) < table_size ? static_cast<ParticleSpecies>(info(pid).species) : OtherSpecies;
+    }
+
+    /// @brief - true for the long-lived charged species that are reconstructed as tracks (e, mu, pi, K, p)
+    constexpr bool isTrackSpecies(int pid) {return species(pid) != OtherSpecies;}
+
+    // sanity checks on the numbering scheme
+    static_assert(charge3(211) == 3 && charge3(-211) == -3 && charge3(111) == 0, "pion charges");
+    static_assert(charge3(321) == 3 && charge3(310) == 0 && charge3(130) == 0 && isMeson(310) && isMeson(130), "kaon charges");
+    static_assert(charge3(411) == 3 && charge3(421) == 0 && charge3(431) == 3 && charge3(10411) == 3, "D meson charges");
+    static_assert(charge3(511) == 0 && charge3(521) == 3 && charge3(531) == 0, "B meson charges");
+    static_assert(charge3(2212) == 3 && charge3(2112) == 0 && charge3(3122) == 0 && charge3(3334) == -3, "baryon charges");
+    static_assert(charge3(4122) == 3 && charge3(5122) == 0 && charge3(2203) == 4 && charge3(11) == -3, "charges");
+    static_assert(hasCharm(-421) && hasBottom(5122) && !hasCharm(321) && isHeavyFlavourHadron(443), "heavy flavour");
+    static_assert(species(-2212) == Proton && isTrackSpecies(-11) && !isTrackSpecies(3112) && !isKnown(1000022), "species");
+    static_assert(species(211) == Pion && species(321) == Kaon && charge3(10211) == 3 && !isTrackSpecies(10211) && !isTrackSpecies(-100211)
+                  && !isTrackSpecies(10321) && !isTrackSpecies(20213), "excited states are not track species");
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <vector>
 #include <set>
 #include "HepMC3/GenParticle.h"
+#include "Analysis/ParticleProperties.h"
 
 
 /** 
@@ -20,6 +21,8 @@
 **/
 class ParticleSelector {
     public:
+        virtual ~ParticleSelector() {};
+
         /// @brief - Indicates wether the particle must be selected or not.
         /// @param particle - pointer to the HepMC3::GenParticle object.
         /// @return - True if the particle must be selected, false otherwise.
@@ -75,15 +78,24 @@ class OutgoingParticlesFromHardProcess: public StatusCodeSelection {
 class ChargedParticlesSelector: public ParticleSelector {
     public:
         /// we do not have information about the charge, but since we have the PID
-        /// we can only accept particles with PIDs corresponding to charged particles
+        /// we accept the charged species reconstructed as tracks (e, mu, pi, K, p) from the PID table
         bool selectParticle(HepMC3::ConstGenParticlePtr particle) const override;
 
         /// @brief - adds a new pid to the list 
-        void addPID(int pid) {_charged_part_pids.insert(pid);};
+        void addPID(int pid) {_extra_charged_part_pids.insert(pid);};
 
     private:
-        /// stores the absolute value of the PIDs of charged particles
-        std::set<int> _charged_part_pids = {11, 13, 211, 321, 2212};
+        /// stores the absolute value of the PIDs of additional charged particles
+        std::set<int> _extra_charged_part_pids;
+};
+
+/**
+ * @class - selects the heavy-flavour hadrons that decay weakly: the b (c) hadrons without a b (c) hadron among
+ *          their decay products, i.e. the last hadron of each heavy quark, used to label the jets
+ **/
+class HeavyFlavourHadronSelector: public ParticleSelector {
+    public:
+        bool selectParticle(HepMC3::ConstGenParticlePtr particle) const override;
 };
 
 /**
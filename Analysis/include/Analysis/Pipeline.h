@@ -0,0 +1,374 @@
+/**
+ * @headerfile - single-pass analysis pipeline driven by a config file.
+ *               Each input file is read once and every event is fanned out to all the output sinks
+ *               (CSV of the particles from the hard process, jets, raw particle dumps, ...).
+ *               The config is parsed once at startup: the selectors, observables, clusterings and sinks are
+ *               built and resolved to pointers and indices, so the event loop does no string lookups.
+ *
+ *               The config has one "keyword arguments" entry per line ('#' starts a comment):
+ *                   input <hepmc file>                                  (one line per file, .gz / .zst are found too, .skim files are read as skims)
+ *                   output_dir <directory>
+ *                   shard <i/N>                     block_size <B>      async_output <0|1>
+ *                   overlay <soft hepmc file | .pool cache> <background events per event> <pool size> [seed]
+ *                   detector <response file> [seed]
+ *                   select <final|initial|hard> <final_state|charged|status N> ...   (all must pass)
+ *                   cut <q2_window min max | initial_parton pid ... | leading_charged_pt min | charged_multiplicity min [max]>
+ *                   observable <name> invariant_mass <source>
+ *                   jets <name> <antikt|kt|cambridge> <R> <min pt> <source> [grid|ktmedian] [truth]
+ *                   sink particles <suffix> <source> <q2 observable> <max particles> [detector]
+ *                   sink jets <suffix> <jets name> <max jets>
+ *                   sink substructure <suffix> <jets name> <max jets> <max splittings> [<beta> <z_cut>] ...   (SoftDrop beta = 0, z_cut = 0.1 by default)
+ *                   sink jet_observables <suffix> <jets name> <max jets> [angularity <kappa> <beta> | ecf <beta> | efp <beta> <max degree>] ...
+ *                   sink raw <suffix> <source>
+ *               where a source is one of final, initial, hard or signal (the final state particles from the
+ *               hard process found by the SignalParticlesSearcher, with the final selection).
+ *               With truth, the jets are labelled b, c, light or gluon from the hard particles and the weakly decaying
+ *               heavy-flavour hadrons clustered as ghosts (see JetClustering.h); the jets sink then writes the label of each jet.
+ *               With overlay, the background events are added to each event before the cuts and the selection
+ *               (see UnderlyingEventOverlay.h); the raw sink then writes a background flag for each particle.
+ *               With detector, the particles sink writes the tracks of the parametric detector response (efficiency and
+ *               smearing, see DetectorResponse.h) instead of the particles, in the same columns.
+ *               The output of a sink is <output_dir>/<sample>_<suffix>[_shard_i_of_N].csv, where the sample is
+ *               the name of the input file without the directory and the extensions. The instrumentation summary
+ *               goes to <output_dir>/<sample>_stats[_shard_i_of_N].json.
+ **/
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include "Analysis/ParticleSelector.h"
+#include "Analysis/Observable.h"
+#include "Analysis/EventCut.h"
+#include "Analysis/EventAnalyzer.h"
+#include "Analysis/SignalParticlesSearcher.h"
+#include "Analysis/JetClustering.h"
+#include "Analysis/JetSubstructure.h"
+#include "Analysis/JetObservables.h"
+#include "Analysis/CSVWriter.h"
+#include "Analysis/FileWriter.h"
+#include "Analysis/EventSharding.h"
+#include "Analysis/HepMCInput.h"
+#include "Analysis/Instrumentation.h"
+#include "Analysis/SkimFormat.h"
+#include "Analysis/UnderlyingEventOverlay.h"
+#include "Analysis/DetectorResponse.h"
+#include "HepMC3/ReaderAscii.h"
+#include "HepMC3/GenEvent.h"
+
+/// @brief - particles that the observables, clusterings and sinks can use
+enum ParticleSource {FinalSource, InitialSource, HardSource, SignalSource};
+
+/**
+ * @brief - one line of the config, split in words
+ **/
+struct ConfigEntry {
+    int line;
+    std::vector<std::string> words;
+};
+
+/**
+ * @class - contents of the config file
+ **/
+class PipelineConfig {
+    public:
+        /// @brief - reads the config file
+        /// @return - false if the file could not be read or has an unknown keyword (the problem is printed)
+        static bool read(const std::string& filename, PipelineConfig& config);
+
+        std::vector<std::string> inputs;
+        std::string output_dir = ".";
+        ShardSpec shard;
+        long block_size = 1000;
+        bool async_output = false;
+        /// @brief - the entries that define the analysis (select, cut, observable, jets and sink), in order
+        std::vector<ConfigEntry> entries;
+};
+
+/**
+ * @class - everything computed for the current event, shared by all the sinks
+ **/
+class PipelineEvent {
+    public:
+        /// @brief - particles of the source
+        const std::vector<HepMC3::ConstGenParticlePtr>& particles(ParticleSource source) const {return *_particles[source];};
+
+        /// @brief - true if the particle was added by the overlay of the background events
+        bool isBackground(const HepMC3::ConstGenParticlePtr& particle) const {return particle->id() >= _first_background_id;};
+
+        /// @brief - tracks of the detector response of the source (only for the sources of the sinks with detector)
+        const DetectorTracks& tracks(ParticleSource source) const {return _tracks[source];};
+
+        /// @brief - absolute value of the pid of the leading initial particle (0 if there is none)
+        int initialPid() const {return _particles[InitialSource]->empty() ? 0 : _particles[InitialSource]->at(0)->abs_pid();};
+
+        /// @brief - position of the event in the file
+        long event_index = 0;
+        /// @brief - values of the observables and jets of the clusterings, in the order of the config
+        std::vector<double> observables;
+        std::vector<std::vector<fastjet::PseudoJet>> jets;
+        /// @brief - truth labels of the jets of the clusterings with truth
+        std::vector<std::vector<JetFlavourInfo>> jet_flavours;
+
+    private:
+        friend class PipelineRunner;
+        const std::vector<HepMC3::ConstGenParticlePtr>* _particles[4] = {nullptr, nullptr, nullptr, nullptr};
+        /// @brief - id of the first background particle (no particle is background without overlay)
+        int _first_background_id = std::numeric_limits<int>::max();
+        DetectorTracks _tracks[4];
+};
+
+/**
+ * @class - Declaration of the EventSink interface - receives every event that passed the cuts
+ **/
+class EventSink {
+    public:
+        virtual ~EventSink() {};
+
+        /// @brief - writes the event
+        virtual void writeEvent(const PipelineEvent& event) = 0;
+
+        /// @brief - writes everything left and closes the output
+        /// @return - false if any write failed
+        virtual bool close() = 0;
+
+        /// @brief - name of the output file and number of bytes written
+        virtual const std::string& filename() const = 0;
+        virtual std::uint64_t bytesWritten() const = 0;
+};
+
+/**
+ * @class - the particles of a source in the layout of select_hepmc_particles (q2, initial pid, pt, eta, phi, pid, ...),
+ *          or the tracks of the detector response of the source in the same layout
+ **/
+class ParticlesSink: public EventSink {
+    public:
+        ParticlesSink(const std::string& filename, ParticleSource source, int q2_index, int max_number_particles, bool detector, bool async_output):
+            _filename(filename), _source(source), _q2_index(q2_index), _detector(detector), _csvfile(filename, max_number_particles, async_output) {};
+
+        void writeEvent(const PipelineEvent& event) override {
+            if (_detector)
+                _csvfile.writeEvent(event.observables[_q2_index], event.initialPid(), event.tracks(_source));
+            else
+                _csvfile.writeEvent(event.observables[_q2_index], event.initialPid(), event.particles(_source));
+        };
+        bool close() override {return _csvfile.close();};
+        const std::string& filename() const override {return _filename;};
+        std::uint64_t bytesWritten() const override {return _csvfile.bytesWritten();};
+
+    private:
+        std::string _filename;
+        ParticleSource _source;
+        int _q2_index;
+        bool _detector;
+        CSVWriter _csvfile;
+};
+
+/**
+ * @class - the jets of a clustering: number of jets, then (pt, eta, phi, m, number of constituents) of each jet,
+ *          followed by the truth flavour (0, 1, 4, 5 or 21, see JetFlavour) if the clustering labels the jets,
+ *          zero padded up to the maximum number of jets
+ **/
+class JetsSink: public EventSink {
+    public:
+        JetsSink(const std::string& filename, int jets_index, int max_number_jets, bool with_flavour, bool async_output):
+            _filename(filename), _jets_index(jets_index), _max_number_jets(max_number_jets), _with_flavour(with_flavour), _output_file(filename, async_output) {};
+
+        void writeEvent(const PipelineEvent& event) override;
+        bool close() override {return _output_file.close();};
+        const std::string& filename() const override {return _filename;};
+        std::uint64_t bytesWritten() const override {return _output_file.bytesWritten();};
+
+    private:
+        std::string _filename;
+        int _jets_index;
+        int _max_number_jets;
+        bool _with_flavour;
+        FileWriter _output_file;
+        /// @brief - the line is formatted here (the memory is reused in every event)
+        std::string _line;
+};
+
+/**
+ * @class - substructure of the jets of a clustering (see JetSubstructure.h): number of jets, then for each jet
+ *          pt, number of primary splittings, (z_g, R_g, groomed mass) of each SoftDrop setting and
+ *          (ln 1/delta, ln kt, z, psi) of the first splittings. The splittings are zero padded up to the maximum
+ *          number of splittings and the jets up to the maximum number of jets, so every line has the same length.
+ **/
+class SubstructureSink: public EventSink {
+    public:
+        SubstructureSink(const std::string& filename, int jets_index, int max_number_jets, int max_number_splittings,
+                         double jet_radius, const std::vector<SoftDropSettings>& softdrop_settings, bool async_output):
+            _filename(filename), _jets_index(jets_index), _max_number_jets(max_number_jets), _max_number_splittings(max_number_splittings),
+            _declustering(jet_radius, softdrop_settings), _output_file(filename, async_output) {};
+
+        void writeEvent(const PipelineEvent& event) override;
+        bool close() override {return _output_file.close();};
+        const std::string& filename() const override {return _filename;};
+        std::uint64_t bytesWritten() const override {return _output_file.bytesWritten();};
+
+    private:
+        std::string _filename;
+        int _jets_index;
+        int _max_number_jets;
+        int _max_number_splittings;
+        JetDeclustering _declustering;
+        FileWriter _output_file;
+        std::string _line;
+};
+
+/**
+ * @class - jet shape observables of the jets of a clustering (see JetObservables.h): number of jets, then the pt and the
+ *          features of each jet, zero padded up to the maximum number of jets
+ **/
+class JetObservablesSink: public EventSink {
+    public:
+        JetObservablesSink(const std::string& filename, int jets_index, int max_number_jets, const JetObservableSettings& settings, bool async_output):
+            _filename(filename), _jets_index(jets_index), _max_number_jets(max_number_jets), _calculator(settings),
+            _features(_calculator.numberFeatures()), _output_file(filename, async_output) {};
+
+        void writeEvent(const PipelineEvent& event) override;
+        bool close() override {return _output_file.close();};
+        const std::string& filename() const override {return _filename;};
+        std::uint64_t bytesWritten() const override {return _output_file.bytesWritten();};
+
+    private:
+        std::string _filename;
+        int _jets_index;
+        int _max_number_jets;
+        JetObservableCalculator _calculator;
+        std::vector<double> _features;
+        FileWriter _output_file;
+        std::string _line;
+};
+
+/**
+ * @class - all the particles of a source without padding: event index, number of particles, then (pt, eta, phi, pid)
+ *          and, with the overlay, (pt, eta, phi, pid, background) with background 1 for the particles of the background events
+ **/
+class RawParticlesSink: public EventSink {
+    public:
+        RawParticlesSink(const std::string& filename, ParticleSource source, bool with_background, bool async_output):
+            _filename(filename), _source(source), _with_background(with_background), _output_file(filename, async_output) {};
+
+        void writeEvent(const PipelineEvent& event) override;
+        bool close() override {return _output_file.close();};
+        const std::string& filename() const override {return _filename;};
+        std::uint64_t bytesWritten() const override {return _output_file.bytesWritten();};
+
+    private:
+        std::string _filename;
+        ParticleSource _source;
+        bool _with_background;
+        FileWriter _output_file;
+        std::string _line;
+};
+
+/**
+ * @class - builds the analysis from the config and runs it over the input files
+ **/
+class PipelineRunner {
+    public:
+        /// @brief - builds the selectors, cuts, observables and clusterings (the sinks are opened for each input)
+        PipelineRunner(const PipelineConfig& config);
+
+        /// @brief - false if the config could not be resolved (the problem is printed)
+        bool configured() const {return _configured;};
+
+        /// @brief - runs the analysis over one input file, writing all the sinks
+        /// @return - false if the input could not be read or an output could not be written
+        bool run(const std::string& input_filename);
+
+        /// @brief - runs the analysis over all the inputs of the config
+        bool runAll();
+
+        /// @brief - name of the sample of an input file (file name without the directory and the extensions)
+        static std::string sampleName(const std::string& input_filename);
+
+    private:
+        /// @brief - how to build each sink once the output file name is known
+        struct SinkDefinition {
+            std::string type;
+            std::string suffix;
+            ParticleSource source;
+            /// @brief - index of the observable (particles) or of the clustering (jets and substructure)
+            int index;
+            int max_number;
+            /// @brief - maximum number of splittings, radius of the jets and SoftDrop settings (substructure)
+            int max_splittings = 0;
+            double jet_radius = 0.;
+            std::vector<SoftDropSettings> softdrop_settings;
+            /// @brief - the features of the jets (jet_observables)
+            JetObservableSettings jet_observables;
+            /// @brief - true to write the tracks of the detector response (particles)
+            bool detector = false;
+        };
+        /// @brief - clustering and the particles it uses
+        struct ClusteringDefinition {
+            std::unique_ptr<JetClustering> clustering;
+            ParticleSource source;
+            /// @brief - true if the jets are labelled with the truth particles
+            bool truth = false;
+        };
+        /// @brief - observable and the particles it uses
+        struct ObservableDefinition {
+            const Observable* observable;
+            ParticleSource source;
+        };
+
+        PipelineConfig _config;
+        bool _configured = true;
+
+        EventAnalyzer _event_analyzer;
+        std::vector<std::unique_ptr<ParticleSelector>> _selectors;
+        std::vector<std::unique_ptr<EventCut>> _cuts;
+        std::vector<std::unique_ptr<Observable>> _observable_storage;
+        std::vector<ObservableDefinition> _observables;
+        std::vector<std::string> _observable_names;
+        std::vector<ClusteringDefinition> _clusterings;
+        std::vector<std::string> _clustering_names;
+        std::vector<SinkDefinition> _sink_definitions;
+        /// @brief - selector of the final particles, also used by the search of the signal particles
+        const ParticleSelector* _final_selector = nullptr;
+        std::unique_ptr<SignalParticlesSearcher> _signal_particle_searcher;
+        /// @brief - true if any observable, clustering or sink uses the signal particles
+        bool _needs_signal = false;
+        /// @brief - true if any clustering labels its jets, and the hard particles and heavy-flavour hadrons of the event
+        bool _needs_truth = false;
+        std::vector<HepMC3::ConstGenParticlePtr> _truth_particles;
+        /// @brief - the background events, read once for all the inputs, and their overlay (nullptr without overlay)
+        std::unique_ptr<BackgroundPool> _background_pool;
+        std::unique_ptr<UnderlyingEventOverlay> _overlay;
+        /// @brief - the parametric detector response and the sources that need its tracks
+        std::unique_ptr<DetectorResponse> _detector_response;
+        bool _needs_tracks[4] = {false, false, false, false};
+
+        /// @brief - builds the object of each entry of the config
+        bool addOverlay(const ConfigEntry& entry);
+        bool addDetector(const ConfigEntry& entry);
+        bool addSelection(const ConfigEntry& entry);
+        bool addCut(const ConfigEntry& entry);
+        bool addObservable(const ConfigEntry& entry);
+        bool addClustering(const ConfigEntry& entry);
+        bool addSink(const ConfigEntry& entry);
+
+        /// @brief - reads the source name, recording whether the signal particles are needed
+        bool parseSource(const std::string& name, ParticleSource& source);
+
+        /// @brief - prints the problem with the entry and marks the config as invalid
+        bool configError(const ConfigEntry& entry, const std::string& message);
+
+        /// @brief - name of the output of a sink for the sample
+        std::string outputFilename(const std::string& sample, const std::string& suffix, const std::string& extension = ".csv") const;
+};
+
+#endif
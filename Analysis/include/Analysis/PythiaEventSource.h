@@ -0,0 +1,64 @@
+/**
+ * @headerfile - generates events with Pythia and converts them to HepMC3 in memory, so the analysis runs on
+ *               the generated events without writing and parsing the HepMC3 text files.
+ *               The settings of the samples and the seeds of the shards are in Simulations/ProcessSettings.h,
+ *               so a source with the seed of shard i produces the same events as the file of shard i of generate_events.
+ *               The cuts of the GenerationFilter (Simulations/GenerationFilter.h) are applied to the Pythia event record,
+ *               so the rejected events are not converted.
+ **/
+
+#ifndef PYTHIA_EVENT_SOURCE_H
+#define PYTHIA_EVENT_SOURCE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Pythia8/Pythia.h"
+#include "Pythia8Plugins/HepMC3.h"
+#include "HepMC3/GenEvent.h"
+#include "GenerationFilter.h"
+
+/**
+ * @class - one Pythia instance filling GenEvents
+ **/
+class PythiaEventSource {
+    public:
+        /// @param settings - Pythia settings of the sample
+        /// @param seed - seed of the Pythia random numbers (1 to 900000000)
+        /// @param filter_settings - cuts the events must pass (none by default)
+        PythiaEventSource(const std::vector<std::string>& settings, long seed, const GenerationFilterSettings& filter_settings = GenerationFilterSettings());
+
+        /// @brief - initializes Pythia (the initialization of the sources of different threads is done one at a time)
+        /// @return - false if Pythia could not be initialized
+        bool initialize();
+
+        /// @brief - generates events until one passes the filter and fills the GenEvent with it (the event is cleared first)
+        /// @return - false if Pythia failed too many times in a row or the filter accepted none of the first events
+        bool nextEvent(HepMC3::GenEvent& hepmc_event);
+
+        /// @brief - number of events given and of events Pythia failed to generate
+        long generatedEvents() const {return _generated_events;};
+        long failedEvents() const {return _failed_events;};
+
+        /// @brief - events generated by Pythia and tested by the filter, and the fraction that was accepted
+        long testedEvents() const {return _filter.testedEvents();};
+        double filterEfficiency() const {return _filter.efficiency();};
+
+        /// @brief - estimate of the cross section and its error [mb]
+        double sigmaGen() const {return _pythia.info.sigmaGen();};
+        double sigmaErr() const {return _pythia.info.sigmaErr();};
+
+        /// @brief - number of consecutive failures after which nextEvent gives up
+        static const int max_consecutive_failures = 100;
+        /// @brief - number of events rejected by the filter, with none accepted, after which nextEvent gives up
+        static const long max_rejected_events = 10000;
+
+    private:
+        Pythia8::Pythia _pythia;
+        HepMC3::Pythia8ToHepMC3 _to_hepmc;
+        GenerationFilter _filter;
+        long _generated_events = 0;
+        long _failed_events = 0;
+};
+
+#endif
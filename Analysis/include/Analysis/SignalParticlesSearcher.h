@@ -4,7 +4,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include <set>
+#include <cstdint>
 #include "HepMC3/GenParticle.h"
 #include "HepMC3/GenVertex.h"
 #include "Analysis/ParticleSelector.h"
@@ -24,13 +24,21 @@ class SignalParticlesSearcher {
     private:
         /// @brief - fills the final_particles vector by recursively looking to the decay product of the particle
         /// @param incomming_particle 
-        void searchParticles (HepMC3::ConstGenParticlePtr incomming_particle);
+        void searchParticles (const HepMC3::ConstGenParticlePtr& incomming_particle);
+
+        /// @brief - marks the entry of the particle or vertex as visited in the current search
+        /// @return - false if it was already visited
+        bool markVisited (std::vector<std::uint32_t>& visited, int index);
 
         /// @brief - specifies how the criterias the end particles must fullfilled
         const ParticleSelector* _selector;  
 
-        /// @brief - stores the vertices to avoid lookup repetition
-        std::set<HepMC3::ConstGenVertexPtr> _vertices; 
+        /// @brief - search in which each vertex (index -id - 1) and each particle (index id - 1) was last visited.
+        ///          Comparing with the current search number avoids both the lookup repetition and clearing
+        ///          the flags in every event, and the memory is reused across the events
+        std::vector<std::uint32_t> _visited_vertices;
+        std::vector<std::uint32_t> _visited_particles;
+        std::uint32_t _search_number = 0;
 
         /// @brief - stores the selected particles
         std::vector<HepMC3::ConstGenParticlePtr> _final_particles;
@@ -0,0 +1,64 @@
+/**
+ * @headerfile - the hot loops over flat arrays, built for several x86-64 levels in the same library:
+ *                   generic     the baseline of the compiler (SSE2 on x86-64, the only level on the other architectures)
+ *                   sse4.2      x86-64-v2 (SSE4.2, POPCNT)
+ *                   avx2        x86-64-v3 (AVX2, FMA)
+ *                   avx512      x86-64-v4 (AVX-512 F/CD/VL/DQ/BW, 512 bit vectors)
+ *               src/SimdKernelVariant.cpp is compiled once per level (with ANALYSIS_SIMD_DISPATCH, see the Makefile), each
+ *               copy fills the table of its level, and the first call to simdKernels() picks the best level the CPU and the
+ *               OS support (__builtin_cpu_supports). The environment variable ANALYSIS_SIMD_LEVEL=<level name> forces a
+ *               lower level, e.g. to compare the nodes or to time the levels.
+ *               The variants are compiled with -ffp-contract=off and the reductions have a fixed number of partial sums,
+ *               so all the levels give the same results to the last bit: the level only changes the speed.
+ *
+ *               The kernels:
+ *                   - pairwise deltaR^2 matrix and distances to an axis (jet observables);
+ *                   - dot products of two and three arrays (energy correlators and EFPs) and element-wise sqrt;
+ *                   - cone masks over contiguous particles (EtaPhiGrid): number and pT sum of the particles with deltaR < r.
+ *               phi is given in [0, 2pi) or (-pi, pi], deltaphi is wrapped with min(|dphi|, 2pi - |dphi|).
+ **/
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+
+enum SimdLevel {GenericSimd, SSE42Simd, AVX2Simd, AVX512Simd, NumberOfSimdLevels};
+
+/// @brief - name of the level, as given to ANALYSIS_SIMD_LEVEL
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief - the kernels of one level
+ **/
+struct SimdKernels {
+    SimdLevel level;
+
+    /// @brief - distance2[i * n + j] = deltaR^2 between i and j in (rap, phi)
+    void (*pairwise_distance2)(const double* rap, const double* phi, std::size_t n, double* distance2);
+
+    /// @brief - distance[i] = deltaR between i and the axis (axis_rap, axis_phi)
+    void (*axis_distance)(const double* rap, const double* phi, std::size_t n, double axis_rap, double axis_phi, double* distance);
+
+    /// @brief - sum_k x_k y_k and sum_k x_k y_k w_k
+    double (*dot2)(const double* x, const double* y, std::size_t n);
+    double (*dot3)(const double* x, const double* y, const double* w, std::size_t n);
+
+    /// @brief - y[k] = sqrt(x[k])
+    void (*sqrt_values)(const double* x, std::size_t n, double* y);
+
+    /// @brief - number and pT sum of the particles with deltaR^2 < r2 from (eta0, phi0)
+    int (*count_within)(const double* eta, const double* phi, std::size_t n, double eta0, double phi0, double r2);
+    double (*pt_within)(const double* eta, const double* phi, const double* pt, std::size_t n, double eta0, double phi0, double r2);
+};
+
+/// @brief - true if the level is built in the library and the CPU (and the OS) support it
+bool simdLevelSupported(SimdLevel level);
+
+/// @brief - the kernels of a supported level (the benchmarks compare the levels with it)
+const SimdKernels& simdKernels(SimdLevel level);
+
+/// @brief - the kernels of the best supported level, or of the level of ANALYSIS_SIMD_LEVEL (chosen once, at the first call)
+const SimdKernels& simdKernels();
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @headerfile - compact binary copy of a HepMC3 file for repeated analyses ("skim").
+ *               Only the particles the analysis uses are kept: the initial (status 21), hard process (status 23)
+ *               and final (status 1) particles. The decay graph is reduced to an ancestor mask for each final
+ *               particle, with bit h set if the particle comes from the h-th hard process particle (up to 32).
+ *
+ *               File layout (native byte order): the header "JMLSKIM" + '\0' and the version (uint32), then one record per event
+ *                   uint32 size of the rest of the record
+ *                   int32 event number, uint32 number of initial, hard and final particles
+ *                   int32 pid[n], float px[n], py[n], pz[n], e[n]      (n particles: initial, then hard, then final)
+ *                   uint32 ancestor mask[number of final particles]
+ *               Each column of the record is contiguous, so a record is read with a single fread.
+ *
+ *               SkimReader is a HepMC3::Reader: it rebuilds a reduced GenEvent that EventAnalyzer and SignalParticlesSearcher
+ *               use as the original one. Each hard particle with descendants ends in a vertex; the final particles with the same
+ *               mask come out of one vertex, joined to the vertex of each hard particle in the mask by a link particle
+ *               (status 2, pid 0, zero momentum). So the final particles reached from a hard particle are the same as in the original
+ *               event, and the final particles keep their order.
+ **/
+
+#ifndef SKIM_FORMAT_H
+#define SKIM_FORMAT_H
+
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <utility>
+#include "HepMC3/Reader.h"
+#include "HepMC3/Writer.h"
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+
+/// @brief - true if the file name has the .skim extension
+bool isSkimFilename(const std::string& filename);
+
+/**
+ * @class - writes the skim of the events
+ **/
+class SkimWriter: public HepMC3::Writer {
+    public:
+        SkimWriter(const std::string& filename);
+        ~SkimWriter();
+
+        /// @brief - writes the status 21, 23 and 1 particles of the event and the ancestor masks of the final particles
+        void write_event(const HepMC3::GenEvent& hepmc_event) override;
+
+        /// @brief - true if the file could not be opened or a write failed
+        bool failed() override {return _failed;};
+
+        void close() override;
+
+        /// @brief - number of bytes written to the file
+        std::uint64_t bytesWritten() const {return _bytes_written;};
+
+        static constexpr std::uint32_t version = 1;
+
+    private:
+        std::FILE* _file = nullptr;
+        bool _failed = false;
+        std::uint64_t _bytes_written = 0;
+        bool _warned_hard_particles = false;
+
+        /// @brief - the record is built here (the memory is reused in every event)
+        std::vector<char> _record;
+        std::vector<HepMC3::ConstGenParticlePtr> _initial, _hard, _final;
+        /// @brief - ancestor mask of each particle of the event (index id - 1) and the search that visited each vertex (index -id - 1)
+        std::vector<std::uint32_t> _masks;
+        std::vector<std::uint32_t> _visited_vertices;
+        std::uint32_t _search_number = 0;
+        std::vector<HepMC3::ConstGenVertexPtr> _vertices_to_visit;
+
+        /// @brief - sets the bit of the hard particle in the masks of all its descendants
+        void markDescendants(const HepMC3::ConstGenParticlePtr& hard_particle, std::uint32_t bit);
+
+        void append(const void* data, std::size_t size);
+};
+
+/**
+ * @class - reads the skim back as reduced GenEvents
+ **/
+class SkimReader: public HepMC3::Reader {
+    public:
+        SkimReader(const std::string& filename);
+        ~SkimReader();
+
+        /// @brief - reads the next event (the event is cleared first)
+        /// @return - false at the end of the file or if the record is corrupted
+        bool read_event(HepMC3::GenEvent& hepmc_event) override;
+
+        /// @brief - skips the next n events without building them
+        bool skip(const int n) override;
+
+        /// @brief - true if the last read reached the end of the file or failed
+        bool failed() override {return _failed;};
+
+        void close() override;
+
+        /// @brief - true if the file could not be opened, is not a skim or ends inside a record
+        bool readFailed() const {return _read_error;};
+
+        /// @brief - size of the file and number of bytes read
+        std::uint64_t fileSize() const {return _file_size;};
+        std::uint64_t fileOffset() const {return _file_offset;};
+
+    private:
+        std::FILE* _file = nullptr;
+        bool _failed = false, _read_error = false;
+        std::uint64_t _file_size = 0, _file_offset = 0;
+
+        /// @brief - the record is read here (the memory is reused in every event)
+        std::vector<char> _record;
+        /// @brief - vertex of the final particles of each ancestor mask
+        std::vector<std::pair<std::uint32_t, HepMC3::GenVertexPtr>> _mask_vertices;
+        std::vector<HepMC3::GenParticlePtr> _hard_particles;
+        std::vector<HepMC3::GenVertexPtr> _hard_vertices;
+
+        /// @brief - reads the size of the next record
+        /// @return - false at the end of the file
+        bool readRecordSize(std::uint32_t& size);
+
+        /// @brief - vertex of the final particles with the mask, created (and linked to the hard particles) the first time
+        HepMC3::GenVertexPtr maskVertex(std::uint32_t mask);
+
+        /// @brief - marks the reading as failed because of a corrupted or truncated file
+        bool readError(const std::string& message);
+};
+
+#endif
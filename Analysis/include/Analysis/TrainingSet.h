@@ -0,0 +1,121 @@
+/**
+ * @headerfile - builds the training set from the outputs of select_hepmc_particles (one CSV file per process and pT bin)
+ *               in bounded memory, without loading the samples:
+ *                   - all the files are streamed at the same time, each one decompressed and read ahead on its own thread
+ *                     (HepMCInputStream, so the files can be gzip or zstd compressed);
+ *                   - each class (bbbar, ccbar, light, soft, ...) has a label, its position in the list of classes, and
+ *                     its rows come from its files drawn with a probability proportional to the size of the files, so all
+ *                     the pT bins of a class run out at about the same time;
+ *                   - the classes are interleaved one row each, in a random order in every round, and the building stops
+ *                     when a class runs out (or reaches the maximum rows per class), so the set is balanced;
+ *                   - the labelled rows go through a shuffle buffer: once it is full, each new row replaces a random row
+ *                     of the buffer, which is written;
+ *                   - the rows are written in shards of a fixed number of rows (the last one may be smaller) and the
+ *                     shards are numbered with a random permutation at the end, so the first shards are not the start of
+ *                     the stream and any subset of the shards (train / validation) covers the whole files.
+ *               The memory is the shuffle buffer plus the read-ahead chunks of the files, whatever the size of the set.
+ *               Each row of the shards is the label followed by the row of the input file.
+ **/
+
+#ifndef TRAINING_SET_H
+#define TRAINING_SET_H
+
+#include <iostream>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include "Analysis/HepMCInput.h"
+#include "Analysis/FileWriter.h"
+
+/**
+ * @class - the rows of the files of one class
+ **/
+class ClassRowStream {
+    public:
+        /// @param name - name of the class, written in the summary
+        /// @param filenames - the files of the class (their compressed copies are found with resolveInputFilename)
+        ClassRowStream(const std::string& name, const std::vector<std::string>& filenames);
+
+        /// @brief - true if all the files were opened
+        bool is_open() const {return _is_open;};
+
+        /// @brief - reads the next row of the class into row (without the end of line)
+        /// @return - false when all the files ran out
+        bool nextRow(std::mt19937_64& generator, std::string& row);
+
+        const std::string& name() const {return _name;};
+        const std::vector<std::string>& filenames() const {return _filenames;};
+
+        /// @brief - number of rows read from each file
+        const std::vector<long>& rowsPerFile() const {return _rows_per_file;};
+
+    private:
+        std::string _name;
+        std::vector<std::string> _filenames;
+        bool _is_open = true;
+        std::vector<std::shared_ptr<HepMCInputStream>> _inputs;
+        /// @brief - size on disk of the files that did not run out (0 for the others)
+        std::vector<double> _weights;
+        std::vector<long> _rows_per_file;
+};
+
+/**
+ * @class - streams the classes into the shuffled, labelled shards
+ **/
+class TrainingSetBuilder {
+    public:
+        /// @param output_prefix - the shards are output_prefix_<i>.csv and the summary output_prefix_summary.txt
+        /// @param shard_size - number of rows of each shard
+        /// @param buffer_size - number of rows of the shuffle buffer
+        /// @param seed - seed of the file draws, of the class order, of the shuffle and of the shard permutation
+        TrainingSetBuilder(const std::string& output_prefix, long shard_size, long buffer_size, std::uint64_t seed, bool async_output = false);
+
+        /// @brief - adds a class, its label is the number of classes added before it
+        /// @return - false if a file of the class could not be opened
+        bool addClass(const std::string& name, const std::vector<std::string>& filenames);
+
+        /// @brief - stops each class after max_rows rows (-1 for no limit)
+        void setMaxRowsPerClass(long max_rows) {_max_rows_per_class = max_rows;};
+
+        /// @brief - reads the classes and writes the shards and the summary
+        /// @return - false if there are no classes or a file could not be written (the problem is printed)
+        bool build();
+
+        /// @brief - number of rows of each class and number of shards written by build
+        long rowsPerClass() const {return _rows_per_class;};
+        long numberShards() const {return _number_shards;};
+
+    private:
+        std::string _output_prefix;
+        long _shard_size;
+        long _buffer_size;
+        std::uint64_t _seed;
+        bool _async_output;
+        long _max_rows_per_class = -1;
+        std::vector<std::unique_ptr<ClassRowStream>> _classes;
+        std::mt19937_64 _generator;
+
+        /// @brief - the shard being written
+        std::unique_ptr<FileWriter> _shard;
+        long _rows_in_shard = 0;
+        long _number_shards = 0;
+        long _rows_per_class = 0;
+        bool _failed = false;
+
+        /// @brief - name of a shard while it is written, and its final name
+        std::string temporaryShardFilename(long shard) const;
+        std::string shardFilename(long shard) const;
+
+        /// @brief - writes a row to the current shard, opening the next one when it is full
+        void writeRow(const std::string& row);
+
+        /// @brief - closes the current shard
+        void closeShard();
+
+        /// @brief - renames the shards with a random permutation and writes the summary
+        bool finish();
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @headerfile - overlay of minimum-bias events on the signal events, to emulate the underlying event of ALICE pp and p-Pb.
+ *               BackgroundPool keeps the final state particles of the first events of a soft sample (Simulations/soft_prod_*)
+ *               in flat columns, read once, so the soft sample is not read again in lockstep with every signal file.
+ *               The pool can be saved to a cache file and mapped back with mmap: the jobs on the same machine then share
+ *               it through the page cache, and opening it costs no parsing. The layout is the same in memory and on disk
+ *               (native byte order):
+ *                   "JMLPOOL" + '\0', uint32 version, uint32 0, uint64 number of events N, uint64 number of particles n
+ *                   uint64 offsets[N + 1]                              (the particles of event i are [offsets[i], offsets[i + 1]))
+ *                   int32 pid[n], float px[n], py[n], pz[n], e[n]      (GeV)
+ *
+ *               UnderlyingEventOverlay adds k events of the pool to each signal event, before the selection, so that
+ *               EventAnalyzer, the event cuts and the clusterings see the merged event. The k events are drawn without
+ *               repetition from a splitmix64 generator seeded with the seed and the position of the event in the file,
+ *               so the overlay of an event is the same whatever the shard or the events read before it (and the events
+ *               at the same position of two samples get the same background).
+ *               Each overlaid event is one vertex (status background_vertex_status) with its final state particles as
+ *               outgoing particles. The vertex has no incoming particles, so the background is never reached from the hard
+ *               process by SignalParticlesSearcher. The background particles are added after the particles of the
+ *               signal event, so they are the particles with id >= firstBackgroundId().
+ **/
+
+#ifndef UNDERLYING_EVENT_OVERLAY_H
+#define UNDERLYING_EVENT_OVERLAY_H
+
+#include <iostream>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+
+/// @brief - true if the file name has the .pool extension (a cache of BackgroundPool)
+bool isPoolFilename(const std::string& filename);
+
+/**
+ * @class - final state particles of the minimum-bias events, in memory or mapped from a cache file
+ **/
+class BackgroundPool {
+    public:
+        BackgroundPool() {};
+        ~BackgroundPool();
+
+        /// @brief - reads the final state particles of the first max_events events of a HepMC3 file (compressed or skim)
+        /// @return - false if the file could not be read or has no events (the problem is printed)
+        bool load(const std::string& filename, long max_events);
+
+        /// @brief - maps a cache written by save
+        /// @return - false if the file could not be mapped or is not a valid cache (the problem is printed)
+        bool map(const std::string& cache_filename);
+
+        /// @brief - maps the file if it is a .pool cache, reads it with load otherwise
+        bool open(const std::string& filename, long max_events);
+
+        /// @brief - writes the pool to a cache file
+        bool save(const std::string& cache_filename) const;
+
+        long numberEvents() const {return _number_events;};
+        long numberParticles() const {return _number_particles;};
+
+        /// @brief - range [first, last) of the particles of the event in the columns
+        std::uint64_t firstParticle(long event) const {return _offsets[event];};
+        std::uint64_t lastParticle(long event) const {return _offsets[event + 1];};
+
+        /// @brief - columns of the particles
+        const std::int32_t* pid() const {return _pid;};
+        const float* px() const {return _px;};
+        const float* py() const {return _py;};
+        const float* pz() const {return _pz;};
+        const float* e() const {return _e;};
+
+        static constexpr std::uint32_t version = 1;
+
+        BackgroundPool(const BackgroundPool&) = delete;
+        BackgroundPool& operator=(const BackgroundPool&) = delete;
+
+    private:
+        /// @brief - the pool read by load (empty when it is mapped)
+        std::vector<char> _storage;
+        /// @brief - the mapped cache
+        void* _mapped = nullptr;
+        std::size_t _mapped_size = 0;
+
+        /// @brief - the whole pool (in _storage or in the mapping) and its columns
+        const char* _data = nullptr;
+        std::size_t _size = 0;
+        long _number_events = 0;
+        long _number_particles = 0;
+        const std::uint64_t* _offsets = nullptr;
+        const std::int32_t* _pid = nullptr;
+        const float* _px = nullptr;
+        const float* _py = nullptr;
+        const float* _pz = nullptr;
+        const float* _e = nullptr;
+
+        /// @brief - checks the header and sizes and points the columns into the data
+        bool setColumns(const char* data, std::size_t size, const std::string& filename);
+
+        void unmap();
+};
+
+/**
+ * @class - adds the background events of the pool to the signal events
+ **/
+class UnderlyingEventOverlay {
+    public:
+        /// @param pool - the background events (must outlive the overlay)
+        /// @param events_per_signal - number k of background events added to each signal event (at most the size of the pool)
+        /// @param seed - seed of the draws, combined with the position of each signal event
+        UnderlyingEventOverlay(const BackgroundPool& pool, int events_per_signal, std::uint64_t seed);
+
+        /// @brief - adds k background events to the event
+        /// @param event_index - position of the event in the file, which fixes the background events drawn for it
+        void overlay(HepMC3::GenEvent& hepmc_event, long event_index);
+
+        /// @brief - id of the first background particle of the last event given to overlay
+        int firstBackgroundId() const {return _first_background_id;};
+
+        /// @brief - true if the particle of the last event given to overlay comes from the background
+        bool isBackground(const HepMC3::ConstGenParticlePtr& particle) const {return particle->id() >= _first_background_id;};
+
+        /// @brief - positions in the pool of the background events of the last event
+        const std::vector<long>& overlaidEvents() const {return _overlaid_events;};
+
+        /// @brief - status of the vertices of the background events
+        static constexpr int background_vertex_status = 1000;
+
+    private:
+        const BackgroundPool& _pool;
+        int _events_per_signal;
+        std::uint64_t _seed;
+        int _first_background_id = 1;
+        std::vector<long> _overlaid_events;
+};
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * Python bindings to the C++ event pipeline.
+ * Each batch of events is filled by the C++ chain (ReaderAscii -> EventAnalyzer -> SignalParticlesSearcher)
+ * and returned as NumPy arrays that point to the C++ buffers of the batch - no copies and no per-particle Python objects.
+ * The batch is deleted when the last array using it is garbage collected.
+ **/
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <memory>
+#include "Analysis/EventStream.h"
+
+namespace py = pybind11;
+
+/// @brief - wraps one buffer of the batch as a NumPy array, the capsule keeps the batch alive
+template <class T>
+py::array_t<T> makeArray(std::vector<T>& buffer, std::vector<py::ssize_t> shape, const py::capsule& owner) {
+    return py::array_t<T>(shape, buffer.data(), owner);
+}
+
+/**
+ * @class - python iterator over the batches of events of a file
+ **/
+class PyEventStream {
+    public:
+        PyEventStream(const std::string& filename, int max_particles, std::size_t batch_size): _stream(filename, max_particles), _batch_size(batch_size) {};
+
+        /// @brief - returns the next batch as a dict of NumPy arrays
+        py::dict nextBatch();
+
+    private:
+        EventStream _stream;
+        std::size_t _batch_size;
+};
+
+py::dict PyEventStream::nextBatch() {
+    // owned here until the capsule takes it, so an exception of the reading does not leak the batch
+    std::unique_ptr<EventBatch> batch (new EventBatch());
+    bool has_events;
+    {
+        // the analysis runs without the GIL
+        py::gil_scoped_release release;
+        has_events = _stream.nextBatch(*batch, _batch_size);
+    }
+    if (!has_events)
+        throw py::stop_iteration();
+    py::capsule owner(batch.get(), [](void* pointer) {delete static_cast<EventBatch*>(pointer);});
+    EventBatch* batch_data = batch.release();
+    const py::ssize_t n_events = batch_data->size(), n_particles = _stream.maxNumberParticles();
+
+    py::dict arrays;
+    arrays["q2"] = makeArray(batch_data->q2, {n_events}, owner);
+    arrays["initial_pid"] = makeArray(batch_data->initial_pid, {n_events}, owner);
+    arrays["number_particles"] = makeArray(batch_data->number_particles, {n_events}, owner);
+    arrays["kinematics"] = makeArray(batch_data->kinematics, {n_events, n_particles, 3}, owner);
+    arrays["pid"] = makeArray(batch_data->pid, {n_events, n_particles}, owner);
+    return arrays;
+}
+
+PYBIND11_MODULE(jetml_analysis, module) {
+    module.doc() = "Streams batches of analysed HepMC3 events as NumPy arrays";
+
+    py::class_<PyEventStream>(module, "EventStream")
+        .def(py::init<const std::string&, int, std::size_t>(), py::arg("filename"), py::arg("max_particles") = 50, py::arg("batch_size") = 1024)
+        .def("__iter__", [](PyEventStream& stream) -> PyEventStream& {return stream;}, py::return_value_policy::reference_internal)
+        .def("__next__", &PyEventStream::nextBatch,
+             "Returns a dict with the arrays q2, initial_pid, number_particles, kinematics (pt, eta, phi) and pid");
+}
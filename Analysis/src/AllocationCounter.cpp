@@ -0,0 +1,82 @@
+#include "Analysis/AllocationCounter.h"
+#include <new>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+    /// plain thread-local integers: no dynamic initialisation, so they can be used inside operator new
+    thread_local std::uint64_t thread_allocations = 0;
+    thread_local std::uint64_t thread_bytes = 0;
+
+    void* countedAllocation(std::size_t size) {
+        thread_allocations++;
+        thread_bytes += size;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* countedAlignedAllocation(std::size_t size, std::align_val_t alignment) {
+        thread_allocations++;
+        thread_bytes += size;
+        void* pointer = nullptr;
+        std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+        if (posix_memalign(&pointer, align, size == 0 ? 1 : size) != 0)
+            return nullptr;
+        return pointer;
+    }
+}
+
+AllocationCount threadAllocations() {
+    return {thread_allocations, thread_bytes};
+}
+
+void* operator new(std::size_t size) {
+    void* pointer = countedAllocation(size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocation(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocation(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pointer = countedAlignedAllocation(size, alignment);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAlignedAllocation(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAlignedAllocation(size, alignment);
+}
+
+/// every allocation above comes from malloc or posix_memalign, so all the deletes are free
+void operator delete(void* pointer) noexcept {std::free(pointer);}
+void operator delete[](void* pointer) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::size_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::size_t) noexcept {std::free(pointer);}
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {std::free(pointer);}
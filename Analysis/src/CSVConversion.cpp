@@ -0,0 +1,350 @@
+#include "Analysis/CSVConversion.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <charconv>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/**
+ * @class - a file mapped in memory, read only or created with a given size
+ **/
+class MappedFile {
+    public:
+        ~MappedFile() {close();};
+
+        /// @brief - maps an existing file for reading
+        bool openRead(const std::string& filename) {
+            const int descriptor = ::open(filename.c_str(), O_RDONLY);
+            if (descriptor < 0) {
+                std::cout << "Could not open " << filename << std::endl;
+                return false;
+            }
+            struct stat file_status;
+            if (fstat(descriptor, &file_status) != 0 || file_status.st_size == 0) {
+                std::cout << filename << " is empty or could not be read" << std::endl;
+                ::close(descriptor);
+                return false;
+            }
+            return map(descriptor, file_status.st_size, PROT_READ, filename);
+        };
+
+        /// @brief - creates the file with the size (the disk space is reserved, so a full disk is an error here and not
+        ///          a crash when the mapping is written)
+        bool create(const std::string& filename, std::size_t size) {
+            const int descriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (descriptor < 0 || posix_fallocate(descriptor, 0, size) != 0) {
+                std::cout << "Could not create " << filename << " with " << size << " bytes" << std::endl;
+                if (descriptor >= 0)
+                    ::close(descriptor);
+                return false;
+            }
+            return map(descriptor, size, PROT_READ | PROT_WRITE, filename);
+        };
+
+        void close() {
+            if (_data)
+                munmap(_data, _size);
+            _data = nullptr;
+            _size = 0;
+        };
+
+        char* data() const {return _data;};
+        std::size_t size() const {return _size;};
+
+    private:
+        char* _data = nullptr;
+        std::size_t _size = 0;
+
+        bool map(int descriptor, std::size_t size, int protection, const std::string& filename) {
+            void* mapped = mmap(nullptr, size, protection, MAP_SHARED, descriptor, 0);
+            /// the mapping stays valid after the file is closed
+            ::close(descriptor);
+            if (mapped == MAP_FAILED) {
+                std::cout << "Could not map " << filename << std::endl;
+                return false;
+            }
+            _data = static_cast<char*>(mapped);
+            _size = size;
+            /// each thread reads its chunk from the start to the end
+            madvise(_data, _size, MADV_SEQUENTIAL);
+            return true;
+        };
+};
+
+/// @brief - calls function(begin, end) for each non-empty line of [begin, end) (without the end of line)
+template <typename Function>
+static void forEachLine(const char* begin, const char* end, Function function) {
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        const char* line_end = newline ? newline : end;
+        const char* content_end = (line_end > begin && line_end[-1] == '\r') ? line_end - 1 : line_end;
+        if (content_end > begin)
+            function(begin, content_end);
+        begin = line_end + 1;
+    }
+}
+
+/// @brief - the data of the file split into number_chunks chunks that start at the beginning of a line
+static std::vector<const char*> chunkBoundaries(const char* begin, const char* end, int number_chunks) {
+    std::vector<const char*> boundaries = {begin};
+    for (int chunk = 1; chunk < number_chunks; chunk++) {
+        const char* position = std::max(begin + (end - begin) * chunk / number_chunks, boundaries.back());
+        const char* newline = static_cast<const char*>(std::memchr(position, '\n', end - position));
+        boundaries.push_back(newline ? newline + 1 : end);
+    }
+    boundaries.push_back(end);
+    return boundaries;
+}
+
+/// @brief - runs function(chunk) on one thread per chunk
+template <typename Function>
+static void runOnChunks(int number_chunks, Function function) {
+    std::vector<std::thread> threads;
+    for (int chunk = 0; chunk < number_chunks; chunk++)
+        threads.emplace_back(function, chunk);
+    for (std::thread& thread: threads)
+        thread.join();
+}
+
+/// @brief - the .npy header (format 1.0) of a C-ordered float32 array, padded so the data starts at a multiple of 64 bytes
+static std::string npyHeader(long rows, long columns) {
+    std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " + std::to_string(columns) + "), }";
+    /// magic string, version, length of the header and the final new line
+    const std::size_t prefix_size = 10;
+    header.append(63 - (prefix_size + header.size()) % 64, ' ');
+    header += '\n';
+    const std::uint16_t header_size = header.size();
+    const char prefix[prefix_size] = {'\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0, char(header_size & 0xff), char(header_size >> 8)};
+    return std::string(prefix, prefix_size) + header;
+}
+
+/// @brief - powers of ten that are exact in float
+static const float exact_powers_of_ten[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+
+/// @brief - parses a float, correctly rounded like std::from_chars
+/// @return - the end of the value, or nullptr if it is not a number
+static const char* parseFloat(const char* begin, const char* end, float& value) {
+    /// CSVWriter writes integers and %g (at most 6 significant digits): their mantissa and power of ten are exact in float,
+    /// so one multiplication or division gives the correctly rounded value (Clinger's fast path) and most values never
+    /// reach from_chars
+    const char* position = begin;
+    const bool negative = position < end && *position == '-';
+    if (negative)
+        position++;
+    std::uint32_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    for (; position < end && *position >= '0' && *position <= '9' && digits < 9; position++, digits++)
+        mantissa = 10 * mantissa + (*position - '0');
+    if (position < end && *position == '.')
+        for (position++; position < end && *position >= '0' && *position <= '9' && digits < 9; position++, digits++, exponent--)
+            mantissa = 10 * mantissa + (*position - '0');
+    if (digits > 0 && position < end && (*position == 'e' || *position == 'E')) {
+        const char* exponent_begin = position + 1;
+        const bool negative_exponent = exponent_begin < end && *exponent_begin == '-';
+        if (exponent_begin < end && (*exponent_begin == '-' || *exponent_begin == '+'))
+            exponent_begin++;
+        int written_exponent = 0;
+        for (position = exponent_begin; position < end && *position >= '0' && *position <= '9' && written_exponent < 1000; position++)
+            written_exponent = 10 * written_exponent + (*position - '0');
+        if (position == exponent_begin)
+            digits = 0;
+        exponent += negative_exponent ? -written_exponent : written_exponent;
+    }
+    const bool at_separator = position == end || *position == ',' || *position == ' ';
+    if (digits > 0 && digits < 9 && at_separator && mantissa < (1u << 24) && exponent >= -10 && exponent <= 10) {
+        value = exponent < 0 ? float(mantissa) / exact_powers_of_ten[-exponent] : float(mantissa) * exact_powers_of_ten[exponent];
+        if (negative)
+            value = -value;
+        return position;
+    }
+
+    const std::from_chars_result result = std::from_chars(begin, end, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        /// from_chars leaves the value unset out of the float range, strtof gives 0 or inf like numpy
+        char token[64] = {};
+        std::memcpy(token, begin, std::min<std::size_t>(result.ptr - begin, sizeof(token) - 1));
+        value = std::strtof(token, nullptr);
+    }
+    else if (result.ec != std::errc())
+        return nullptr;
+    return result.ptr;
+}
+
+/// @brief - parses the values of a line
+/// @return - number of values, or -1 if a value is not a number or the line has more than max_columns values
+static long parseLine(const char* begin, const char* end, float* values, long max_columns) {
+    long column = 0;
+    const char* position = begin;
+    while (true) {
+        if (column == max_columns)
+            return -1;
+        while (position < end && *position == ' ')
+            position++;
+        position = parseFloat(position, end, values[column]);
+        if (!position)
+            return -1;
+        column++;
+        while (position < end && *position == ' ')
+            position++;
+        if (position == end)
+            return column;
+        if (*position != ',')
+            return -1;
+        position++;
+    }
+}
+
+/// @brief - counts the rows of the chunks and the columns of the first row
+/// @return - the row where each chunk starts (the last entry is the number of rows)
+static std::vector<long> countRows(const std::vector<const char*>& boundaries, long& columns) {
+    const int number_chunks = boundaries.size() - 1;
+    std::vector<long> first_rows (number_chunks + 1, 0);
+    runOnChunks(number_chunks, [&](int chunk) {
+        long rows = 0;
+        forEachLine(boundaries[chunk], boundaries[chunk + 1], [&rows](const char*, const char*) {rows++;});
+        first_rows[chunk + 1] = rows;
+    });
+    for (int chunk = 0; chunk < number_chunks; chunk++)
+        first_rows[chunk + 1] += first_rows[chunk];
+
+    columns = 0;
+    bool first_row = true;
+    forEachLine(boundaries.front(), boundaries.back(), [&](const char* begin, const char* end) {
+        if (first_row)
+            columns = std::count(begin, end, ',') + 1;
+        first_row = false;
+    });
+    return first_rows;
+}
+
+/// @brief - number of threads to use
+static int numberThreads(int number_threads) {
+    if (number_threads > 0)
+        return number_threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool convertCSVToNpy(const std::string& csv_filename, const std::string& npy_filename, int number_threads, CSVConversionSummary& summary) {
+    const auto start = std::chrono::steady_clock::now();
+    summary = CSVConversionSummary();
+    MappedFile input;
+    if (!input.openRead(csv_filename))
+        return false;
+    summary.input_bytes = input.size();
+    const std::vector<const char*> boundaries = chunkBoundaries(input.data(), input.data() + input.size(), numberThreads(number_threads));
+    const int number_chunks = boundaries.size() - 1;
+    const std::vector<long> first_rows = countRows(boundaries, summary.columns);
+    summary.rows = first_rows.back();
+    if (summary.rows == 0) {
+        std::cout << csv_filename << " has no rows" << std::endl;
+        return false;
+    }
+
+    const std::string header = npyHeader(summary.rows, summary.columns);
+    MappedFile output;
+    if (!output.create(npy_filename, header.size() + sizeof(float) * summary.rows * summary.columns))
+        return false;
+    std::memcpy(output.data(), header.data(), header.size());
+    /// the header keeps the data aligned for float
+    float* const data = reinterpret_cast<float*>(output.data() + header.size());
+
+    /// first row of each chunk that could not be parsed (-1 if none) and rows zero padded
+    std::vector<long> error_rows (number_chunks, -1), short_rows (number_chunks, 0);
+    runOnChunks(number_chunks, [&](int chunk) {
+        long row = first_rows[chunk];
+        forEachLine(boundaries[chunk], boundaries[chunk + 1], [&](const char* begin, const char* end) {
+            float* values = data + row * summary.columns;
+            const long parsed = error_rows[chunk] < 0 ? parseLine(begin, end, values, summary.columns) : summary.columns;
+            if (parsed < 0)
+                error_rows[chunk] = row;
+            else if (parsed < summary.columns) {
+                std::fill(values + parsed, values + summary.columns, 0.f);
+                short_rows[chunk]++;
+            }
+            row++;
+        });
+    });
+    for (int chunk = 0; chunk < number_chunks; chunk++) {
+        summary.short_rows += short_rows[chunk];
+        if (error_rows[chunk] >= 0) {
+            std::cout << csv_filename << ": row " << error_rows[chunk] + 1 << " is not " << summary.columns
+                      << " comma separated numbers (the number of columns of the first row)" << std::endl;
+            output.close();
+            std::remove(npy_filename.c_str());
+            return false;
+        }
+    }
+    output.close();
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+bool validateNpy(const std::string& csv_filename, const std::string& npy_filename, int number_threads, CSVConversionSummary& summary) {
+    const auto start = std::chrono::steady_clock::now();
+    summary = CSVConversionSummary();
+    MappedFile input, npy;
+    if (!input.openRead(csv_filename) || !npy.openRead(npy_filename))
+        return false;
+    summary.input_bytes = input.size();
+    const std::vector<const char*> boundaries = chunkBoundaries(input.data(), input.data() + input.size(), numberThreads(number_threads));
+    const int number_chunks = boundaries.size() - 1;
+    const std::vector<long> first_rows = countRows(boundaries, summary.columns);
+    summary.rows = first_rows.back();
+
+    /// the shape is in the header, so the header must be the one of the CSV file
+    const std::string header = npyHeader(summary.rows, summary.columns);
+    if (npy.size() != header.size() + sizeof(float) * summary.rows * summary.columns || std::memcmp(npy.data(), header.data(), header.size()) != 0) {
+        std::cout << npy_filename << " does not have the shape (" << summary.rows << ", " << summary.columns << ") of " << csv_filename << std::endl;
+        return false;
+    }
+    const float* const data = reinterpret_cast<const float*>(npy.data() + header.size());
+
+    std::mutex print_mutex;
+    const long max_printed = 10;
+    std::vector<long> mismatches (number_chunks, 0), short_rows (number_chunks, 0);
+    runOnChunks(number_chunks, [&](int chunk) {
+        long row = first_rows[chunk];
+        forEachLine(boundaries[chunk], boundaries[chunk + 1], [&](const char* begin, const char* end) {
+            const float* values = data + row * summary.columns;
+            long column = 0;
+            /// each value is copied so that strtof stops at the end of the value even at the end of the mapping
+            for (const char* value_begin = begin; value_begin <= end && column < summary.columns; column++) {
+                const char* value_end = std::find(value_begin, end, ',');
+                char token[64] = {};
+                std::memcpy(token, value_begin, std::min<std::size_t>(value_end - value_begin, sizeof(token) - 1));
+                char* token_end;
+                const float expected = std::strtof(token, &token_end);
+                const bool same = (token_end != token) && (values[column] == expected || (std::isnan(values[column]) && std::isnan(expected)));
+                if (!same) {
+                    std::lock_guard<std::mutex> lock (print_mutex);
+                    if (mismatches[chunk]++ < max_printed)
+                        std::cout << "row " << row + 1 << ", column " << column << ": " << values[column] << " in " << npy_filename
+                                  << ", '" << token << "' in " << csv_filename << std::endl;
+                }
+                value_begin = value_end + 1;
+            }
+            /// the padding of the short rows
+            if (column < summary.columns)
+                short_rows[chunk]++;
+            for (; column < summary.columns; column++)
+                if (values[column] != 0)
+                    mismatches[chunk]++;
+            row++;
+        });
+    });
+    for (int chunk = 0; chunk < number_chunks; chunk++) {
+        summary.mismatches += mismatches[chunk];
+        summary.short_rows += short_rows[chunk];
+    }
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return summary.mismatches == 0;
+}
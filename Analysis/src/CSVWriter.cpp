@@ -1,31 +1,78 @@
 #include "Analysis/CSVWriter.h"
+#include <algorithm>
 
-void CSVWriter::writeEvent (double event_q2, int initial_part_pid, std::vector<HepMC3::ConstGenParticlePtr> final_particles) {
+void CSVWriter::writeEvent (double event_q2, int initial_part_pid, const std::vector<HepMC3::ConstGenParticlePtr>& final_particles) {
     if (output_file.is_open()) {
         // adding the information about the energy of the process and pid of the incomming particles
-        output_file << event_q2 << "," << initial_part_pid;
+        addEventValues(event_q2, initial_part_pid);
         // adding the information about the particles
         int part_counter = 0;
         // checks if we have at least 50 particles and
         // checks if there's particle left in the vector
         while (part_counter < max_number_particles && part_counter < final_particles.size()) {
-            // writing the info 
-            const HepMC3::FourVector& momentum = final_particles.at(part_counter)->momentum();
             // write particle info in the csv file
-            output_file << "," << momentum.pt()  << "," << momentum.eta() << "," << momentum.phi() << "," << final_particles.at(part_counter)->pid();
+            const HepMC3::FourVector& momentum = final_particles.at(part_counter)->momentum();
+            addParticle(momentum.pt(), momentum.eta(), momentum.phi(), final_particles.at(part_counter)->pid());
             part_counter++;
         }
-        if (part_counter < max_number_particles)
-            this->addZeroPaddedParticles(max_number_particles - part_counter);
+        finishLine(part_counter);
+    }
+    else
+        std::cout << "File not open" << std::endl;
+}
 
-        // break line
-        output_file << "\n";
+void CSVWriter::writeEvent (double event_q2, int initial_part_pid, const DetectorTracks& tracks) {
+    if (output_file.is_open()) {
+        addEventValues(event_q2, initial_part_pid);
+        const int number_tracks = std::min<int>(tracks.size(), max_number_particles);
+        for (int i = 0; i < number_tracks; i++)
+            addParticle(tracks.pt[i], tracks.eta[i], tracks.phi[i], tracks.pid[i]);
+        finishLine(number_tracks);
     }
     else
         std::cout << "File not open" << std::endl;
 }
 
+void CSVWriter::addEventValues(double event_q2, int initial_part_pid) {
+    line_.clear();
+    addValue(event_q2);
+    line_ += ",";
+    addValue(initial_part_pid);
+}
+
+void CSVWriter::addParticle(double pt, double eta, double phi, int pid) {
+    line_ += ",";
+    addValue(pt);
+    line_ += ",";
+    addValue(eta);
+    line_ += ",";
+    addValue(phi);
+    line_ += ",";
+    addValue(pid);
+}
+
+void CSVWriter::finishLine(int number_particles) {
+    if (number_particles < max_number_particles)
+        this->addZeroPaddedParticles(max_number_particles - number_particles);
+    // break line
+    line_ += "\n";
+    output_file.write(line_);
+}
+
+void CSVWriter::addValue(double value) {
+    // %g with the default precision is the std::ostream format for doubles
+    char buffer[32];
+    int size = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    line_.append(buffer, size);
+}
+
+void CSVWriter::addValue(int value) {
+    char buffer[16];
+    int size = std::snprintf(buffer, sizeof(buffer), "%d", value);
+    line_.append(buffer, size);
+}
+
 void CSVWriter::addZeroPaddedParticles(int numberZeroPaddedPart) {
     for(int i = 0; i < numberZeroPaddedPart * 4; i++) 
-        output_file << ",0";
+        line_ += ",0";
 }
@@ -0,0 +1,181 @@
+#include "Analysis/DetectorResponse.h"
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+
+
+/// @brief - number of random numbers drawn for each particle (two Philox blocks)
+static const int uniforms_per_particle = 8;
+
+/// @brief - Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): the 4 words of the counter are
+///          encrypted with the 2 words of the key, the output is 4 independent uniform 32 bit words
+static void philox4x32(std::uint32_t counter[4], std::uint32_t key0, std::uint32_t key1) {
+    for (int round = 0; round < 10; round++) {
+        if (round > 0) {
+            key0 += 0x9E3779B9u;
+            key1 += 0xBB67AE85u;
+        }
+        const std::uint64_t product0 = std::uint64_t(0xD2511F53u) * counter[0];
+        const std::uint64_t product1 = std::uint64_t(0xCD9E8D57u) * counter[2];
+        const std::uint32_t word0 = std::uint32_t(product1 >> 32) ^ counter[1] ^ key0;
+        const std::uint32_t word2 = std::uint32_t(product0 >> 32) ^ counter[3] ^ key1;
+        counter[0] = word0;
+        counter[1] = std::uint32_t(product1);
+        counter[2] = word2;
+        counter[3] = std::uint32_t(product0);
+    }
+}
+
+/// @brief - appends the values after the keyword
+static bool readValues(std::istringstream& fields, std::vector<double>& values) {
+    const std::size_t previous_size = values.size();
+    for (double value; fields >> value;)
+        values.push_back(value);
+    return fields.eof() && values.size() > previous_size;
+}
+
+bool DetectorResponse::read(const std::string& filename) {
+    std::ifstream input (filename);
+    if (!input.is_open()) {
+        std::cout << "Could not open the detector response " << filename << std::endl;
+        return false;
+    }
+    _pt_edges.clear();
+    _eta_edges.clear();
+    _efficiency.clear();
+    _pt_resolution.clear();
+    _eta_resolution.clear();
+    _phi_resolution.clear();
+    std::string line;
+    int line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+        // comments
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        std::istringstream fields (line);
+        std::string key;
+        if (!(fields >> key))
+            continue;
+        std::vector<double>* table = nullptr;
+        if (key == "pt_bins") table = &_pt_edges;
+        else if (key == "eta_bins") table = &_eta_edges;
+        else if (key == "efficiency") table = &_efficiency;
+        else if (key == "pt_resolution") table = &_pt_resolution;
+        else if (key == "eta_resolution") table = &_eta_resolution;
+        else if (key == "phi_resolution") table = &_phi_resolution;
+        if (!table || !readValues(fields, *table)) {
+            std::cout << filename << ":" << line_number << ": invalid entry '" << line << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (_pt_edges.size() < 2 || _eta_edges.size() < 2 || !std::is_sorted(_pt_edges.begin(), _pt_edges.end(), std::less_equal<double>())
+        || !std::is_sorted(_eta_edges.begin(), _eta_edges.end(), std::less_equal<double>())) {
+        std::cout << filename << ": the pt and eta bins need at least two increasing edges" << std::endl;
+        return false;
+    }
+    const std::size_t number_bins = numberPtBins() * numberEtaBins();
+    /// the resolutions are optional, no smearing without them
+    for (std::vector<double>* table: {&_pt_resolution, &_eta_resolution, &_phi_resolution})
+        if (table->empty())
+            table->assign(number_bins, 0.);
+    for (const std::vector<double>* table: {&_efficiency, &_pt_resolution, &_eta_resolution, &_phi_resolution}) {
+        if (table->size() != number_bins) {
+            std::cout << filename << ": the tables need " << number_bins << " values (" << numberPtBins() << " pt bins x "
+                      << numberEtaBins() << " eta bins)" << std::endl;
+            return false;
+        }
+        if (*std::min_element(table->begin(), table->end()) < 0) {
+            std::cout << filename << ": the tables cannot have negative values" << std::endl;
+            return false;
+        }
+    }
+    if (*std::max_element(_efficiency.begin(), _efficiency.end()) > 1) {
+        std::cout << filename << ": the efficiencies must be in [0, 1]" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void DetectorResponse::apply(const std::vector<HepMC3::ConstGenParticlePtr>& particles, long event_index, DetectorTracks& tracks) {
+    const int number_particles = particles.size();
+    const int number_eta_bins = numberEtaBins();
+    _pt.resize(number_particles);
+    _eta.resize(number_particles);
+    _phi.resize(number_particles);
+    _pid.resize(number_particles);
+    _id.resize(number_particles);
+    _bin.resize(number_particles);
+    _reconstructed.resize(number_particles);
+    _uniform.resize(uniforms_per_particle * number_particles);
+
+    // gather: the only loop that follows the particle pointers
+    for (int i = 0; i < number_particles; i++) {
+        const HepMC3::FourVector& momentum = particles[i]->momentum();
+        _pt[i] = momentum.pt();
+        _eta[i] = momentum.eta();
+        _phi[i] = momentum.phi();
+        _pid[i] = particles[i]->pid();
+        _id[i] = particles[i]->id();
+    }
+
+    // bins of the tables
+    for (int i = 0; i < number_particles; i++) {
+        if (_pt[i] < _pt_edges.front() || _eta[i] < _eta_edges.front() || _eta[i] >= _eta_edges.back()) {
+            _bin[i] = -1;
+            continue;
+        }
+        const int pt_bin = std::min<int>(std::upper_bound(_pt_edges.begin(), _pt_edges.end(), _pt[i]) - _pt_edges.begin() - 1, numberPtBins() - 1);
+        const int eta_bin = std::upper_bound(_eta_edges.begin(), _eta_edges.end(), _eta[i]) - _eta_edges.begin() - 1;
+        _bin[i] = pt_bin * number_eta_bins + eta_bin;
+    }
+
+    // random numbers: the counter is (particle id, event index, block) and the key is the seed
+    const std::uint32_t key0 = std::uint32_t(_seed), key1 = std::uint32_t(_seed >> 32);
+    const std::uint64_t event = event_index;
+    for (int i = 0; i < number_particles; i++) {
+        for (std::uint32_t block = 0; block < uniforms_per_particle / 4; block++) {
+            std::uint32_t counter[4] = {_id[i], std::uint32_t(event), std::uint32_t(event >> 32), block};
+            philox4x32(counter, key0, key1);
+            for (int j = 0; j < 4; j++)
+                _uniform[uniforms_per_particle * i + 4 * block + j] = (counter[j] + 0.5) * 0x1.0p-32;
+        }
+    }
+
+    // efficiency and smearing without branches, Box-Muller for the gaussians (the numbers 5 to 7 are spare)
+    for (int i = 0; i < number_particles; i++) {
+        const int bin = std::max(_bin[i], 0);
+        const double* uniform = &_uniform[uniforms_per_particle * i];
+        const double radius1 = std::sqrt(-2 * std::log(uniform[1])), radius2 = std::sqrt(-2 * std::log(uniform[3]));
+        _pt[i] *= 1 + _pt_resolution[bin] * radius1 * std::cos(2 * M_PI * uniform[2]);
+        _eta[i] += _eta_resolution[bin] * radius1 * std::sin(2 * M_PI * uniform[2]);
+        _phi[i] = std::remainder(_phi[i] + _phi_resolution[bin] * radius2 * std::cos(2 * M_PI * uniform[4]), 2 * M_PI);
+        /// a track cannot have negative pT (only for resolutions close to 100%)
+        _reconstructed[i] = _bin[i] >= 0 && uniform[0] < _efficiency[bin] && _pt[i] > 0;
+    }
+
+    // compaction, ordered by the smeared pT like the selected particles
+    _kept.clear();
+    for (int i = 0; i < number_particles; i++)
+        if (_reconstructed[i])
+            _kept.push_back(i);
+    std::sort(_kept.begin(), _kept.end(), [this](int i, int j) {return _pt[i] > _pt[j];});
+    const int number_tracks = _kept.size();
+    tracks.pt.resize(number_tracks);
+    tracks.eta.resize(number_tracks);
+    tracks.phi.resize(number_tracks);
+    tracks.pid.resize(number_tracks);
+    tracks.particle.resize(number_tracks);
+    for (int k = 0; k < number_tracks; k++) {
+        const int i = _kept[k];
+        tracks.pt[k] = _pt[i];
+        tracks.eta[k] = _eta[i];
+        tracks.phi[k] = _phi[i];
+        tracks.pid[k] = _pid[i];
+        tracks.particle[k] = i;
+    }
+}
@@ -0,0 +1,171 @@
+#include "Analysis/EtaPhiGrid.h"
+#include <cmath>
+#include <algorithm>
+
+
+/// @brief - phi in [0, 2pi) (HepMC3 gives it in (-pi, pi])
+static double wrapPhi(double phi) {
+    if (phi < 0) phi += 2 * M_PI;
+    return phi >= 2 * M_PI ? 0. : phi;
+}
+
+EtaPhiGrid::EtaPhiGrid(double max_eta, double cell_size): _max_eta(max_eta), _kernels(&simdKernels()) {
+    _number_eta = std::max(1, int(std::ceil(2 * max_eta / cell_size - 1e-9)));
+    _number_phi = std::max(1, int(std::round(2 * M_PI / cell_size)));
+    _eta_size = 2 * max_eta / _number_eta;
+    _phi_size = 2 * M_PI / _number_phi;
+    _cell_start.assign(_number_eta * _number_phi + 1, 0);
+}
+
+int EtaPhiGrid::etaCell(double eta) const {
+    /// the particles outside the acceptance go to the first and last rows
+    const int cell = int(std::floor((eta + _max_eta) / _eta_size));
+    return std::min(std::max(cell, 0), _number_eta - 1);
+}
+
+int EtaPhiGrid::phiCell(double phi) const {
+    return std::min(int(phi / _phi_size), _number_phi - 1);
+}
+
+void EtaPhiGrid::build(const std::vector<HepMC3::ConstGenParticlePtr>& particles) {
+    const int number_particles = particles.size();
+    const int number_cells = _number_eta * _number_phi;
+    _particle_eta.resize(number_particles);
+    _particle_phi.resize(number_particles);
+    _particle_pt.resize(number_particles);
+    _particle_cell.resize(number_particles);
+    _sorted_eta.resize(number_particles);
+    _sorted_phi.resize(number_particles);
+    _sorted_pt.resize(number_particles);
+    _sorted_index.resize(number_particles);
+
+    /// counting sort: number of particles per cell, then the end of each cell
+    std::fill(_cell_start.begin(), _cell_start.end(), 0);
+    for (int i = 0; i < number_particles; i++) {
+        const HepMC3::FourVector& momentum = particles[i]->momentum();
+        _particle_eta[i] = momentum.eta();
+        _particle_phi[i] = wrapPhi(momentum.phi());
+        _particle_pt[i] = momentum.pt();
+        _particle_cell[i] = etaCell(_particle_eta[i]) * _number_phi + phiCell(_particle_phi[i]);
+        _cell_start[_particle_cell[i]]++;
+    }
+    for (int cell = 1; cell < number_cells; cell++)
+        _cell_start[cell] += _cell_start[cell - 1];
+    /// filling from the end of each cell leaves _cell_start at the first particle of the cell
+    for (int i = number_particles - 1; i >= 0; i--) {
+        const int position = --_cell_start[_particle_cell[i]];
+        _sorted_eta[position] = _particle_eta[i];
+        _sorted_phi[position] = _particle_phi[i];
+        _sorted_pt[position] = _particle_pt[i];
+        _sorted_index[position] = i;
+    }
+    _cell_start[number_cells] = number_particles;
+}
+
+template<typename RangeVisitor>
+void EtaPhiGrid::visitCellRanges(double eta, double phi, double r, RangeVisitor visit) const {
+    const int first_eta = etaCell(eta - r), last_eta = etaCell(eta + r);
+    /// the phi cells of the cone, wrapped around and never visited twice: the cells of a row are contiguous in the
+    /// sorted arrays, so each row is one range, or two when the cone crosses phi = 0
+    const int first_phi = int(std::floor((phi - r) / _phi_size));
+    const int number_phi = std::min(int(std::floor((phi + r) / _phi_size)) - first_phi + 1, _number_phi);
+    const int start_phi = (first_phi % _number_phi + _number_phi) % _number_phi;
+    const int end_phi = start_phi + number_phi;
+    for (int eta_cell = first_eta; eta_cell <= last_eta; eta_cell++) {
+        const int row = eta_cell * _number_phi;
+        visit(_cell_start[row + start_phi], _cell_start[row + std::min(end_phi, _number_phi)]);
+        if (end_phi > _number_phi)
+            visit(_cell_start[row], _cell_start[row + end_phi - _number_phi]);
+    }
+}
+
+template<typename Visitor>
+void EtaPhiGrid::visitWithinDeltaR(double eta, double phi, double r, Visitor visit) const {
+    phi = wrapPhi(phi);
+    const double r2 = r * r;
+    visitCellRanges(eta, phi, r, [&](int first_position, int end_position) {
+        for (int position = first_position; position < end_position; position++) {
+            const double deta = _sorted_eta[position] - eta;
+            double dphi = std::abs(_sorted_phi[position] - phi);
+            dphi = std::min(dphi, 2 * M_PI - dphi);
+            if (deta * deta + dphi * dphi < r2)
+                visit(position);
+        }
+    });
+}
+
+void EtaPhiGrid::withinDeltaR(double eta, double phi, double r, std::vector<int>& indices) const {
+    indices.clear();
+    visitWithinDeltaR(eta, phi, r, [&](int position) {indices.push_back(_sorted_index[position]);});
+}
+
+/// the count and the pT sum only need the mask of the cone, computed by the SIMD kernels on each range of cells
+int EtaPhiGrid::countWithinDeltaR(double eta, double phi, double r) const {
+    phi = wrapPhi(phi);
+    int count = 0;
+    visitCellRanges(eta, phi, r, [&](int first_position, int end_position) {
+        count += _kernels->count_within(_sorted_eta.data() + first_position, _sorted_phi.data() + first_position, end_position - first_position, eta, phi, r * r);
+    });
+    return count;
+}
+
+double EtaPhiGrid::ptWithinDeltaR(double eta, double phi, double r) const {
+    phi = wrapPhi(phi);
+    double pt_sum = 0;
+    visitCellRanges(eta, phi, r, [&](int first_position, int end_position) {
+        pt_sum += _kernels->pt_within(_sorted_eta.data() + first_position, _sorted_phi.data() + first_position, _sorted_pt.data() + first_position,
+                                      end_position - first_position, eta, phi, r * r);
+    });
+    return pt_sum;
+}
+
+int EtaPhiGrid::nearestNeighbour(double eta, double phi, int exclude_index) const {
+    phi = wrapPhi(phi);
+    const int center_eta = etaCell(eta), center_phi = phiCell(phi);
+    const double min_cell_size = std::min(_eta_size, _phi_size);
+    int nearest = -1;
+    double nearest_distance2 = 0;
+
+    auto visitCell = [&](int eta_cell, int phi_offset) {
+        if (eta_cell < 0 || eta_cell >= _number_eta) return;
+        const int phi_cell = ((center_phi + phi_offset) % _number_phi + _number_phi) % _number_phi;
+        const int cell = eta_cell * _number_phi + phi_cell;
+        for (int position = _cell_start[cell]; position < _cell_start[cell + 1]; position++) {
+            if (_sorted_index[position] == exclude_index) continue;
+            const double deta = _sorted_eta[position] - eta;
+            double dphi = std::abs(_sorted_phi[position] - phi);
+            dphi = std::min(dphi, 2 * M_PI - dphi);
+            const double distance2 = deta * deta + dphi * dphi;
+            if (nearest < 0 || distance2 < nearest_distance2) {
+                nearest = _sorted_index[position];
+                nearest_distance2 = distance2;
+            }
+        }
+    };
+
+    /// step k adds the cells of the window of half-width k that were not in the window of step k - 1.
+    /// Once the window covers all the phi cells (2k + 1 > number of phi cells) only the new rows are added.
+    const int max_step = std::max(_number_eta, _number_phi);
+    for (int k = 0; k <= max_step; k++) {
+        /// the phi offsets of a full row of the window
+        const int number_offsets = std::min(2 * k + 1, _number_phi);
+        for (int eta_offset = -k; eta_offset <= k; eta_offset++) {
+            if (eta_offset == -k || eta_offset == k) {
+                for (int j = 0; j < number_offsets; j++)
+                    visitCell(center_eta + eta_offset, j - k);
+            }
+            else if (2 * k + 1 <= _number_phi) {
+                visitCell(center_eta + eta_offset, -k);
+                visitCell(center_eta + eta_offset, k);
+            }
+            /// the window just closed around phi: the cell at +k and -k is the same one
+            else if (2 * k == _number_phi)
+                visitCell(center_eta + eta_offset, k);
+        }
+        /// the particles outside the window are at least k cells away in eta or in phi
+        const double outside_distance = k * min_cell_size;
+        if (nearest >= 0 && nearest_distance2 <= outside_distance * outside_distance)
+            break;
+    }
+    return nearest;
+}
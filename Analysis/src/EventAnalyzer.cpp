@@ -14,18 +14,26 @@ const std::vector<HepMC3::ConstGenParticlePtr>& EventAnalyzer::getParticles (Par
     if (it_part_type != selected_particles.end()) 
         return it_part_type->second;
     // returns an empty vector in case the particle type is not found
-    const std::vector<HepMC3::ConstGenParticlePtr> empty;
+    static const std::vector<HepMC3::ConstGenParticlePtr> empty;
     return empty;
 }
 
-double EventAnalyzer::evaluateObservable (std::string observable_name, ParticleType particle_type) const  {
+double EventAnalyzer::evaluateObservable (const std::string& observable_name, ParticleType particle_type) const  {
     /// checking if the element is in the map
     auto it_part_type = selected_particles.find(particle_type);
     auto it_obs_name = observables.find(observable_name);
     if (it_part_type == selected_particles.end() || it_obs_name == observables.end()) 
         return -1;
     /// returns the value of the observable
-    return observables.at(observable_name)->evaluateObservable(selected_particles.at(particle_type));
+    auto it_grid = grids.find(particle_type);
+    if (it_grid != grids.end())
+        return it_obs_name->second->evaluateObservableOnGrid(it_part_type->second, it_grid->second);
+    return it_obs_name->second->evaluateObservable(it_part_type->second);
+}
+
+const EtaPhiGrid* EventAnalyzer::getGrid (ParticleType particle_type) const {
+    auto it_grid = grids.find(particle_type);
+    return it_grid != grids.end() ? &it_grid->second : nullptr;
 }
 
 
@@ -36,14 +44,43 @@ void EventAnalyzer::resetVectors () {
 }
 
 
-bool compareParticles (HepMC3::ConstGenParticlePtr part1, HepMC3::ConstGenParticlePtr part2) {
+bool compareParticles (const HepMC3::ConstGenParticlePtr& part1, const HepMC3::ConstGenParticlePtr& part2) {
     return part1->momentum().pt() > part2->momentum().pt();
 };
 
-void EventAnalyzer::analyseEvent (const HepMC3::GenEvent& hepmc3_event) {
+bool EventAnalyzer::passEventCuts (const HepMC3::GenEvent& hepmc3_event) {
+    analysed_events++;
+    if (event_cuts.empty())
+        return true;
+    /// collecting the event-level quantities in one loop over the particles
+    event_summary.fill(hepmc3_event);
+    for (EventCutEntry& cut_entry: event_cuts) {
+        if (!cut_entry.cut->passCut(event_summary))
+            return false;
+        cut_entry.passed_events++;
+    }
+    return true;
+}
+
+void EventAnalyzer::printCutFlow (std::ostream& output) const {
+    output << "Cut flow: " << analysed_events << " events" << std::endl;
+    for (const EventCutEntry& cut_entry: event_cuts)
+        output << "  " << cut_entry.name << ": " << cut_entry.passed_events << " events passed" << std::endl;
+}
+
+void EventAnalyzer::resetCutFlow () {
+    analysed_events = 0;
+    for (EventCutEntry& cut_entry: event_cuts)
+        cut_entry.passed_events = 0;
+}
+
+bool EventAnalyzer::analyseEvent (const HepMC3::GenEvent& hepmc3_event) {
     this->resetVectors();
+    /// rejects the event before the particle classification
+    if (!this->passEventCuts(hepmc3_event))
+        return false;
     // loops over the particles in the event 
-    for (auto particle: hepmc3_event.particles()) {
+    for (const HepMC3::ConstGenParticlePtr& particle: hepmc3_event.particles()) {
         /// checking if the particle fits one possible selector
         auto selector_it = selection_criterias.begin();
         for(; selector_it != selection_criterias.end(); selector_it++) {
@@ -58,4 +95,8 @@ void EventAnalyzer::analyseEvent (const HepMC3::GenEvent& hepmc3_event) {
     auto partIterator = selected_particles.begin();
     for(; partIterator != selected_particles.end(); partIterator++)
         std::sort(partIterator->second.begin(), partIterator->second.end(), compareParticles);
+    // the grids are built once the particles are in their final order
+    for (auto grid_it = grids.begin(); grid_it != grids.end(); grid_it++)
+        grid_it->second.build(getParticles(grid_it->first));
+    return true;
 }
\ No newline at end of file
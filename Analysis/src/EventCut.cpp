@@ -0,0 +1,39 @@
+#include "Analysis/EventCut.h"
+
+
+void EventSummary::fill(const HepMC3::GenEvent& hepmc3_event) {
+    hard_process_momentum = HepMC3::FourVector();
+    initial_particle_pid = 0;
+    leading_charged_pt = 0;
+    charged_multiplicity = 0;
+    double initial_particle_pt = -1;
+    /// only status codes and the PID table are used - no allocations and no virtual calls
+    for (const HepMC3::ConstGenParticlePtr& particle: hepmc3_event.particles()) {
+        const int status = particle->status();
+        if (status == 1) {
+            if (!ParticleProperties::isTrackSpecies(particle->pid()))
+                continue;
+            charged_multiplicity++;
+            leading_charged_pt = std::max(leading_charged_pt, particle->momentum().pt());
+        }
+        else if (status == 23)
+            hard_process_momentum += particle->momentum();
+        else if (status == 21 && particle->momentum().pt() > initial_particle_pt) {
+            initial_particle_pt = particle->momentum().pt();
+            initial_particle_pid = particle->abs_pid();
+        }
+    }
+}
+
+bool Q2WindowCut::passCut(const EventSummary& summary) const {
+    const double q2 = summary.q2();
+    return q2 >= _q2_min && q2 < _q2_max;
+}
+
+bool InitialPartonCut::passCut(const EventSummary& summary) const {
+    return std::find(_pids.begin(), _pids.end(), summary.initial_particle_pid) != _pids.end();
+}
+
+bool ChargedMultiplicityCut::passCut(const EventSummary& summary) const {
+    return summary.charged_multiplicity >= _min_multiplicity && summary.charged_multiplicity <= _max_multiplicity;
+}
@@ -0,0 +1,101 @@
+#include "Analysis/EventSharding.h"
+
+
+bool ShardSpec::parse(const std::string& text, ShardSpec& shard) {
+    std::size_t separator = text.find('/');
+    if (separator == std::string::npos)
+        return false;
+    try {
+        shard.index = std::stoi(text.substr(0, separator));
+        shard.count = std::stoi(text.substr(separator + 1));
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    return shard.count > 0 && shard.index >= 0 && shard.index < shard.count;
+}
+
+bool ShardProvenance::write(const std::string& filename) const {
+    std::ofstream output (filename);
+    if (!output.is_open())
+        return false;
+    output << "input " << input_file << "\n";
+    output << "output " << output_file << "\n";
+    output << "shard " << shard.index << "\n";
+    output << "shards " << shard.count << "\n";
+    output << "block_size " << block_size << "\n";
+    output << "events_per_block";
+    for (long events: events_per_block)
+        output << " " << events;
+    output << "\nrows_per_block";
+    for (long rows: rows_per_block)
+        output << " " << rows;
+    output << "\nend\n";
+    return output.good();
+}
+
+bool ShardProvenance::read(const std::string& filename, ShardProvenance& provenance) {
+    std::ifstream input (filename);
+    std::string line, key;
+    bool complete = false;
+    provenance.events_per_block.clear();
+    provenance.rows_per_block.clear();
+    while (std::getline(input, line)) {
+        std::istringstream fields (line);
+        fields >> key;
+        if (key == "input") std::getline(fields >> std::ws, provenance.input_file);
+        else if (key == "output") std::getline(fields >> std::ws, provenance.output_file);
+        else if (key == "shard") fields >> provenance.shard.index;
+        else if (key == "shards") fields >> provenance.shard.count;
+        else if (key == "block_size") fields >> provenance.block_size;
+        else if (key == "events_per_block") for (long value; fields >> value;) provenance.events_per_block.push_back(value);
+        else if (key == "rows_per_block") for (long value; fields >> value;) provenance.rows_per_block.push_back(value);
+        else if (key == "end") complete = true;
+    }
+    // the end line is the last one written, so a truncated file is detected
+    return complete && provenance.block_size > 0 && provenance.events_per_block.size() == provenance.rows_per_block.size();
+}
+
+long ShardProvenance::expectedEvents(long total_events) const {
+    long expected = 0;
+    for (long block = shard.index; block * block_size < total_events; block += shard.count)
+        expected += std::min(block_size, total_events - block * block_size);
+    return expected;
+}
+
+ShardedReader::ShardedReader(HepMC3::Reader& hepmc_file, const ShardSpec& shard, long block_size):
+    _hepmc_file(hepmc_file), _shard(shard), _block_size(block_size), _event_index(-1), _failed(block_size <= 0) {
+    if (_failed)
+        std::cout << "Invalid block size " << block_size << ", expected a positive number of events" << std::endl;
+    _provenance.shard = shard;
+    _provenance.block_size = block_size;
+}
+
+bool ShardedReader::readEvent(HepMC3::GenEvent& hepmc_event) {
+    if (_failed)
+        return false;
+    long next_event = _event_index + 1;
+    /// at the start of a block of another shard, skips to the next block of this shard
+    if (next_event % _block_size == 0 && !_shard.ownsBlock(next_event / _block_size)) {
+        long blocks_to_skip = 1;
+        while (!_shard.ownsBlock(next_event / _block_size + blocks_to_skip))
+            blocks_to_skip++;
+        _hepmc_file.skip(blocks_to_skip * _block_size);
+        next_event += blocks_to_skip * _block_size;
+    }
+    if (_hepmc_file.failed())
+        return false;
+    _hepmc_file.read_event(hepmc_event);
+    // If reading failed - there are no events left
+    if (_hepmc_file.failed())
+        return false;
+
+    _event_index = next_event;
+    /// a new block of the shard starts
+    if (_event_index % _block_size == 0 || _provenance.events_per_block.empty()) {
+        _provenance.events_per_block.push_back(0);
+        _provenance.rows_per_block.push_back(0);
+    }
+    _provenance.events_per_block.back()++;
+    return true;
+}
@@ -0,0 +1,57 @@
+#include "Analysis/EventStream.h"
+
+
+EventStream::EventStream(const std::string& filename, int max_number_particles):
+    _max_number_particles(max_number_particles), _hepmc_input(openHepMCInput(resolveInputFilename(filename))), _hepmc_file(_hepmc_input), _hepmc_event(HepMC3::Units::GEV, HepMC3::Units::MM),
+    _particle_selector({&_final_state_selector, &_charged_particle_selector}), _signal_particle_searcher(&_particle_selector) {
+    /// same selection as in select_hepmc_particles
+    _event_analyzer.addParticleSelector(ParticleType::FinalParticles, &_particle_selector);
+    _event_analyzer.addParticleSelector(ParticleType::InitialParticles, &_initial_particle_selector);
+    _event_analyzer.addParticleSelector(ParticleType::OutgoingHardProcessParticles, &_hard_process_selector);
+    _event_analyzer.addObservable("invariantMass", &_invariant_mass);
+}
+
+bool EventStream::nextBatch(EventBatch& batch, std::size_t batch_size) {
+    batch.q2.clear();
+    batch.initial_pid.clear();
+    batch.number_particles.clear();
+    batch.kinematics.clear();
+    batch.pid.clear();
+    /// the buffers are allocated once for the whole batch
+    batch.q2.reserve(batch_size);
+    batch.initial_pid.reserve(batch_size);
+    batch.number_particles.reserve(batch_size);
+    batch.kinematics.reserve(batch_size * _max_number_particles * 3);
+    batch.pid.reserve(batch_size * _max_number_particles);
+
+    while (batch.size() < batch_size && !_hepmc_file.failed()) {
+        _hepmc_file.read_event(_hepmc_event);
+        // If reading failed - exit loop
+        if (_hepmc_file.failed()) break;
+        // skips the events rejected by the event-level cuts
+        if (!_event_analyzer.analyseEvent(_hepmc_event)) continue;
+        this->addEvent(batch);
+    }
+    return batch.size() > 0;
+}
+
+void EventStream::addEvent(EventBatch& batch) {
+    const std::vector<HepMC3::ConstGenParticlePtr>& hard_proc_particles = _event_analyzer.getParticles(ParticleType::OutgoingHardProcessParticles);
+    const std::vector<HepMC3::ConstGenParticlePtr>& final_from_hard_process = _signal_particle_searcher.selectParticles(hard_proc_particles);
+
+    batch.q2.push_back(_event_analyzer.evaluateObservable("invariantMass", ParticleType::OutgoingHardProcessParticles));
+    batch.initial_pid.push_back(_event_analyzer.getParticles(ParticleType::InitialParticles).at(0)->abs_pid());
+
+    /// particles ordered by pT, zero padded up to the maximum number of particles
+    const int number_particles = std::min<int>(final_from_hard_process.size(), _max_number_particles);
+    batch.number_particles.push_back(number_particles);
+    for (int i = 0; i < number_particles; i++) {
+        const HepMC3::FourVector& momentum = final_from_hard_process[i]->momentum();
+        batch.kinematics.push_back(momentum.pt());
+        batch.kinematics.push_back(momentum.eta());
+        batch.kinematics.push_back(momentum.phi());
+        batch.pid.push_back(final_from_hard_process[i]->pid());
+    }
+    batch.kinematics.resize(batch.kinematics.size() + 3 * (_max_number_particles - number_particles), 0);
+    batch.pid.resize(batch.pid.size() + (_max_number_particles - number_particles), 0);
+}
@@ -0,0 +1,106 @@
+#include "Analysis/FileWriter.h"
+
+
+FileWriter::FileWriter(const std::string& filename, bool async, std::size_t buffer_size):
+    _filename(filename), _async(async), _buffer_size(buffer_size), _output_file(filename, std::ios::binary) {
+    _is_open = _output_file.is_open();
+    if (_async && _is_open) {
+        /// the buffers are allocated once
+        _filling_buffer.reserve(_buffer_size);
+        _flushing_buffer.reserve(_buffer_size);
+        _io_thread = std::thread(&FileWriter::ioLoop, this);
+    }
+}
+
+void FileWriter::write(const char* data, std::size_t size) {
+    if (!_is_open || _closed)
+        return;
+    _bytes_written += size;
+    if (!_async) {
+        writeToFile(data, size);
+        return;
+    }
+    if (_filling_buffer.size() + size > _buffer_size && !_filling_buffer.empty())
+        swapBuffers();
+    _filling_buffer.append(data, size);
+}
+
+void FileWriter::swapBuffers() {
+    {
+        std::unique_lock<std::mutex> lock (_mutex);
+        /// backpressure - waits for the I/O thread to finish the previous buffer
+        if (_flush_pending) {
+            _stalls++;
+            _condition.wait(lock, [this] {return !_flush_pending;});
+        }
+        std::swap(_filling_buffer, _flushing_buffer);
+        _flush_pending = true;
+    }
+    _condition.notify_all();
+    _filling_buffer.clear();
+    if (_failed)
+        reportError();
+}
+
+void FileWriter::ioLoop() {
+    std::unique_lock<std::mutex> lock (_mutex);
+    while (true) {
+        _condition.wait(lock, [this] {return _flush_pending || _stop;});
+        if (!_flush_pending)
+            break;
+        /// the analysis thread does not touch the flushing buffer while the flush is pending
+        lock.unlock();
+        writeToFile(_flushing_buffer.data(), _flushing_buffer.size());
+        lock.lock();
+        _flushing_buffer.clear();
+        _flush_pending = false;
+        _condition.notify_all();
+    }
+}
+
+void FileWriter::writeToFile(const char* data, std::size_t size) {
+    if (_failed)
+        return;
+    _output_file.write(data, size);
+    if (!_output_file.good()) {
+        std::lock_guard<std::mutex> lock (_mutex);
+        _error_message = "error writing " + _filename + ": " + std::strerror(errno);
+        _failed = true;
+    }
+}
+
+bool FileWriter::close() {
+    if (!_is_open || _closed)
+        return !_failed;
+    if (_async) {
+        if (!_filling_buffer.empty())
+            swapBuffers();
+        {
+            std::lock_guard<std::mutex> lock (_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        _io_thread.join();
+    }
+    _closed = true;
+    _output_file.close();
+    if (_output_file.fail() && !_failed) {
+        _error_message = "error closing " + _filename;
+        _failed = true;
+    }
+    if (_failed)
+        reportError();
+    return !_failed;
+}
+
+std::string FileWriter::errorMessage() {
+    std::lock_guard<std::mutex> lock (_mutex);
+    return _error_message;
+}
+
+void FileWriter::reportError() {
+    if (_error_reported)
+        return;
+    _error_reported = true;
+    std::cout << errorMessage() << std::endl;
+}
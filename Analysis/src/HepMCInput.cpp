@@ -0,0 +1,333 @@
+#include "Analysis/HepMCInput.h"
+#include <cstring>
+#include <sstream>
+#include <zlib.h>
+#ifdef ANALYSIS_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+
+/**
+ * @class - reads an uncompressed file
+ **/
+class RawInputSource: public InputSource {
+    public:
+        RawInputSource(std::FILE* file): _file(file) {};
+        ~RawInputSource() {std::fclose(_file);};
+
+        long read(char* buffer, std::size_t size) override {
+            std::size_t bytes = std::fread(buffer, 1, size, _file);
+            _offset += bytes;
+            return (bytes == 0 && std::ferror(_file)) ? -1 : long(bytes);
+        };
+
+        std::uint64_t fileOffset() const override {return _offset;};
+
+    private:
+        std::FILE* _file;
+        std::uint64_t _offset = 0;
+};
+
+/**
+ * @class - reads a gzip file with zlib
+ **/
+class GzipInputSource: public InputSource {
+    public:
+        GzipInputSource(gzFile file): _file(file) {gzbuffer(_file, 1 << 20);};
+        ~GzipInputSource() {gzclose(_file);};
+
+        long read(char* buffer, std::size_t size) override {
+            int bytes = gzread(_file, buffer, static_cast<unsigned int>(size));
+            return bytes;
+        };
+
+        std::uint64_t fileOffset() const override {return gzoffset(_file);};
+
+    private:
+        gzFile _file;
+};
+
+#ifdef ANALYSIS_WITH_ZSTD
+/**
+ * @class - reads a zstd file with the streaming API
+ **/
+class ZstdInputSource: public InputSource {
+    public:
+        ZstdInputSource(std::FILE* file): _file(file), _stream(ZSTD_createDStream()), _input_buffer(ZSTD_DStreamInSize()) {
+            ZSTD_initDStream(_stream);
+            _input = {_input_buffer.data(), 0, 0};
+        };
+        ~ZstdInputSource() {ZSTD_freeDStream(_stream); std::fclose(_file);};
+
+        long read(char* buffer, std::size_t size) override;
+
+        std::uint64_t fileOffset() const override {return _offset;};
+
+    private:
+        std::FILE* _file;
+        ZSTD_DStream* _stream;
+        std::vector<char> _input_buffer;
+        ZSTD_inBuffer _input;
+        std::uint64_t _offset = 0;
+};
+
+long ZstdInputSource::read(char* buffer, std::size_t size) {
+    ZSTD_outBuffer output = {buffer, size, 0};
+    while (output.pos == 0) {
+        /// refills the input when all of it was decompressed
+        if (_input.pos == _input.size) {
+            std::size_t bytes = std::fread(_input_buffer.data(), 1, _input_buffer.size(), _file);
+            if (bytes == 0)
+                return std::ferror(_file) ? -1 : 0;
+            _offset += bytes;
+            _input = {_input_buffer.data(), bytes, 0};
+        }
+        if (ZSTD_isError(ZSTD_decompressStream(_stream, &output, &_input)))
+            return -1;
+    }
+    return output.pos;
+}
+#endif
+
+
+Compression detectCompression(const std::string& filename) {
+    unsigned char magic[4] = {0, 0, 0, 0};
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    std::size_t bytes = 0;
+    if (file) {
+        bytes = std::fread(magic, 1, 4, file);
+        std::fclose(file);
+    }
+    if (bytes >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+        return GzipCompression;
+    if (bytes == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+        return ZstdCompression;
+    if (bytes < 4) {
+        /// falls back to the extension
+        auto hasExtension = [&filename](const std::string& extension) {
+            return filename.size() > extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+        };
+        if (hasExtension(".gz") || hasExtension(".gzip"))
+            return GzipCompression;
+        if (hasExtension(".zst") || hasExtension(".zstd"))
+            return ZstdCompression;
+    }
+    return NoCompression;
+}
+
+std::string resolveInputFilename(const std::string& filename) {
+    for (const char* extension: {"", ".gz", ".zst"}) {
+        std::FILE* file = std::fopen((filename + extension).c_str(), "rb");
+        if (file) {
+            std::fclose(file);
+            return filename + extension;
+        }
+    }
+    return filename;
+}
+
+std::unique_ptr<InputSource> makeInputSource(const std::string& filename, Compression compression) {
+    if (compression == GzipCompression) {
+        gzFile file = gzopen(filename.c_str(), "rb");
+        return file ? std::unique_ptr<InputSource>(new GzipInputSource(file)) : nullptr;
+    }
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file)
+        return nullptr;
+    if (compression == ZstdCompression) {
+#ifdef ANALYSIS_WITH_ZSTD
+        return std::unique_ptr<InputSource>(new ZstdInputSource(file));
+#else
+        std::cout << filename << " is compressed with zstd, but the analysis was built without zstd support (WITH_ZSTD=1)" << std::endl;
+        std::fclose(file);
+        return nullptr;
+#endif
+    }
+    return std::unique_ptr<InputSource>(new RawInputSource(file));
+}
+
+
+ReadAheadStreamBuf::ReadAheadStreamBuf(std::unique_ptr<InputSource> source, std::size_t chunk_size, int number_chunks):
+    _source(std::move(source)), _chunks(number_chunks, std::vector<char>(chunk_size)), _chunk_sizes(number_chunks, 0) {
+    setg(nullptr, nullptr, nullptr);
+    _reader_thread = std::thread(&ReadAheadStreamBuf::readLoop, this);
+}
+
+ReadAheadStreamBuf::~ReadAheadStreamBuf() {
+    {
+        std::lock_guard<std::mutex> lock (_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    _reader_thread.join();
+}
+
+void ReadAheadStreamBuf::readLoop() {
+    while (true) {
+        std::size_t chunk;
+        {
+            /// waits for a free chunk in the ring
+            std::unique_lock<std::mutex> lock (_mutex);
+            _condition.wait(lock, [this] {return _stop || _filled_chunks < int(_chunks.size());});
+            if (_stop)
+                return;
+            chunk = _next_to_fill;
+        }
+        /// the chunk is not visible to the parser until it is counted as filled
+        std::size_t chunk_size = 0;
+        long bytes = 1;
+        while (chunk_size < _chunks[chunk].size() && bytes > 0) {
+            bytes = _source->read(_chunks[chunk].data() + chunk_size, _chunks[chunk].size() - chunk_size);
+            if (bytes > 0)
+                chunk_size += bytes;
+        }
+        _file_offset = _source->fileOffset();
+        {
+            std::lock_guard<std::mutex> lock (_mutex);
+            if (bytes < 0)
+                _failed = true;
+            if (chunk_size > 0) {
+                _chunk_sizes[chunk] = chunk_size;
+                _next_to_fill = (_next_to_fill + 1) % _chunks.size();
+                _filled_chunks++;
+            }
+            if (bytes <= 0)
+                _end_of_file = true;
+        }
+        _condition.notify_all();
+        if (bytes <= 0)
+            return;
+    }
+}
+
+ReadAheadStreamBuf::int_type ReadAheadStreamBuf::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    std::unique_lock<std::mutex> lock (_mutex);
+    /// the chunk that was parsed goes back to the reader thread
+    if (_holds_chunk) {
+        _holds_chunk = false;
+        _next_to_read = (_next_to_read + 1) % _chunks.size();
+        _filled_chunks--;
+        _condition.notify_all();
+    }
+    _condition.wait(lock, [this] {return _filled_chunks > 0 || _end_of_file;});
+    if (_filled_chunks == 0) {
+        if (_failed)
+            std::cout << "Error reading the input file" << std::endl;
+        return traits_type::eof();
+    }
+    _holds_chunk = true;
+    char* chunk_begin = _chunks[_next_to_read].data();
+    setg(chunk_begin, chunk_begin, chunk_begin + _chunk_sizes[_next_to_read]);
+    return traits_type::to_int_type(*gptr());
+}
+
+
+/// @brief - splitmix64 finaliser of the seed and the position of the event
+static std::uint64_t mixEvent(std::uint64_t seed, long event) {
+    std::uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (std::uint64_t(event) + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+bool EventSampling::keepsEvent(long event) const {
+    if (isPastLastEvent(event) || event % prescale != 0)
+        return false;
+    /// uniform number in [0, 1) from the top 53 bits
+    return fraction >= 1 || (mixEvent(seed, event) >> 11) * 0x1.0p-53 < fraction;
+}
+
+std::string EventSampling::description() const {
+    std::ostringstream text;
+    text << (max_events >= 0 ? "the first " + std::to_string(max_events) + " events" : std::string("all the events"));
+    if (prescale > 1)
+        text << ", one in " << prescale;
+    if (fraction < 1)
+        text << ", a fraction " << fraction << " (seed " << seed << ")";
+    return text.str();
+}
+
+
+EventSamplingStreamBuf::EventSamplingStreamBuf(std::streambuf* source, const EventSampling& sampling, std::size_t chunk_size):
+    _source(source), _sampling(sampling), _buffer(chunk_size) {
+    setg(nullptr, nullptr, nullptr);
+}
+
+EventSamplingStreamBuf::int_type EventSamplingStreamBuf::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    /// a chunk can have no line to pass (inside a long skipped event), then the next one is read
+    while (!_finished) {
+        char* const begin = _buffer.data();
+        const std::streamsize size = _source->sgetn(begin, _buffer.size());
+        if (size <= 0) {
+            _finished = true;
+            break;
+        }
+        const char* read = begin;
+        const char* const end = begin + size;
+        char* write = begin;
+        while (read < end) {
+            /// the first character of the line gives its type: 'E' starts an event, 'H' is the header or the footer
+            if (_at_line_start) {
+                if (*read == 'E') {
+                    if (_sampling.isPastLastEvent(_next_event)) {
+                        _finished = true;
+                        break;
+                    }
+                    _passing = _sampling.keepsEvent(_next_event);
+                    if (_passing)
+                        _passed_events.push_back(_next_event);
+                    _next_event++;
+                }
+                else if (*read == 'H')
+                    _passing = true;
+            }
+            const char* line_end = static_cast<const char*>(std::memchr(read, '\n', end - read));
+            const char* next = line_end ? line_end + 1 : end;
+            /// a line cut by the end of the chunk continues in the next one
+            _at_line_start = line_end != nullptr;
+            if (_passing) {
+                if (write != read)
+                    std::memmove(write, read, next - read);
+                write += next - read;
+            }
+            read = next;
+        }
+        if (write > begin) {
+            setg(begin, begin, write);
+            return traits_type::to_int_type(*gptr());
+        }
+    }
+    return traits_type::eof();
+}
+
+
+HepMCInputStream::HepMCInputStream(const std::string& filename, const EventSampling& sampling): std::istream(nullptr), _compression(detectCompression(filename)), _file_size(0) {
+    std::unique_ptr<InputSource> source = makeInputSource(filename, _compression);
+    if (!source) {
+        setstate(std::ios::failbit);
+        return;
+    }
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file) {
+        std::fseek(file, 0, SEEK_END);
+        _file_size = std::ftell(file);
+        std::fclose(file);
+    }
+    _buffer.reset(new ReadAheadStreamBuf(std::move(source)));
+    rdbuf(_buffer.get());
+    if (sampling.isSampling()) {
+        _sampling_buffer.reset(new EventSamplingStreamBuf(_buffer.get(), sampling));
+        rdbuf(_sampling_buffer.get());
+    }
+}
+
+std::shared_ptr<HepMCInputStream> openHepMCInput(const std::string& filename, const EventSampling& sampling) {
+    std::shared_ptr<HepMCInputStream> input = std::make_shared<HepMCInputStream>(filename, sampling);
+    if (!input->is_open())
+        std::cout << "Could not open " << filename << std::endl;
+    return input;
+}
@@ -0,0 +1,108 @@
+#include "Analysis/Instrumentation.h"
+#include "Analysis/SimdKernels.h"
+#include <fstream>
+#include <cstdio>
+
+
+const char* stageName(EventLoopStage stage) {
+    switch (stage) {
+        case ReadStage: return "read";
+        case OverlayStage: return "overlay";
+        case SelectStage: return "select";
+        case SearchStage: return "search";
+        case ObservablesStage: return "observables";
+        case ClusterStage: return "cluster";
+        case DetectorStage: return "detector";
+        case WriteStage: return "write";
+        default: return "unknown";
+    }
+}
+
+std::string jsonString(const std::string& value) {
+    std::string quoted = "\"";
+    for (char character: value) {
+        if (character == '"' || character == '\\') {
+            quoted += '\\';
+            quoted += character;
+        }
+        else if ((unsigned char) character < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char) character);
+            quoted += escape;
+        }
+        else
+            quoted += character;
+    }
+    return quoted + '"';
+}
+
+#ifdef ANALYSIS_WITH_INSTRUMENTATION
+
+EventLoopMonitor::EventLoopMonitor(const std::string& name, std::uint64_t file_size, long progress_interval):
+    _name(name), _file_size(file_size), _progress_interval(progress_interval), _start(std::chrono::steady_clock::now()) {}
+
+double EventLoopMonitor::elapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+}
+
+void EventLoopMonitor::printProgress(std::ostream& output) const {
+    const double elapsed = elapsedSeconds();
+    char line[256];
+    int size = std::snprintf(line, sizeof(line), "Reached %ld events, %.0f evt/s", _events, elapsed > 0 ? _events / elapsed : 0.);
+    // the ETA assumes the remaining bytes of the file are read at the same rate
+    if (_file_size > 0 && _bytes_read > 0) {
+        const double fraction = double(_bytes_read) / _file_size;
+        const double eta = fraction < 1 ? elapsed * (1 - fraction) / fraction : 0;
+        size += std::snprintf(line + size, sizeof(line) - size, ", %.1f%% of the file, ETA %.0f s", 100 * fraction, eta);
+    }
+    output << line << std::endl;
+}
+
+void EventLoopMonitor::writeSummary(std::ostream& output) const {
+    const double elapsed = elapsedSeconds();
+    double stages_seconds = 0;
+    for (int stage = 0; stage < NumberOfStages; stage++)
+        stages_seconds += std::chrono::duration<double>(_stage_time[stage]).count();
+
+    char buffer[256];
+    output << "{\n  \"sample\": " << jsonString(_name) << ",\n";
+    output << "  \"simd_level\": \"" << simdLevelName(simdKernels().level) << "\",\n";
+    std::snprintf(buffer, sizeof(buffer), "  \"events\": %ld,\n  \"written_events\": %ld,\n  \"seconds\": %.6g,\n  \"events_per_second\": %.6g,\n",
+                  _events, _written_events, elapsed, elapsed > 0 ? _events / elapsed : 0.);
+    output << buffer;
+    std::snprintf(buffer, sizeof(buffer), "  \"particles_per_event\": %.6g,\n  \"written_particles_per_event\": %.6g,\n",
+                  _events > 0 ? double(_particles) / _events : 0., _written_events > 0 ? double(_written_particles) / _written_events : 0.);
+    output << buffer;
+    std::snprintf(buffer, sizeof(buffer), "  \"bytes_read\": %llu,\n  \"file_size\": %llu,\n  \"bytes_written\": %llu,\n",
+                  (unsigned long long) _bytes_read, (unsigned long long) _file_size, (unsigned long long) _bytes_written);
+    output << buffer;
+    // time of each stage, its share of the loop and its cost per event
+    output << "  \"stages\": {";
+    for (int stage = 0; stage < NumberOfStages; stage++) {
+        const double seconds = std::chrono::duration<double>(_stage_time[stage]).count();
+        std::snprintf(buffer, sizeof(buffer), "%s\n    \"%s\": {\"seconds\": %.6g, \"fraction\": %.4f, \"us_per_event\": %.6g",
+                      stage == 0 ? "" : ",", stageName(EventLoopStage(stage)), seconds, elapsed > 0 ? seconds / elapsed : 0.,
+                      _events > 0 ? 1e6 * seconds / _events : 0.);
+        output << buffer;
+#ifdef ANALYSIS_COUNT_ALLOCATIONS
+        std::snprintf(buffer, sizeof(buffer), ", \"allocations_per_event\": %.6g, \"bytes_per_event\": %.6g",
+                      _events > 0 ? double(_stage_allocations[stage].allocations) / _events : 0.,
+                      _events > 0 ? double(_stage_allocations[stage].bytes) / _events : 0.);
+        output << buffer;
+#endif
+        output << "}";
+    }
+    // time outside the timed stages (loop bookkeeping, cut flow, ...)
+    std::snprintf(buffer, sizeof(buffer), "\n  },\n  \"untimed_seconds\": %.6g\n}\n", elapsed > stages_seconds ? elapsed - stages_seconds : 0.);
+    output << buffer;
+}
+
+bool EventLoopMonitor::writeSummary(const std::string& filename) const {
+    std::ofstream output_file (filename);
+    if (!output_file.is_open())
+        return false;
+    writeSummary(output_file);
+    return output_file.good();
+}
+
+#endif
@@ -1,25 +1,158 @@
 #include "Analysis/JetClustering.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
 
 
-std::vector<fastjet::PseudoJet> JetClustering::convertParticlesToPseudoJets(const std::vector<HepMC3::ConstGenParticlePtr> &particles) const {
-    /// vector a vector with the same number of entries as the vector o hepmc3 particles
-    std::vector<fastjet::PseudoJet> final_pseudo_jets (particles.size(), fastjet::PseudoJet());
+const std::vector<fastjet::PseudoJet>& JetClustering::convertParticlesToPseudoJets(const std::vector<HepMC3::ConstGenParticlePtr> &particles) {
+    /// the buffer keeps its memory, so it only allocates until it fits the largest event
+    _pseudo_jets.resize(particles.size());
 
     /// transforming the hepmc3 particles to pseudo jets
-    for (int i = 0; i < particles.size(); i++) {
-        const HepMC3::FourVector momentum = particles[i]->momentum();
+    for (std::size_t i = 0; i < particles.size(); i++) {
+        const HepMC3::FourVector& momentum = particles[i]->momentum();
         /// updating the jet momentum
-        final_pseudo_jets[i].reset_momentum(momentum.px(), momentum.py(), momentum.pz(), momentum.e());
-        /// including the hepmc information as user info
-        final_pseudo_jets[i].set_user_info(new HepMC3Info(particles[i]->pid()));
+        _pseudo_jets[i].reset_momentum(momentum.px(), momentum.py(), momentum.pz(), momentum.e());
+        /// including the pid as user index
+        _pseudo_jets[i].set_user_index(particles[i]->pid());
     }
 
-    return final_pseudo_jets;
+    return _pseudo_jets;
 }
 
-std::vector<fastjet::PseudoJet> JetClustering::clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles)  {
+const std::vector<HepMC3::ConstGenParticlePtr> JetClustering::_no_truth_particles;
+
+void JetClustering::addTruthGhosts(const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles) {
+    const std::size_t number_ghosts = std::min<std::size_t>(truth_particles.size(), max_truth_ghosts);
+    for (std::size_t i = 0; i < number_ghosts; i++) {
+        const HepMC3::FourVector& momentum = truth_particles[i]->momentum();
+        /// without pt the ghost has no direction
+        if (momentum.pt() <= 0.)
+            continue;
+        /// the scaled momentum keeps the rapidity and phi of the particle
+        _pseudo_jets.emplace_back(ghost_scale * momentum.px(), ghost_scale * momentum.py(), ghost_scale * momentum.pz(), ghost_scale * momentum.e());
+        _pseudo_jets.back().set_user_index(truth_ghost_index + int(i));
+    }
+}
+
+/// @brief - flavour of a parton (0 for the particles that are not quarks or gluons)
+static JetFlavour partonFlavour(int pid) {
+    const int abs_pid = std::abs(pid);
+    if (abs_pid == 5) return BottomFlavour;
+    if (abs_pid == 4) return CharmFlavour;
+    if (abs_pid == 21) return GluonFlavour;
+    if (abs_pid >= 1 && abs_pid <= 3) return LightFlavour;
+    return NoFlavour;
+}
+
+void JetClustering::labelJets(const std::vector<fastjet::PseudoJet>& jets, const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles) {
+    _jet_flavours.assign(jets.size(), JetFlavourInfo {NoFlavour, 0, false});
+    if (truth_particles.empty())
+        return;
+    const double jet_radius = _jet_definition.R();
+    for (std::size_t i = 0; i < jets.size(); i++) {
+        JetFlavourInfo& label = _jet_flavours[i];
+        /// ghost membership: a b hadron, then a c hadron, then the hardest parton
+        int hadron_pid = 0, parton_pid = 0;
+        double parton_pt = -1.;
+        for (const fastjet::PseudoJet& constituent: jets[i].constituents()) {
+            if (!isTruthGhost(constituent))
+                continue;
+            const HepMC3::ConstGenParticlePtr& truth_particle = truth_particles[constituent.user_index() - truth_ghost_index];
+            const int pid = truth_particle->pid();
+            if (ParticleProperties::isHeavyFlavourHadron(pid)) {
+                if (hadron_pid == 0 || (ParticleProperties::hasBottom(pid) && !ParticleProperties::hasBottom(hadron_pid)))
+                    hadron_pid = pid;
+            }
+            else if (partonFlavour(pid) != NoFlavour && truth_particle->momentum().pt() > parton_pt) {
+                parton_pid = pid;
+                parton_pt = truth_particle->momentum().pt();
+            }
+        }
+        if (hadron_pid != 0)
+            label = {ParticleProperties::hasBottom(hadron_pid) ? BottomFlavour : CharmFlavour, hadron_pid, true};
+        else if (parton_pid != 0)
+            label = {partonFlavour(parton_pid), parton_pid, true};
+        else {
+            /// fallback for the jets without ghosts: the closest parton within the jet radius
+            double closest_delta_r = jet_radius;
+            for (const HepMC3::ConstGenParticlePtr& truth_particle: truth_particles) {
+                const HepMC3::FourVector& momentum = truth_particle->momentum();
+                if (partonFlavour(truth_particle->pid()) == NoFlavour || momentum.pt() <= 0.)
+                    continue;
+                const double dy = momentum.rap() - jets[i].rap();
+                const double dphi = std::remainder(momentum.phi() - jets[i].phi(), 2 * M_PI);
+                const double delta_r = std::sqrt(dy * dy + dphi * dphi);
+                if (delta_r < closest_delta_r) {
+                    closest_delta_r = delta_r;
+                    label = {partonFlavour(truth_particle->pid()), truth_particle->pid(), false};
+                }
+            }
+        }
+    }
+}
+
+int JetClustering::numberConstituents(const fastjet::PseudoJet& jet) {
+    int number_constituents = 0;
+    for (const fastjet::PseudoJet& constituent: jet.constituents())
+        if (!isTruthGhost(constituent))
+            number_constituents++;
+    return number_constituents;
+}
+
+std::vector<fastjet::PseudoJet> JetClustering::clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles,
+                                                            const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles)  {
+    convertParticlesToPseudoJets(particles);
+    addTruthGhosts(truth_particles);
     /// defining the fastjet cluster sequence to cluster the jets - reconstructing the jets
-    _cluster_seq = fastjet::ClusterSequence(convertParticlesToPseudoJets(particles), _jet_definition);
-    /// returning the jets with pT greater the min pt and sorted by pt
-    return fastjet::sorted_by_pt(_cluster_seq.inclusive_jets(_min_pt));
-}
\ No newline at end of file
+    _cluster_seq = fastjet::ClusterSequence(_pseudo_jets, _jet_definition);
+    /// the jets with pT greater the min pt and sorted by pt
+    std::vector<fastjet::PseudoJet> jets = fastjet::sorted_by_pt(_cluster_seq.inclusive_jets(_min_pt));
+    labelJets(jets, truth_particles);
+    return jets;
+}
+
+
+SubtractedJetClustering::SubtractedJetClustering(double jet_radius, double min_pt, fastjet::JetAlgorithm jet_algorithm, BackgroundEstimator estimator, const BackgroundSettings& settings):
+    JetClustering(jet_radius, min_pt, jet_algorithm), _estimator_type(estimator), _max_eta(settings.max_rapidity), _shared_clustering(false),
+    _area_definition(fastjet::active_area, fastjet::GhostedAreaSpec(settings.max_rapidity, 1, settings.ghost_area)) {
+    if (estimator == GridMedianEstimator)
+        _background_estimator.reset(new fastjet::GridMedianBackgroundEstimator(settings.max_rapidity, settings.grid_spacing));
+    else {
+        /// only kT jets fully inside the acceptance and without the leading ones enter the median
+        const fastjet::Selector rho_range = fastjet::SelectorAbsRapMax(settings.max_rapidity - settings.kt_radius) * (!fastjet::SelectorNHardest(settings.n_hardest_removed));
+        const fastjet::JetDefinition kt_definition(fastjet::kt_algorithm, settings.kt_radius);
+        _shared_clustering = jet_algorithm == fastjet::kt_algorithm && jet_radius == settings.kt_radius;
+        _background_estimator.reset(new fastjet::JetMedianBackgroundEstimator(rho_range, kt_definition, _area_definition));
+    }
+    _subtractor = fastjet::Subtractor(_background_estimator.get());
+}
+
+std::vector<fastjet::PseudoJet> SubtractedJetClustering::clusterJets (const std::vector<HepMC3::ConstGenParticlePtr>& particles,
+                                                                      const std::vector<HepMC3::ConstGenParticlePtr>& truth_particles) {
+    /// the conversion is done only once for the jets and the background
+    convertParticlesToPseudoJets(particles);
+    /// the ghosts only cover the acceptance, a particle outside it would get a jet without area (|rapidity| <= |eta|)
+    _pseudo_jets.erase(std::remove_if(_pseudo_jets.begin(), _pseudo_jets.end(),
+                                      [this](const fastjet::PseudoJet& particle) {return std::abs(particle.eta()) > _max_eta;}),
+                       _pseudo_jets.end());
+    const bool with_truth = !truth_particles.empty();
+    if (with_truth)
+        _background_particles.assign(_pseudo_jets.begin(), _pseudo_jets.end());
+    addTruthGhosts(truth_particles);
+    /// reconstructing the jets and their areas
+    _cluster_seq_area.reset(new fastjet::ClusterSequenceArea(_pseudo_jets, _jet_definition, _area_definition));
+
+    /// estimating rho for the event, without the truth ghosts
+    if (_estimator_type == KtJetMedianEstimator && _shared_clustering && !with_truth)
+        static_cast<fastjet::JetMedianBackgroundEstimator*>(_background_estimator.get())->set_cluster_sequence(*_cluster_seq_area);
+    else
+        _background_estimator->set_particles(with_truth ? _background_particles : _pseudo_jets);
+
+    /// rho * A >= 0, so jets below the min pt before the subtraction are also below it after the subtraction
+    const std::vector<fastjet::PseudoJet> subtracted_jets = _subtractor(_cluster_seq_area->inclusive_jets(_min_pt));
+    /// the subtracted jets with pT greater the min pt and sorted by pt
+    std::vector<fastjet::PseudoJet> jets = fastjet::sorted_by_pt(fastjet::SelectorPtMin(_min_pt)(subtracted_jets));
+    labelJets(jets, truth_particles);
+    return jets;
+}
@@ -0,0 +1,234 @@
+#include "Analysis/JetObservables.h"
+#include "Analysis/JetClustering.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <atomic>
+
+
+/// @brief - names of the prime EFPs, in the order of the features
+static const char* efp_names[8] = {"edge", "double_edge", "wedge", "triple_edge", "double_edge_edge", "triangle", "path4", "star3"};
+/// @brief - number of prime EFPs up to each degree
+static const int efp_counts[4] = {0, 1, 3, 8};
+
+/// @brief - value of "<prefix><value>" used in the feature names
+static std::string label(const char* prefix, double value) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%s%g", prefix, value);
+    return buffer;
+}
+
+int JetObservableSettings::numberFeatures() const {
+    return angularities.size() + 4 * correlator_betas.size() + efp_counts[efp_max_degree] * efp_betas.size();
+}
+
+std::vector<std::string> JetObservableSettings::featureNames() const {
+    std::vector<std::string> names;
+    for (const std::pair<double, double>& angularity: angularities)
+        names.push_back(label("lambda_k", angularity.first) + label("_b", angularity.second));
+    for (double beta: correlator_betas)
+        for (const char* name: {"e2", "e3", "c2", "d2"})
+            names.push_back(name + label("_b", beta));
+    for (double beta: efp_betas)
+        for (int i = 0; i < efp_counts[efp_max_degree]; i++)
+            names.push_back(label("efp_b", beta) + "_" + efp_names[i]);
+    return names;
+}
+
+bool JetObservableSettings::parse(const std::vector<std::string>& words, std::size_t first) {
+    for (std::size_t i = first; i < words.size(); i++) {
+        if (words[i] == "angularity" && i + 2 < words.size()) {
+            angularities.emplace_back(std::atof(words[i + 1].c_str()), std::atof(words[i + 2].c_str()));
+            i += 2;
+        }
+        else if (words[i] == "ecf" && i + 1 < words.size())
+            correlator_betas.push_back(std::atof(words[++i].c_str()));
+        else if (words[i] == "efp" && i + 2 < words.size()) {
+            /// one maximum degree for all the betas, so every EFP block has the same length
+            const int max_degree = std::atoi(words[i + 2].c_str());
+            if (max_degree < 1 || max_degree > 3 || (!efp_betas.empty() && max_degree != efp_max_degree))
+                return false;
+            efp_betas.push_back(std::atof(words[i + 1].c_str()));
+            efp_max_degree = max_degree;
+            i += 2;
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
+
+JetObservableCalculator::JetObservableCalculator(const JetObservableSettings& settings, int number_threads):
+    _settings(settings), _number_features(settings.numberFeatures()), _number_threads(std::max(1, number_threads)), _workspaces(_number_threads), _kernels(&simdKernels()) {
+    for (const std::vector<double>* betas: {&_settings.correlator_betas, &_settings.efp_betas})
+        for (double beta: *betas)
+            if (std::find(_betas.begin(), _betas.end(), beta) == _betas.end())
+                _betas.push_back(beta);
+}
+
+void JetObservableCalculator::fillConstituents(const fastjet::PseudoJet& jet, Workspace& workspace) const {
+    workspace.z.clear();
+    workspace.rap.clear();
+    workspace.phi.clear();
+    double sum_pt = 0.;
+    /// is_pure_ghost throws on the jets of a plain ClusterSequence, which have no area ghosts
+    const bool with_area = jet.has_area();
+    if (jet.has_constituents())
+        for (const fastjet::PseudoJet& constituent: jet.constituents()) {
+            if ((with_area && constituent.is_pure_ghost()) || JetClustering::isTruthGhost(constituent))
+                continue;
+            workspace.z.push_back(constituent.pt());
+            workspace.rap.push_back(constituent.rap());
+            workspace.phi.push_back(constituent.phi());
+            sum_pt += constituent.pt();
+        }
+    const std::size_t n = workspace.z.size();
+    if (sum_pt > 0.)
+        for (double& z: workspace.z)
+            z /= sum_pt;
+
+    /// distances to the jet axis and between the constituents, with phi in [0, 2pi)
+    workspace.axis_distance.resize(n);
+    workspace.distance2.resize(n * n);
+    _kernels->axis_distance(workspace.rap.data(), workspace.phi.data(), n, jet.rap(), jet.phi(), workspace.axis_distance.data());
+    _kernels->pairwise_distance2(workspace.rap.data(), workspace.phi.data(), n, workspace.distance2.data());
+}
+
+void JetObservableCalculator::evaluate(const fastjet::PseudoJet& jet, double* features) {
+    evaluateJet(jet, _workspaces[0], features);
+}
+
+void JetObservableCalculator::evaluate(const std::vector<fastjet::PseudoJet>& jets, std::vector<double>& features) {
+    features.resize(jets.size() * _number_features);
+    const int number_threads = std::min<int>(_number_threads, jets.size());
+    if (number_threads <= 1) {
+        for (std::size_t i = 0; i < jets.size(); i++)
+            evaluateJet(jets[i], _workspaces[0], features.data() + i * _number_features);
+        return;
+    }
+    /// the jets are taken one at a time, so a thread with large jets does not hold the others back
+    std::atomic<std::size_t> next_jet (0);
+    auto worker = [&](Workspace& workspace) {
+        for (std::size_t i = next_jet++; i < jets.size(); i = next_jet++)
+            evaluateJet(jets[i], workspace, features.data() + i * _number_features);
+    };
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < number_threads; thread++)
+        threads.emplace_back(worker, std::ref(_workspaces[thread]));
+    worker(_workspaces[0]);
+    for (std::thread& thread: threads)
+        thread.join();
+}
+
+void JetObservableCalculator::evaluateJet(const fastjet::PseudoJet& jet, Workspace& workspace, double* features) const {
+    fillConstituents(jet, workspace);
+    const std::size_t n = workspace.z.size();
+    const double* z = workspace.z.data();
+    std::fill(features, features + _number_features, 0.);
+    if (n == 0)
+        return;
+
+    /// angularities
+    double* feature = features;
+    for (const std::pair<double, double>& angularity: _settings.angularities) {
+        const double kappa = angularity.first, beta = angularity.second;
+        double sum = 0.;
+        for (std::size_t i = 0; i < n; i++)
+            sum += (kappa == 1. ? z[i] : std::pow(z[i], kappa)) * std::pow(workspace.axis_distance[i] / _settings.jet_radius, beta);
+        *feature++ = sum;
+    }
+    double* correlator_features = feature;
+    double* efp_features = correlator_features + 4 * _settings.correlator_betas.size();
+    const int number_efps = efp_counts[_settings.efp_max_degree];
+
+    workspace.theta.resize(n * n);
+    workspace.row_sum1.resize(n);
+    workspace.row_sum2.resize(n);
+    workspace.row_sum3.resize(n);
+    workspace.z_row_sum1.resize(n);
+    for (double beta: _betas) {
+        const bool correlator = std::find(_settings.correlator_betas.begin(), _settings.correlator_betas.end(), beta) != _settings.correlator_betas.end();
+        const bool efp = std::find(_settings.efp_betas.begin(), _settings.efp_betas.end(), beta) != _settings.efp_betas.end();
+
+        /// theta_ij = (deltaR_ij^2)^(beta / 2), without pow for the usual betas
+        const double* distance2 = workspace.distance2.data();
+        double* theta = workspace.theta.data();
+        if (beta == 2.)
+            std::copy(distance2, distance2 + n * n, theta);
+        else if (beta == 1.)
+            _kernels->sqrt_values(distance2, n * n, theta);
+        else
+            for (std::size_t k = 0; k < n * n; k++)
+                theta[k] = std::pow(distance2[k], 0.5 * beta);
+
+        double* row_sum1 = workspace.row_sum1.data();
+        for (std::size_t i = 0; i < n; i++)
+            row_sum1[i] = _kernels->dot2(z, theta + i * n, n);
+        const double e2 = 0.5 * _kernels->dot2(z, row_sum1, n);
+
+        /// e3 - the only O(n^3) sum, over i < j < k
+        double e3 = 0.;
+        if (correlator || (efp && _settings.efp_max_degree >= 3))
+            for (std::size_t i = 0; i < n; i++) {
+                const double* theta_i = theta + i * n;
+                for (std::size_t j = i + 1; j < n; j++) {
+                    const double weight = z[i] * z[j] * theta_i[j];
+                    if (weight == 0.)
+                        continue;
+                    const double* theta_j = theta + j * n;
+                    e3 += weight * _kernels->dot3(z + j + 1, theta_i + j + 1, theta_j + j + 1, n - j - 1);
+                }
+            }
+
+        if (correlator)
+            for (std::size_t c = 0; c < _settings.correlator_betas.size(); c++) {
+                if (_settings.correlator_betas[c] != beta)
+                    continue;
+                double* values = correlator_features + 4 * c;
+                values[0] = e2;
+                values[1] = e3;
+                values[2] = e2 > 0. ? e3 / (e2 * e2) : 0.;
+                values[3] = e2 > 0. ? e3 / (e2 * e2 * e2) : 0.;
+            }
+        if (!efp)
+            continue;
+
+        /// the EFPs over all the ordered tuples of constituents (theta_ii = 0), from the row sums of theta, theta^2 and theta^3
+        double* row_sum2 = workspace.row_sum2.data();
+        double* row_sum3 = workspace.row_sum3.data();
+        double* z_row_sum1 = workspace.z_row_sum1.data();
+        double values[8] = {2. * e2, 0., 0., 0., 0., 6. * e3, 0., 0.};
+        for (std::size_t i = 0; i < n; i++) {
+            const double* theta_i = theta + i * n;
+            row_sum2[i] = _kernels->dot3(z, theta_i, theta_i, n);
+            z_row_sum1[i] = z[i] * row_sum1[i];
+        }
+        if (_settings.efp_max_degree >= 3)
+            for (std::size_t i = 0; i < n; i++) {
+                const double* theta_i = theta + i * n;
+                double sum = 0.;
+                for (std::size_t j = 0; j < n; j++)
+                    sum += z[j] * theta_i[j] * theta_i[j] * theta_i[j];
+                row_sum3[i] = sum;
+            }
+        for (std::size_t i = 0; i < n; i++) {
+            const double a = row_sum1[i];
+            values[1] += z[i] * row_sum2[i];
+            values[2] += z_row_sum1[i] * a;
+            if (_settings.efp_max_degree < 3)
+                continue;
+            values[3] += z[i] * row_sum3[i];
+            values[4] += z[i] * row_sum2[i] * a;
+            /// path i-j-k-l: sum_jk z_j a_j theta_jk z_k a_k
+            values[6] += z_row_sum1[i] * _kernels->dot2(z_row_sum1, theta + i * n, n);
+            values[7] += z_row_sum1[i] * a * a;
+        }
+        for (std::size_t e = 0; e < _settings.efp_betas.size(); e++)
+            if (_settings.efp_betas[e] == beta)
+                std::copy(values, values + number_efps, efp_features + number_efps * e);
+    }
+}
@@ -0,0 +1,81 @@
+#include "Analysis/JetSubstructure.h"
+#include "Analysis/JetClustering.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <utility>
+
+
+/// @brief - smallest angle and kt in the logarithms (exactly collinear constituents would give -inf in the output)
+static const double min_log_argument = 1e-12;
+
+JetDeclustering::JetDeclustering(double jet_radius, const std::vector<SoftDropSettings>& softdrop_settings):
+    _jet_radius(jet_radius), _softdrop_settings(softdrop_settings),
+    _ca_definition(fastjet::cambridge_algorithm, fastjet::JetDefinition::max_allowable_R),
+    _softdrop_results(softdrop_settings.size()) {}
+
+std::string JetDeclustering::description(const SoftDropSettings& settings) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "beta=%g zcut=%g", settings.beta, settings.z_cut);
+    return buffer;
+}
+
+bool JetDeclustering::decluster(const fastjet::PseudoJet& jet) {
+    _constituents.clear();
+    _primary_branch.clear();
+    _splittings.clear();
+    /// only the jets with areas have area ghosts, is_pure_ghost throws on the jets of a plain ClusterSequence
+    const bool with_area = jet.has_area();
+    if (jet.has_constituents())
+        for (const fastjet::PseudoJet& constituent: jet.constituents())
+            if (!(with_area && constituent.is_pure_ghost()) && !JetClustering::isTruthGhost(constituent))
+                _constituents.push_back(constituent);
+    if (_constituents.empty()) {
+        std::fill(_softdrop_results.begin(), _softdrop_results.end(), SoftDropResult {0., 0., 0, 0});
+        _primary_branch.push_back(jet);
+        return false;
+    }
+
+    /// one reclustering per jet, every observable comes from its tree
+    _cluster_seq = fastjet::ClusterSequence(_constituents, _ca_definition);
+    fastjet::PseudoJet node = _cluster_seq.exclusive_jets(1)[0], harder, softer;
+    _primary_branch.push_back(node);
+    while (node.has_parents(harder, softer)) {
+        if (softer.pt2() > harder.pt2())
+            std::swap(harder, softer);
+        const double harder_pt = harder.pt(), softer_pt = softer.pt();
+        LundSplitting splitting;
+        splitting.delta = harder.delta_R(softer);
+        splitting.kt = softer_pt * splitting.delta;
+        splitting.z = softer_pt / (harder_pt + softer_pt);
+        splitting.psi = std::atan2(softer.rap() - harder.rap(), harder.delta_phi_to(softer));
+        splitting.ln_one_over_delta = -std::log(std::max(splitting.delta, min_log_argument));
+        splitting.ln_kt = std::log(std::max(splitting.kt, min_log_argument));
+        _splittings.push_back(splitting);
+        /// the primary branch follows the harder parent
+        node = harder;
+        _primary_branch.push_back(node);
+    }
+    groom();
+    return true;
+}
+
+void JetDeclustering::groom() {
+    for (std::size_t setting = 0; setting < _softdrop_settings.size(); setting++) {
+        const SoftDropSettings& settings = _softdrop_settings[setting];
+        /// groomed down to the last node of the primary branch if no splitting passes
+        SoftDropResult result {0., 0., 0, int(_primary_branch.size()) - 1};
+        for (std::size_t i = 0; i < _splittings.size(); i++) {
+            const LundSplitting& splitting = _splittings[i];
+            if (splitting.z <= settings.z_cut * std::pow(splitting.delta / _jet_radius, settings.beta))
+                continue;
+            /// the first splitting that passes stops the grooming, the later ones only count for n_sd
+            if (result.n_sd++ == 0) {
+                result.z_g = splitting.z;
+                result.r_g = splitting.delta;
+                result.groomed_index = i;
+            }
+        }
+        _softdrop_results[setting] = result;
+    }
+}
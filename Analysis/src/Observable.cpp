@@ -1,4 +1,5 @@
 #include "Analysis/Observable.h"
+#include <cmath>
 
 
 double InvariantMass::evaluateObservable(const std::vector<HepMC3::ConstGenParticlePtr>& particles) const {
@@ -8,4 +9,39 @@ double InvariantMass::evaluateObservable(const std::vector<HepMC3::ConstGenParti
         total_momentum += particle->momentum();
     
     return total_momentum.m();
-}
\ No newline at end of file
+}
+
+/// @brief - position of the highest pT particle (-1 if there are no particles)
+static int leadingParticle(const std::vector<HepMC3::ConstGenParticlePtr>& particles) {
+    int leading = -1;
+    for (std::size_t i = 0; i < particles.size(); i++)
+        if (leading < 0 || particles[i]->momentum().pt() > particles[leading]->momentum().pt())
+            leading = i;
+    return leading;
+}
+
+double LeadingParticleDensity::evaluateObservable(const std::vector<HepMC3::ConstGenParticlePtr>& particles) const {
+    const int leading = leadingParticle(particles);
+    if (leading < 0)
+        return 0.;
+    /// brute force: distance from the leading particle to every other particle
+    const double eta = particles[leading]->momentum().eta(), phi = particles[leading]->momentum().phi();
+    int count = 0;
+    for (std::size_t i = 0; i < particles.size(); i++) {
+        if (int(i) == leading) continue;
+        const double deta = particles[i]->momentum().eta() - eta;
+        const double dphi = std::remainder(particles[i]->momentum().phi() - phi, 2 * M_PI);
+        if (deta * deta + dphi * dphi < _radius * _radius)
+            count++;
+    }
+    return count / (M_PI * _radius * _radius);
+}
+
+double LeadingParticleDensity::evaluateObservableOnGrid(const std::vector<HepMC3::ConstGenParticlePtr>& particles, const EtaPhiGrid& grid) const {
+    const int leading = leadingParticle(particles);
+    if (leading < 0)
+        return 0.;
+    /// the count of the grid includes the leading particle itself
+    const int count = grid.countWithinDeltaR(grid.eta(leading), grid.phi(leading), _radius) - 1;
+    return count / (M_PI * _radius * _radius);
+}
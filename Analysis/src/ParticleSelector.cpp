@@ -1,4 +1,5 @@
 #include "Analysis/ParticleSelector.h"
+#include "HepMC3/GenVertex.h"
 
 
 bool MultipleParticleSelectors::selectParticle(HepMC3::ConstGenParticlePtr particle) const {
@@ -11,6 +12,25 @@ bool MultipleParticleSelectors::selectParticle(HepMC3::ConstGenParticlePtr parti
 }
 
 bool ChargedParticlesSelector::selectParticle(HepMC3::ConstGenParticlePtr particle) const {
-    /// checks if the particle pid is in the list of allowed charged particles
-    return _charged_part_pids.find(particle->abs_pid()) != _charged_part_pids.end();
-}
\ No newline at end of file
+    /// checks if the particle is one of the track species or in the list of additional charged particles
+    if (ParticleProperties::isTrackSpecies(particle->pid()))
+        return true;
+    return !_extra_charged_part_pids.empty() && _extra_charged_part_pids.find(particle->abs_pid()) != _extra_charged_part_pids.end();
+}
+bool HeavyFlavourHadronSelector::selectParticle(HepMC3::ConstGenParticlePtr particle) const {
+    const int pid = particle->pid();
+    if (!ParticleProperties::isHeavyFlavourHadron(pid))
+        return false;
+    /// the flavour that must not appear again in the decay (the b of a B_c, which decays first)
+    const bool bottom = ParticleProperties::hasBottom(pid);
+    const HepMC3::ConstGenVertexPtr& end_vertex = particle->end_vertex();
+    if (!end_vertex)
+        return true;
+    for (const HepMC3::ConstGenParticlePtr& daughter: end_vertex->particles_out()) {
+        if (!ParticleProperties::isHadron(daughter->pid()))
+            continue;
+        if (bottom ? ParticleProperties::hasBottom(daughter->pid()) : ParticleProperties::hasCharm(daughter->pid()))
+            return false;
+    }
+    return true;
+}
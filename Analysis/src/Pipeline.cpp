@@ -0,0 +1,554 @@
+#include "Analysis/Pipeline.h"
+
+
+bool PipelineConfig::read(const std::string& filename, PipelineConfig& config) {
+    std::ifstream input (filename);
+    if (!input.is_open()) {
+        std::cout << "Could not open the config " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    int line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+        // comments
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        std::istringstream fields (line);
+        ConfigEntry entry {line_number, {}};
+        for (std::string word; fields >> word;)
+            entry.words.push_back(word);
+        if (entry.words.empty())
+            continue;
+
+        const std::string& key = entry.words[0];
+        bool valid = true;
+        if (key == "input" && entry.words.size() == 2)
+            config.inputs.push_back(entry.words[1]);
+        else if (key == "output_dir" && entry.words.size() == 2)
+            config.output_dir = entry.words[1];
+        else if (key == "shard" && entry.words.size() == 2)
+            valid = ShardSpec::parse(entry.words[1], config.shard);
+        else if (key == "block_size" && entry.words.size() == 2)
+            valid = (std::istringstream(entry.words[1]) >> config.block_size) && config.block_size > 0;
+        else if (key == "async_output" && entry.words.size() == 2)
+            config.async_output = entry.words[1] == "1" || entry.words[1] == "true";
+        else if (key == "overlay" || key == "detector" || key == "select" || key == "cut" || key == "observable" || key == "jets" || key == "sink")
+            config.entries.push_back(entry);
+        else
+            valid = false;
+        if (!valid) {
+            std::cout << filename << ":" << line_number << ": invalid entry '" << line << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void JetsSink::writeEvent(const PipelineEvent& event) {
+    const std::vector<fastjet::PseudoJet>& jets = event.jets[_jets_index];
+    const int number_jets = std::min<int>(jets.size(), _max_number_jets);
+    char buffer[160];
+    _line.clear();
+    _line.append(buffer, std::snprintf(buffer, sizeof(buffer), "%d", int(jets.size())));
+    for (int i = 0; i < number_jets; i++) {
+        _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g,%g,%g,%g,%d", jets[i].pt(), jets[i].eta(), jets[i].phi_std(),
+                                           jets[i].m(), JetClustering::numberConstituents(jets[i])));
+        if (_with_flavour)
+            _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%d", int(event.jet_flavours[_jets_index][i].flavour)));
+    }
+    for (int i = number_jets; i < _max_number_jets; i++)
+        _line += _with_flavour ? ",0,0,0,0,0,0" : ",0,0,0,0,0";
+    _line += "\n";
+    _output_file.write(_line);
+}
+
+void SubstructureSink::writeEvent(const PipelineEvent& event) {
+    const std::vector<fastjet::PseudoJet>& jets = event.jets[_jets_index];
+    const int number_jets = std::min<int>(jets.size(), _max_number_jets);
+    const int number_softdrop = _declustering.softDropSettings().size();
+    char buffer[160];
+    _line.clear();
+    _line.append(buffer, std::snprintf(buffer, sizeof(buffer), "%d", int(jets.size())));
+    for (int i = 0; i < number_jets; i++) {
+        _declustering.decluster(jets[i]);
+        const std::vector<LundSplitting>& splittings = _declustering.primaryLundPlane();
+        const std::vector<SoftDropResult>& softdrop = _declustering.softDrop();
+        _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g,%d", jets[i].pt(), int(splittings.size())));
+        for (int setting = 0; setting < number_softdrop; setting++)
+            _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g,%g,%g", softdrop[setting].z_g, softdrop[setting].r_g,
+                                               _declustering.groomedJet(setting).m()));
+        const int number_splittings = std::min<int>(splittings.size(), _max_number_splittings);
+        for (int j = 0; j < number_splittings; j++)
+            _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g,%g,%g,%g", splittings[j].ln_one_over_delta, splittings[j].ln_kt,
+                                               splittings[j].z, splittings[j].psi));
+        for (int j = number_splittings; j < _max_number_splittings; j++)
+            _line += ",0,0,0,0";
+    }
+    for (int i = number_jets; i < _max_number_jets; i++) {
+        _line += ",0,0";
+        for (int j = 0; j < 3 * number_softdrop + 4 * _max_number_splittings; j++)
+            _line += ",0";
+    }
+    _line += "\n";
+    _output_file.write(_line);
+}
+
+void JetObservablesSink::writeEvent(const PipelineEvent& event) {
+    const std::vector<fastjet::PseudoJet>& jets = event.jets[_jets_index];
+    const int number_jets = std::min<int>(jets.size(), _max_number_jets);
+    char buffer[64];
+    _line.clear();
+    _line.append(buffer, std::snprintf(buffer, sizeof(buffer), "%d", int(jets.size())));
+    for (int i = 0; i < number_jets; i++) {
+        _calculator.evaluate(jets[i], _features.data());
+        _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g", jets[i].pt()));
+        for (double feature: _features)
+            _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g", feature));
+    }
+    for (int i = number_jets; i < _max_number_jets; i++)
+        for (std::size_t j = 0; j <= _features.size(); j++)
+            _line += ",0";
+    _line += "\n";
+    _output_file.write(_line);
+}
+
+void RawParticlesSink::writeEvent(const PipelineEvent& event) {
+    const std::vector<HepMC3::ConstGenParticlePtr>& particles = event.particles(_source);
+    char buffer[128];
+    _line.clear();
+    _line.append(buffer, std::snprintf(buffer, sizeof(buffer), "%ld,%d", event.event_index, int(particles.size())));
+    for (const HepMC3::ConstGenParticlePtr& particle: particles) {
+        const HepMC3::FourVector& momentum = particle->momentum();
+        _line.append(buffer, std::snprintf(buffer, sizeof(buffer), ",%g,%g,%g,%d", momentum.pt(), momentum.eta(), momentum.phi(), particle->pid()));
+        if (_with_background)
+            _line += event.isBackground(particle) ? ",1" : ",0";
+    }
+    _line += "\n";
+    _output_file.write(_line);
+}
+
+
+PipelineRunner::PipelineRunner(const PipelineConfig& config): _config(config) {
+    for (const ConfigEntry& entry: _config.entries) {
+        const std::string& key = entry.words[0];
+        bool valid;
+        if (key == "overlay") valid = addOverlay(entry);
+        else if (key == "detector") valid = addDetector(entry);
+        else if (key == "select") valid = addSelection(entry);
+        else if (key == "cut") valid = addCut(entry);
+        else if (key == "observable") valid = addObservable(entry);
+        else if (key == "jets") valid = addClustering(entry);
+        else valid = addSink(entry);
+        if (!valid) {
+            _configured = false;
+            return;
+        }
+    }
+    if (_sink_definitions.empty()) {
+        std::cout << "The config has no sinks" << std::endl;
+        _configured = false;
+    }
+    else if (_needs_signal && !_final_selector) {
+        std::cout << "The signal particles need a final selection" << std::endl;
+        _configured = false;
+    }
+    else if (_needs_signal)
+        _signal_particle_searcher.reset(new SignalParticlesSearcher(_final_selector));
+    // the heavy-flavour hadrons that label the jets, with the partons of the hard selection
+    if (_needs_truth) {
+        _selectors.emplace_back(new HeavyFlavourHadronSelector());
+        _event_analyzer.addParticleSelector(ParticleType::HeavyFlavourHadrons, _selectors.back().get());
+    }
+}
+
+bool PipelineRunner::configError(const ConfigEntry& entry, const std::string& message) {
+    std::cout << "config line " << entry.line << ": " << message << std::endl;
+    return false;
+}
+
+bool PipelineRunner::addOverlay(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    if (words.size() != 4 && words.size() != 5)
+        return configError(entry, "expected overlay <soft hepmc file | .pool cache> <background events per event> <pool size> [seed]");
+    if (_overlay)
+        return configError(entry, "only one overlay is allowed");
+    const int events_per_signal = std::atoi(words[2].c_str());
+    const long pool_size = std::atol(words[3].c_str());
+    const std::uint64_t seed = words.size() == 5 ? std::strtoull(words[4].c_str(), nullptr, 10) : 1;
+    if (events_per_signal <= 0 || pool_size < events_per_signal)
+        return configError(entry, "the pool must have at least one event per event");
+    _background_pool.reset(new BackgroundPool());
+    if (!_background_pool->open(words[1], pool_size))
+        return configError(entry, "could not build the background pool");
+    std::cout << "Overlaying " << events_per_signal << " of " << _background_pool->numberEvents() << " background events ("
+              << double(_background_pool->numberParticles()) / _background_pool->numberEvents() << " particles/event) on each event" << std::endl;
+    _overlay.reset(new UnderlyingEventOverlay(*_background_pool, events_per_signal, seed));
+    return true;
+}
+
+bool PipelineRunner::addDetector(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    if (words.size() != 2 && words.size() != 3)
+        return configError(entry, "expected detector <response file> [seed]");
+    if (_detector_response)
+        return configError(entry, "only one detector response is allowed");
+    const std::uint64_t seed = words.size() == 3 ? std::strtoull(words[2].c_str(), nullptr, 10) : 1;
+    _detector_response.reset(new DetectorResponse(seed));
+    if (!_detector_response->read(words[1]))
+        return configError(entry, "could not read the detector response");
+    return true;
+}
+
+bool PipelineRunner::parseSource(const std::string& name, ParticleSource& source) {
+    if (name == "final") source = FinalSource;
+    else if (name == "initial") source = InitialSource;
+    else if (name == "hard") source = HardSource;
+    else if (name == "signal") source = SignalSource;
+    else return false;
+    _needs_signal = _needs_signal || source == SignalSource;
+    return true;
+}
+
+bool PipelineRunner::addSelection(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    if (words.size() < 3)
+        return configError(entry, "expected select <final|initial|hard> <selectors>");
+    ParticleType particle_type;
+    if (words[1] == "final") particle_type = ParticleType::FinalParticles;
+    else if (words[1] == "initial") particle_type = ParticleType::InitialParticles;
+    else if (words[1] == "hard") particle_type = ParticleType::OutgoingHardProcessParticles;
+    else return configError(entry, "unknown particle type " + words[1]);
+
+    std::vector<const ParticleSelector*> selectors;
+    for (std::size_t i = 2; i < words.size(); i++) {
+        if (words[i] == "final_state")
+            _selectors.emplace_back(new FinalStateSelector());
+        else if (words[i] == "charged")
+            _selectors.emplace_back(new ChargedParticlesSelector());
+        else if (words[i] == "status" && i + 1 < words.size())
+            _selectors.emplace_back(new StatusCodeSelection(std::atoi(words[++i].c_str())));
+        else
+            return configError(entry, "unknown selector " + words[i]);
+        selectors.push_back(_selectors.back().get());
+    }
+    // several selectors must all pass
+    if (selectors.size() > 1)
+        _selectors.emplace_back(new MultipleParticleSelectors(selectors));
+    _event_analyzer.addParticleSelector(particle_type, _selectors.back().get());
+    if (particle_type == ParticleType::FinalParticles)
+        _final_selector = _selectors.back().get();
+    return true;
+}
+
+bool PipelineRunner::addCut(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    if (words.size() < 3)
+        return configError(entry, "expected cut <type> <values>");
+    std::vector<double> values;
+    for (std::size_t i = 2; i < words.size(); i++)
+        values.push_back(std::atof(words[i].c_str()));
+    if (words[1] == "q2_window" && values.size() == 2)
+        _cuts.emplace_back(new Q2WindowCut(values[0], values[1]));
+    else if (words[1] == "initial_parton")
+        _cuts.emplace_back(new InitialPartonCut(std::vector<int>(values.begin(), values.end())));
+    else if (words[1] == "leading_charged_pt" && values.size() == 1)
+        _cuts.emplace_back(new LeadingChargedPtCut(values[0]));
+    else if (words[1] == "charged_multiplicity" && values.size() == 1)
+        _cuts.emplace_back(new ChargedMultiplicityCut(int(values[0])));
+    else if (words[1] == "charged_multiplicity" && values.size() == 2)
+        _cuts.emplace_back(new ChargedMultiplicityCut(int(values[0]), int(values[1])));
+    else
+        return configError(entry, "unknown cut " + words[1]);
+    _event_analyzer.addEventCut(words[1], _cuts.back().get());
+    return true;
+}
+
+bool PipelineRunner::addObservable(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    ParticleSource source;
+    if (words.size() != 4 || !parseSource(words[3], source))
+        return configError(entry, "expected observable <name> invariant_mass <source>");
+    if (words[2] == "invariant_mass")
+        _observable_storage.emplace_back(new InvariantMass());
+    else
+        return configError(entry, "unknown observable " + words[2]);
+    _observables.push_back({_observable_storage.back().get(), source});
+    _observable_names.push_back(words[1]);
+    return true;
+}
+
+bool PipelineRunner::addClustering(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    ParticleSource source;
+    /// the truth labels are asked for by a last word "truth"
+    const bool truth = words.size() > 6 && words.back() == "truth";
+    const std::size_t number_words = truth ? words.size() - 1 : words.size();
+    if ((number_words != 6 && number_words != 7) || !parseSource(words[5], source))
+        return configError(entry, "expected jets <name> <antikt|kt|cambridge> <R> <min pt> <source> [grid|ktmedian] [truth]");
+    fastjet::JetAlgorithm algorithm;
+    if (words[2] == "antikt") algorithm = fastjet::antikt_algorithm;
+    else if (words[2] == "kt") algorithm = fastjet::kt_algorithm;
+    else if (words[2] == "cambridge") algorithm = fastjet::cambridge_algorithm;
+    else return configError(entry, "unknown jet algorithm " + words[2]);
+    const double jet_radius = std::atof(words[3].c_str()), min_pt = std::atof(words[4].c_str());
+
+    ClusteringDefinition definition;
+    definition.source = source;
+    definition.truth = truth;
+    _needs_truth = _needs_truth || truth;
+    if (number_words == 6)
+        definition.clustering.reset(new JetClustering(jet_radius, min_pt, algorithm));
+    else if (words[6] == "grid")
+        definition.clustering.reset(new SubtractedJetClustering(jet_radius, min_pt, algorithm, GridMedianEstimator));
+    else if (words[6] == "ktmedian")
+        definition.clustering.reset(new SubtractedJetClustering(jet_radius, min_pt, algorithm, KtJetMedianEstimator));
+    else
+        return configError(entry, "unknown background estimator " + words[6]);
+    _clusterings.push_back(std::move(definition));
+    _clustering_names.push_back(words[1]);
+    return true;
+}
+
+bool PipelineRunner::addSink(const ConfigEntry& entry) {
+    const std::vector<std::string>& words = entry.words;
+    if (words.size() < 3)
+        return configError(entry, "expected sink <type> <suffix> ...");
+    SinkDefinition definition {words[1], words[2], FinalSource, -1, 0};
+    /// the names are resolved to indices here, once
+    if (definition.type == "particles" && (words.size() == 6 || (words.size() == 7 && words[6] == "detector"))
+        && parseSource(words[3], definition.source)) {
+        auto it_observable = std::find(_observable_names.begin(), _observable_names.end(), words[4]);
+        if (it_observable == _observable_names.end())
+            return configError(entry, "unknown observable " + words[4] + " (observables must be defined before the sinks)");
+        definition.index = it_observable - _observable_names.begin();
+        definition.max_number = std::atoi(words[5].c_str());
+        /// the tracks of the detector response instead of the particles
+        definition.detector = words.size() == 7;
+        if (definition.detector && !_detector_response)
+            return configError(entry, "no detector response (the detector entry must be defined before the sinks)");
+        _needs_tracks[definition.source] = _needs_tracks[definition.source] || definition.detector;
+    }
+    else if (definition.type == "jets" && words.size() == 5) {
+        auto it_clustering = std::find(_clustering_names.begin(), _clustering_names.end(), words[3]);
+        if (it_clustering == _clustering_names.end())
+            return configError(entry, "unknown jets " + words[3] + " (jets must be defined before the sinks)");
+        definition.index = it_clustering - _clustering_names.begin();
+        definition.max_number = std::atoi(words[4].c_str());
+    }
+    else if (definition.type == "substructure" && words.size() >= 6 && words.size() % 2 == 0) {
+        auto it_clustering = std::find(_clustering_names.begin(), _clustering_names.end(), words[3]);
+        if (it_clustering == _clustering_names.end())
+            return configError(entry, "unknown jets " + words[3] + " (jets must be defined before the sinks)");
+        definition.index = it_clustering - _clustering_names.begin();
+        definition.max_number = std::atoi(words[4].c_str());
+        definition.max_splittings = std::atoi(words[5].c_str());
+        definition.jet_radius = _clusterings[definition.index].clustering->jetRadius();
+        for (std::size_t i = 6; i < words.size(); i += 2)
+            definition.softdrop_settings.push_back({std::atof(words[i].c_str()), std::atof(words[i + 1].c_str())});
+        if (definition.softdrop_settings.empty())
+            definition.softdrop_settings.push_back(SoftDropSettings());
+    }
+    else if (definition.type == "jet_observables" && words.size() >= 6) {
+        auto it_clustering = std::find(_clustering_names.begin(), _clustering_names.end(), words[3]);
+        if (it_clustering == _clustering_names.end())
+            return configError(entry, "unknown jets " + words[3] + " (jets must be defined before the sinks)");
+        definition.index = it_clustering - _clustering_names.begin();
+        definition.max_number = std::atoi(words[4].c_str());
+        definition.jet_observables.jet_radius = _clusterings[definition.index].clustering->jetRadius();
+        if (!definition.jet_observables.parse(words, 5))
+            return configError(entry, "invalid jet observables, expected angularity <kappa> <beta>, ecf <beta> or efp <beta> <max degree> "
+                                      "(the same max degree for all the efps)");
+    }
+    else if (definition.type == "raw" && words.size() == 4 && parseSource(words[3], definition.source)) {}
+    else
+        return configError(entry, "invalid sink, expected particles <suffix> <source> <q2 observable> <max particles> [detector], "
+                                  "jets <suffix> <jets name> <max jets>, substructure <suffix> <jets name> <max jets> <max splittings> [<beta> <z_cut>] ..., "
+                                  "jet_observables <suffix> <jets name> <max jets> <observables> ... "
+                                  "or raw <suffix> <source>");
+    _sink_definitions.push_back(definition);
+    return true;
+}
+
+std::string PipelineRunner::sampleName(const std::string& input_filename) {
+    std::string sample = input_filename.substr(input_filename.find_last_of('/') + 1);
+    for (const char* extension: {".gz", ".zst", ".hepmc", ".hepmc3", ".skim"}) {
+        const std::string suffix = extension;
+        if (sample.size() > suffix.size() && sample.compare(sample.size() - suffix.size(), suffix.size(), suffix) == 0)
+            sample.erase(sample.size() - suffix.size());
+    }
+    return sample;
+}
+
+std::string PipelineRunner::outputFilename(const std::string& sample, const std::string& suffix, const std::string& extension) const {
+    std::string filename = _config.output_dir + "/" + sample + "_" + suffix;
+    if (_config.shard.isSharded())
+        filename += "_shard_" + std::to_string(_config.shard.index) + "_of_" + std::to_string(_config.shard.count);
+    return filename + extension;
+}
+
+bool PipelineRunner::runAll() {
+    if (!_configured)
+        return false;
+    bool success = true;
+    for (const std::string& input_filename: _config.inputs)
+        success = run(input_filename) && success;
+    return success;
+}
+
+bool PipelineRunner::run(const std::string& input_filename) {
+    if (!_configured)
+        return false;
+    const std::string hepmc3_filename = resolveInputFilename(input_filename);
+    // the skims (see SkimFormat.h) are read directly, the HepMC3 files through the read-ahead stream
+    std::shared_ptr<HepMCInputStream> hepmc_input;
+    std::unique_ptr<SkimReader> skim_file;
+    std::unique_ptr<HepMC3::ReaderAscii> ascii_file;
+    if (isSkimFilename(hepmc3_filename)) {
+        skim_file.reset(new SkimReader(hepmc3_filename));
+        if (skim_file->readFailed())
+            return false;
+    }
+    else {
+        hepmc_input = openHepMCInput(hepmc3_filename);
+        if (!hepmc_input->is_open()) {
+            std::cout << "Could not open " << input_filename << std::endl;
+            return false;
+        }
+        ascii_file.reset(new HepMC3::ReaderAscii(hepmc_input));
+    }
+    HepMC3::Reader& hepmc_file = skim_file ? static_cast<HepMC3::Reader&>(*skim_file) : *ascii_file;
+    auto file_offset = [&]() {return skim_file ? skim_file->fileOffset() : hepmc_input->fileOffset();};
+    const std::string sample = sampleName(input_filename);
+    std::cout << "analysing file " << hepmc3_filename << std::endl;
+    ShardedReader sharded_reader (hepmc_file, _config.shard, _config.block_size);
+    HepMC3::GenEvent hepmc_event (HepMC3::Units::GEV, HepMC3::Units::MM);
+
+    // the sinks write one file per input
+    std::vector<std::unique_ptr<EventSink>> sinks;
+    for (const SinkDefinition& definition: _sink_definitions) {
+        const std::string filename = outputFilename(sample, definition.suffix);
+        if (definition.type == "particles")
+            sinks.emplace_back(new ParticlesSink(filename, definition.source, definition.index, definition.max_number, definition.detector, _config.async_output));
+        else if (definition.type == "jets")
+            sinks.emplace_back(new JetsSink(filename, definition.index, definition.max_number, _clusterings[definition.index].truth, _config.async_output));
+        else if (definition.type == "jet_observables")
+            sinks.emplace_back(new JetObservablesSink(filename, definition.index, definition.max_number, definition.jet_observables, _config.async_output));
+        else if (definition.type == "substructure")
+            sinks.emplace_back(new SubstructureSink(filename, definition.index, definition.max_number, definition.max_splittings,
+                                                    definition.jet_radius, definition.softdrop_settings, _config.async_output));
+        else
+            sinks.emplace_back(new RawParticlesSink(filename, definition.source, bool(_overlay), _config.async_output));
+    }
+
+    PipelineEvent event;
+    event.observables.resize(_observables.size());
+    event.jets.resize(_clusterings.size());
+    event.jet_flavours.resize(_clusterings.size());
+    event._particles[FinalSource] = &_event_analyzer.getParticles(ParticleType::FinalParticles);
+    event._particles[InitialSource] = &_event_analyzer.getParticles(ParticleType::InitialParticles);
+    event._particles[HardSource] = &_event_analyzer.getParticles(ParticleType::OutgoingHardProcessParticles);
+    event._particles[SignalSource] = &_event_analyzer.getParticles(ParticleType::FinalParticles);
+
+    // the analyzer is shared by the inputs, the cut flow printed at the end is the one of this input
+    _event_analyzer.resetCutFlow();
+    EventLoopMonitor monitor (sample, skim_file ? skim_file->fileSize() : hepmc_input->fileSize());
+    while (true) {
+        StageTimer read_timer (monitor, ReadStage);
+        if (!sharded_reader.readEvent(hepmc_event)) break;
+        read_timer.stop();
+        // the background is added before everything else sees the event
+        if (_overlay) {
+            StageTimer overlay_timer (monitor, OverlayStage);
+            _overlay->overlay(hepmc_event, sharded_reader.eventIndex());
+            event._first_background_id = _overlay->firstBackgroundId();
+        }
+        monitor.countEvent(hepmc_event.particles().size());
+        if (monitor.progressDue()) {
+            monitor.setBytesRead(file_offset());
+            monitor.printProgress();
+        }
+
+        // selecting the particles - skips the event if it fails the event-level cuts
+        StageTimer select_timer (monitor, SelectStage);
+        if (!_event_analyzer.analyseEvent(hepmc_event)) continue;
+        select_timer.stop();
+        event.event_index = sharded_reader.eventIndex();
+
+        // everything the sinks need is computed once
+        if (_needs_signal) {
+            StageTimer search_timer (monitor, SearchStage);
+            event._particles[SignalSource] = &_signal_particle_searcher->selectParticles(event.particles(HardSource));
+        }
+        StageTimer observables_timer (monitor, ObservablesStage);
+        for (std::size_t i = 0; i < _observables.size(); i++)
+            event.observables[i] = _observables[i].observable->evaluateObservable(event.particles(_observables[i].source));
+        observables_timer.stop();
+        StageTimer cluster_timer (monitor, ClusterStage);
+        if (_needs_truth) {
+            const std::vector<HepMC3::ConstGenParticlePtr>& hadrons = _event_analyzer.getParticles(ParticleType::HeavyFlavourHadrons);
+            _truth_particles.assign(event.particles(HardSource).begin(), event.particles(HardSource).end());
+            _truth_particles.insert(_truth_particles.end(), hadrons.begin(), hadrons.end());
+        }
+        for (std::size_t i = 0; i < _clusterings.size(); i++) {
+            if (!_clusterings[i].truth) {
+                event.jets[i] = _clusterings[i].clustering->clusterJets(event.particles(_clusterings[i].source));
+                continue;
+            }
+            event.jets[i] = _clusterings[i].clustering->clusterJets(event.particles(_clusterings[i].source), _truth_particles);
+            event.jet_flavours[i] = _clusterings[i].clustering->jetFlavours();
+        }
+        cluster_timer.stop();
+        // detector response of the sources written as tracks
+        if (_detector_response) {
+            StageTimer detector_timer (monitor, DetectorStage);
+            for (int source = 0; source < 4; source++)
+                if (_needs_tracks[source])
+                    _detector_response->apply(event.particles(ParticleSource(source)), event.event_index, event._tracks[source]);
+        }
+
+        // fan out to all the sinks
+        StageTimer write_timer (monitor, WriteStage);
+        for (std::unique_ptr<EventSink>& sink: sinks)
+            sink->writeEvent(event);
+        sharded_reader.addOutputRow();
+        write_timer.stop();
+        monitor.countWrittenEvent(event.particles(FinalSource).size());
+    }
+
+    _event_analyzer.printCutFlow();
+    bool success = skim_file ? !skim_file->readFailed() : !hepmc_input->readFailed();
+    if (!success)
+        std::cout << "Failed to read " << hepmc3_filename << std::endl;
+
+    std::uint64_t bytes_written = 0;
+    {
+        StageTimer write_timer (monitor, WriteStage);
+        for (std::unique_ptr<EventSink>& sink: sinks) {
+            if (!sink->close()) {
+                std::cout << "Failed to write " << sink->filename() << std::endl;
+                success = false;
+            }
+            bytes_written += sink->bytesWritten();
+        }
+    }
+    monitor.setBytesRead(file_offset());
+    monitor.setBytesWritten(bytes_written);
+    monitor.writeSummary(std::cout);
+    if (!monitor.writeSummary(outputFilename(sample, "stats", ".json")))
+        std::cout << "Could not write the summary of " << sample << std::endl;
+
+    // provenance of each output, needed by merge_shards
+    if (_config.shard.isSharded()) {
+        ShardProvenance& provenance = sharded_reader.provenance();
+        provenance.input_file = hepmc3_filename;
+        for (std::unique_ptr<EventSink>& sink: sinks) {
+            provenance.output_file = sink->filename();
+            if (!provenance.write(ShardProvenance::provenanceFilename(sink->filename())))
+                std::cout << "Could not write the provenance of " << sink->filename() << std::endl;
+        }
+    }
+    return success;
+}
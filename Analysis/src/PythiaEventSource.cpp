@@ -0,0 +1,41 @@
+#include "Analysis/PythiaEventSource.h"
+#include <mutex>
+
+
+PythiaEventSource::PythiaEventSource(const std::vector<std::string>& settings, long seed, const GenerationFilterSettings& filter_settings):
+    _pythia("../share/Pythia8/xmldoc", false), _filter(filter_settings) {
+    _pythia.readString("Random:setSeed = on");
+    _pythia.readString("Random:seed = " + std::to_string(seed));
+    _pythia.readString("Next:numberCount = 0"); // the progress of the sources would be interleaved
+    for (const std::string& setting: settings)
+        _pythia.readString(setting);
+}
+
+bool PythiaEventSource::initialize() {
+    // the initialization reads the xml database and the LHAPDF grids, which is not thread safe
+    static std::mutex init_mutex;
+    std::lock_guard<std::mutex> lock (init_mutex);
+    return _pythia.init();
+}
+
+bool PythiaEventSource::nextEvent(HepMC3::GenEvent& hepmc_event) {
+    int consecutive_failures = 0;
+    while (true) {
+        if (!_pythia.next()) {
+            _failed_events++;
+            if (++consecutive_failures >= max_consecutive_failures)
+                return false;
+            continue;
+        }
+        consecutive_failures = 0;
+        // the rejected events are dropped before the conversion
+        if (_filter.accept(_pythia.event))
+            break;
+        if (_filter.acceptedEvents() == 0 && _filter.testedEvents() >= max_rejected_events)
+            return false;
+    }
+    hepmc_event.clear();
+    _to_hepmc.fill_next_event(_pythia, &hepmc_event, _generated_events);
+    _generated_events++;
+    return true;
+}
@@ -1,31 +1,48 @@
 #include "Analysis/SignalParticlesSearcher.h"
 
 const std::vector<HepMC3::ConstGenParticlePtr>& SignalParticlesSearcher::selectParticles(const std::vector<HepMC3::ConstGenParticlePtr>& hard_particles){
-    /// clear all the vector
-    _vertices.clear();
+    /// clear the vector and start a new search - the visited flags of the previous one become stale
     _final_particles.clear();
+    if (++_search_number == 0) {
+        std::fill(_visited_vertices.begin(), _visited_vertices.end(), 0);
+        std::fill(_visited_particles.begin(), _visited_particles.end(), 0);
+        _search_number = 1;
+    }
     /// performing the search for each particle
-    for (HepMC3::ConstGenParticlePtr particle: hard_particles)
+    for (const HepMC3::ConstGenParticlePtr& particle: hard_particles)
         this->searchParticles(particle);
     /// sort the particles by pT
     std::sort(_final_particles.begin(), _final_particles.end(), compareParticles);
     return _final_particles;
 }
 
-void SignalParticlesSearcher::searchParticles(HepMC3::ConstGenParticlePtr incomming_particle) {
+bool SignalParticlesSearcher::markVisited(std::vector<std::uint32_t>& visited, int index) {
+    /// the vector only grows until it fits the largest event
+    if (index >= int(visited.size()))
+        visited.resize(index + 1, 0);
+    if (visited[index] == _search_number)
+        return false;
+    visited[index] = _search_number;
+    return true;
+}
+
+void SignalParticlesSearcher::searchParticles(const HepMC3::ConstGenParticlePtr& incomming_particle) {
     // check if the particle is a final state particle
     if (_selector->selectParticle(incomming_particle)) {
-        /// check if the particle is not already in the vector 
-        std::vector<HepMC3::ConstGenParticlePtr>::iterator it = std::find(_final_particles.begin(), _final_particles.end(), incomming_particle);
-        if (it == _final_particles.end())
+        /// check if the particle is not already in the vector (particles outside an event have no id)
+        const int particle_id = incomming_particle->id();
+        if (particle_id > 0 ? markVisited(_visited_particles, particle_id - 1) :
+            std::find(_final_particles.begin(), _final_particles.end(), incomming_particle) == _final_particles.end())
             _final_particles.push_back(incomming_particle);
         return;
     }
-    // only go to the vertex if we did not look at it before
-    if (incomming_particle->status() != 1 && _vertices.find(incomming_particle->end_vertex()) == _vertices.end()) {
-        _vertices.insert(incomming_particle->end_vertex());
-        // look at every outgoing particle from the vertex
-        for (HepMC3::ConstGenParticlePtr outgoing_particle: incomming_particle->end_vertex()->particles_out())
-            this->searchParticles(outgoing_particle);
-    }
-}
\ No newline at end of file
+    if (incomming_particle->status() == 1)
+        return;
+    // only go to the vertex if we did not look at it before (vertices outside an event have no id)
+    const HepMC3::ConstGenVertexPtr end_vertex = incomming_particle->end_vertex();
+    if (!end_vertex || (end_vertex->id() < 0 && !markVisited(_visited_vertices, -end_vertex->id() - 1)))
+        return;
+    // look at every outgoing particle from the vertex
+    for (const HepMC3::ConstGenParticlePtr& outgoing_particle: end_vertex->particles_out())
+        this->searchParticles(outgoing_particle);
+}
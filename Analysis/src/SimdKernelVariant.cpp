@@ -0,0 +1,150 @@
+/// The kernels of one level of SimdKernels.h. The Makefile compiles this file once per level with the flags of the level,
+/// ANALYSIS_SIMD_KERNELS (name of the table) and ANALYSIS_SIMD_VARIANT (its SimdLevel).
+/// Everything here has internal linkage and no standard header is included: an inline function of a header compiled with
+/// the AVX2 or AVX-512 flags could be the copy the linker keeps for the whole program, and then crash the older CPUs.
+
+#include "Analysis/SimdKernels.h"
+
+#ifndef ANALYSIS_SIMD_KERNELS
+#define ANALYSIS_SIMD_KERNELS generic_kernels
+#define ANALYSIS_SIMD_VARIANT GenericSimd
+#endif
+
+namespace {
+
+const double two_pi = 6.283185307179586476925286766559;
+
+/// @brief - deltaR^2 in (rap, phi), with the same operations as min(|dphi|, 2pi - |dphi|) in the scalar code
+inline double distance2(double drap, double dphi) {
+    const double absolute_dphi = __builtin_fabs(dphi);
+    const double other_way = two_pi - absolute_dphi;
+    const double wrapped_dphi = other_way < absolute_dphi ? other_way : absolute_dphi;
+    return drap * drap + wrapped_dphi * wrapped_dphi;
+}
+
+void pairwiseDistance2(const double* rap, const double* phi, std::size_t n, double* distance2_matrix) {
+    for (std::size_t i = 0; i < n; i++) {
+        const double rap_i = rap[i], phi_i = phi[i];
+        double* row = distance2_matrix + i * n;
+        for (std::size_t j = 0; j < n; j++)
+            row[j] = distance2(rap[j] - rap_i, phi[j] - phi_i);
+    }
+}
+
+void axisDistance(const double* rap, const double* phi, std::size_t n, double axis_rap, double axis_phi, double* distance) {
+    for (std::size_t i = 0; i < n; i++)
+        distance[i] = __builtin_sqrt(distance2(rap[i] - axis_rap, phi[i] - axis_phi));
+}
+
+/// the reductions keep four independent partial sums, whatever the width of the vectors, so the order of the additions
+/// (and the result) is the same at every level. The SSE levels vectorise the loops with four accumulators well, the
+/// AVX levels fold them one element at a time, so there the four sums are the lanes of a vector of four doubles
+#ifdef __AVX__
+typedef double double4 __attribute__((vector_size(32)));
+
+inline void load4(double4& v, const double* x) {
+    __builtin_memcpy(&v, x, sizeof(v));
+}
+#endif
+
+double dot2(const double* x, const double* y, std::size_t n) {
+    std::size_t k = 0;
+#ifdef __AVX__
+    double4 s = {0., 0., 0., 0.};
+    for (; k + 4 <= n; k += 4) {
+        double4 x4, y4;
+        load4(x4, x + k);
+        load4(y4, y + k);
+        s += x4 * y4;
+    }
+    double s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+#else
+    double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+    for (; k + 4 <= n; k += 4) {
+        s0 += x[k] * y[k];
+        s1 += x[k + 1] * y[k + 1];
+        s2 += x[k + 2] * y[k + 2];
+        s3 += x[k + 3] * y[k + 3];
+    }
+#endif
+    for (; k < n; k++)
+        s0 += x[k] * y[k];
+    return (s0 + s1) + (s2 + s3);
+}
+
+double dot3(const double* x, const double* y, const double* w, std::size_t n) {
+    std::size_t k = 0;
+#ifdef __AVX__
+    double4 s = {0., 0., 0., 0.};
+    for (; k + 4 <= n; k += 4) {
+        double4 x4, y4, w4;
+        load4(x4, x + k);
+        load4(y4, y + k);
+        load4(w4, w + k);
+        s += x4 * y4 * w4;
+    }
+    double s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+#else
+    double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+    for (; k + 4 <= n; k += 4) {
+        s0 += x[k] * y[k] * w[k];
+        s1 += x[k + 1] * y[k + 1] * w[k + 1];
+        s2 += x[k + 2] * y[k + 2] * w[k + 2];
+        s3 += x[k + 3] * y[k + 3] * w[k + 3];
+    }
+#endif
+    for (; k < n; k++)
+        s0 += x[k] * y[k] * w[k];
+    return (s0 + s1) + (s2 + s3);
+}
+
+void sqrtValues(const double* x, std::size_t n, double* y) {
+    for (std::size_t k = 0; k < n; k++)
+        y[k] = __builtin_sqrt(x[k]);
+}
+
+/// the cone of the grid cells: a mask of the particles inside, counted or used to sum the pT
+int countWithin(const double* eta, const double* phi, std::size_t n, double eta0, double phi0, double r2) {
+    int count = 0;
+    for (std::size_t k = 0; k < n; k++)
+        count += distance2(eta[k] - eta0, phi[k] - phi0) < r2;
+    return count;
+}
+
+double ptWithin(const double* eta, const double* phi, const double* pt, std::size_t n, double eta0, double phi0, double r2) {
+    std::size_t k = 0;
+#ifdef __AVX__
+    double4 s = {0., 0., 0., 0.};
+    const double4 zero = {0., 0., 0., 0.};
+    for (; k + 4 <= n; k += 4) {
+        double4 eta4, phi4, pt4;
+        load4(eta4, eta + k);
+        load4(phi4, phi + k);
+        load4(pt4, pt + k);
+        const double4 deta = eta4 - eta0;
+        const double4 dphi = phi4 - phi0;
+        /// |dphi| up to the sign of a zero, which the square removes
+        const double4 absolute_dphi = dphi < 0. ? -dphi : dphi;
+        const double4 other_way = two_pi - absolute_dphi;
+        const double4 wrapped_dphi = other_way < absolute_dphi ? other_way : absolute_dphi;
+        s += deta * deta + wrapped_dphi * wrapped_dphi < r2 ? pt4 : zero;
+    }
+    double s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+#else
+    double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+    for (; k + 4 <= n; k += 4) {
+        s0 += distance2(eta[k] - eta0, phi[k] - phi0) < r2 ? pt[k] : 0.;
+        s1 += distance2(eta[k + 1] - eta0, phi[k + 1] - phi0) < r2 ? pt[k + 1] : 0.;
+        s2 += distance2(eta[k + 2] - eta0, phi[k + 2] - phi0) < r2 ? pt[k + 2] : 0.;
+        s3 += distance2(eta[k + 3] - eta0, phi[k + 3] - phi0) < r2 ? pt[k + 3] : 0.;
+    }
+#endif
+    for (; k < n; k++)
+        s0 += distance2(eta[k] - eta0, phi[k] - phi0) < r2 ? pt[k] : 0.;
+    return (s0 + s1) + (s2 + s3);
+}
+
+}
+
+extern const SimdKernels ANALYSIS_SIMD_KERNELS;
+const SimdKernels ANALYSIS_SIMD_KERNELS = {ANALYSIS_SIMD_VARIANT, pairwiseDistance2, axisDistance, dot2, dot3, sqrtValues, countWithin, ptWithin};
@@ -0,0 +1,88 @@
+#include "Analysis/SimdKernels.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+
+/// the tables of the levels built in the library (src/SimdKernelVariant.cpp)
+extern const SimdKernels generic_kernels;
+#ifdef ANALYSIS_SIMD_DISPATCH
+extern const SimdKernels sse42_kernels;
+extern const SimdKernels avx2_kernels;
+extern const SimdKernels avx512_kernels;
+#endif
+
+static const char* simd_level_names[NumberOfSimdLevels] = {"generic", "sse4.2", "avx2", "avx512"};
+
+const char* simdLevelName(SimdLevel level) {
+    return (level >= 0 && level < NumberOfSimdLevels) ? simd_level_names[level] : "unknown";
+}
+
+/// @brief - the table of the level, nullptr if it is not built
+static const SimdKernels* levelKernels(SimdLevel level) {
+    switch (level) {
+        case GenericSimd: return &generic_kernels;
+#ifdef ANALYSIS_SIMD_DISPATCH
+        case SSE42Simd: return &sse42_kernels;
+        case AVX2Simd: return &avx2_kernels;
+        case AVX512Simd: return &avx512_kernels;
+#endif
+        default: return nullptr;
+    }
+}
+
+bool simdLevelSupported(SimdLevel level) {
+    if (!levelKernels(level))
+        return false;
+#if defined(ANALYSIS_SIMD_DISPATCH) && (defined(__x86_64__) || defined(__i386__))
+    /// the checks of the AVX levels include the support of the OS for the wider registers (XGETBV)
+    __builtin_cpu_init();
+    switch (level) {
+        case SSE42Simd:
+            return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+        case AVX2Simd:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case AVX512Simd:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512vl")
+                && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("fma");
+        default:
+            return true;
+    }
+#else
+    return level == GenericSimd;
+#endif
+}
+
+const SimdKernels& simdKernels(SimdLevel level) {
+    /// a level the CPU cannot run falls back to the best level below it
+    while (level > GenericSimd && !simdLevelSupported(level))
+        level = SimdLevel(level - 1);
+    return *levelKernels(level);
+}
+
+/// @brief - the best supported level, lowered by ANALYSIS_SIMD_LEVEL
+static const SimdKernels& selectKernels() {
+    SimdLevel best = SimdLevel(NumberOfSimdLevels - 1);
+    while (best > GenericSimd && !simdLevelSupported(best))
+        best = SimdLevel(best - 1);
+    const char* forced_name = std::getenv("ANALYSIS_SIMD_LEVEL");
+    if (!forced_name || !*forced_name)
+        return *levelKernels(best);
+    for (int level = 0; level < NumberOfSimdLevels; level++) {
+        if (std::strcmp(forced_name, simd_level_names[level]) != 0)
+            continue;
+        if (level > best) {
+            std::cout << "ANALYSIS_SIMD_LEVEL=" << forced_name << " is not supported by this CPU or build, using " << simdLevelName(best) << std::endl;
+            return *levelKernels(best);
+        }
+        return *levelKernels(SimdLevel(level));
+    }
+    std::cout << "Unknown ANALYSIS_SIMD_LEVEL=" << forced_name << " (generic, sse4.2, avx2 or avx512), using " << simdLevelName(best) << std::endl;
+    return *levelKernels(best);
+}
+
+const SimdKernels& simdKernels() {
+    /// chosen once, the initialisation of a local static is thread safe
+    static const SimdKernels& kernels = selectKernels();
+    return kernels;
+}
@@ -0,0 +1,285 @@
+#include "Analysis/SkimFormat.h"
+#include <cstring>
+#include <algorithm>
+#include <memory>
+
+
+/// header of the skim files
+static const char skim_magic[8] = {'J', 'M', 'L', 'S', 'K', 'I', 'M', '\0'};
+/// event number and number of initial, hard and final particles
+static const std::size_t record_header_size = 4 * sizeof(std::uint32_t);
+
+/// @brief - value of type T at the position of the buffer (the columns are read with memcpy, the buffer is only char aligned)
+template <typename T>
+static T readValue(const char* data, std::size_t index) {
+    T value;
+    std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+bool isSkimFilename(const std::string& filename) {
+    const std::string extension = ".skim";
+    return filename.size() > extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+SkimWriter::SkimWriter(const std::string& filename): _file(std::fopen(filename.c_str(), "wb")) {
+    if (!_file) {
+        std::cout << "Could not open " << filename << std::endl;
+        _failed = true;
+        return;
+    }
+    std::setvbuf(_file, nullptr, _IOFBF, 1 << 20);
+    _failed = std::fwrite(skim_magic, 1, sizeof(skim_magic), _file) != sizeof(skim_magic) ||
+              std::fwrite(&version, sizeof(version), 1, _file) != 1;
+    _bytes_written = sizeof(skim_magic) + sizeof(version);
+}
+
+SkimWriter::~SkimWriter() {
+    close();
+}
+
+void SkimWriter::close() {
+    if (!_file)
+        return;
+    if (std::fclose(_file) != 0)
+        _failed = true;
+    _file = nullptr;
+}
+
+void SkimWriter::append(const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    _record.insert(_record.end(), bytes, bytes + size);
+}
+
+void SkimWriter::markDescendants(const HepMC3::ConstGenParticlePtr& hard_particle, std::uint32_t bit) {
+    /// new search - the visited flags of the previous one become stale
+    if (++_search_number == 0) {
+        std::fill(_visited_vertices.begin(), _visited_vertices.end(), 0);
+        _search_number = 1;
+    }
+    _vertices_to_visit.clear();
+    if (hard_particle->end_vertex())
+        _vertices_to_visit.push_back(hard_particle->end_vertex());
+    while (!_vertices_to_visit.empty()) {
+        const HepMC3::ConstGenVertexPtr vertex = _vertices_to_visit.back();
+        _vertices_to_visit.pop_back();
+        for (const HepMC3::ConstGenParticlePtr& particle: vertex->particles_out()) {
+            if (particle->status() == 1) {
+                if (particle->id() > 0)
+                    _masks[particle->id() - 1] |= bit;
+                continue;
+            }
+            const HepMC3::ConstGenVertexPtr& end_vertex = particle->end_vertex();
+            if (!end_vertex)
+                continue;
+            /// each vertex is visited once per hard particle
+            const int index = -end_vertex->id() - 1;
+            if (index >= 0) {
+                if (index >= int(_visited_vertices.size()))
+                    _visited_vertices.resize(index + 1, 0);
+                if (_visited_vertices[index] == _search_number)
+                    continue;
+                _visited_vertices[index] = _search_number;
+            }
+            _vertices_to_visit.push_back(end_vertex);
+        }
+    }
+}
+
+void SkimWriter::write_event(const HepMC3::GenEvent& hepmc_event) {
+    if (!_file || _failed)
+        return;
+
+    _initial.clear();
+    _hard.clear();
+    _final.clear();
+    for (const HepMC3::ConstGenParticlePtr& particle: hepmc_event.particles()) {
+        if (particle->status() == 21) _initial.push_back(particle);
+        else if (particle->status() == 23) _hard.push_back(particle);
+        else if (particle->status() == 1) _final.push_back(particle);
+    }
+
+    /// ancestor masks of the final particles
+    _masks.assign(hepmc_event.particles().size(), 0);
+    const std::size_t number_masked = std::min<std::size_t>(_hard.size(), 32);
+    if (_hard.size() > 32 && !_warned_hard_particles) {
+        std::cout << "Events with more than 32 hard process particles: the final particles are only linked to the first 32" << std::endl;
+        _warned_hard_particles = true;
+    }
+    for (std::size_t hard = 0; hard < number_masked; hard++)
+        markDescendants(_hard[hard], std::uint32_t(1) << hard);
+
+    /// the record: size, header and the columns
+    _record.clear();
+    const std::uint32_t header[5] = {0, std::uint32_t(hepmc_event.event_number()), std::uint32_t(_initial.size()),
+                                     std::uint32_t(_hard.size()), std::uint32_t(_final.size())};
+    append(header, sizeof(header));
+    const std::vector<HepMC3::ConstGenParticlePtr>* groups[3] = {&_initial, &_hard, &_final};
+    for (const std::vector<HepMC3::ConstGenParticlePtr>* group: groups)
+        for (const HepMC3::ConstGenParticlePtr& particle: *group) {
+            const std::int32_t pid = particle->pid();
+            append(&pid, sizeof(pid));
+        }
+    for (int component = 0; component < 4; component++)
+        for (const std::vector<HepMC3::ConstGenParticlePtr>* group: groups)
+            for (const HepMC3::ConstGenParticlePtr& particle: *group) {
+                const HepMC3::FourVector& momentum = particle->momentum();
+                const float value = component == 0 ? momentum.px() : component == 1 ? momentum.py() : component == 2 ? momentum.pz() : momentum.e();
+                append(&value, sizeof(value));
+            }
+    for (const HepMC3::ConstGenParticlePtr& particle: _final) {
+        const std::uint32_t mask = particle->id() > 0 ? _masks[particle->id() - 1] : 0;
+        append(&mask, sizeof(mask));
+    }
+    const std::uint32_t record_size = _record.size() - sizeof(std::uint32_t);
+    std::memcpy(_record.data(), &record_size, sizeof(record_size));
+
+    if (std::fwrite(_record.data(), 1, _record.size(), _file) != _record.size())
+        _failed = true;
+    _bytes_written += _record.size();
+}
+
+SkimReader::SkimReader(const std::string& filename): _file(std::fopen(filename.c_str(), "rb")) {
+    if (!_file) {
+        readError("Could not open " + filename);
+        return;
+    }
+    std::setvbuf(_file, nullptr, _IOFBF, 1 << 20);
+    if (std::fseek(_file, 0, SEEK_END) == 0) {
+        _file_size = std::ftell(_file);
+        std::rewind(_file);
+    }
+    char magic[sizeof(skim_magic)];
+    std::uint32_t file_version = 0;
+    if (std::fread(magic, 1, sizeof(magic), _file) != sizeof(magic) || std::memcmp(magic, skim_magic, sizeof(magic)) != 0 ||
+        std::fread(&file_version, sizeof(file_version), 1, _file) != 1) {
+        readError(filename + " is not a skim file");
+        return;
+    }
+    if (file_version != SkimWriter::version) {
+        readError(filename + " has the skim version " + std::to_string(file_version) + ", expected " + std::to_string(SkimWriter::version));
+        return;
+    }
+    _file_offset = sizeof(magic) + sizeof(file_version);
+}
+
+SkimReader::~SkimReader() {
+    close();
+}
+
+void SkimReader::close() {
+    if (_file)
+        std::fclose(_file);
+    _file = nullptr;
+}
+
+bool SkimReader::readError(const std::string& message) {
+    std::cout << message << std::endl;
+    _read_error = true;
+    _failed = true;
+    return false;
+}
+
+bool SkimReader::readRecordSize(std::uint32_t& size) {
+    if (!_file || _failed)
+        return false;
+    const std::size_t read = std::fread(&size, 1, sizeof(size), _file);
+    if (read == 0) {
+        /// end of the file between two records
+        _failed = true;
+        return false;
+    }
+    if (read != sizeof(size))
+        return readError("The skim file ends inside a record");
+    _file_offset += sizeof(size);
+    return true;
+}
+
+bool SkimReader::skip(const int n) {
+    for (int i = 0; i < n; i++) {
+        std::uint32_t size;
+        if (!readRecordSize(size))
+            return false;
+        if (std::fseek(_file, size, SEEK_CUR) != 0)
+            return readError("The skim file ends inside a record");
+        _file_offset += size;
+    }
+    return true;
+}
+
+HepMC3::GenVertexPtr SkimReader::maskVertex(std::uint32_t mask) {
+    for (const std::pair<std::uint32_t, HepMC3::GenVertexPtr>& mask_vertex: _mask_vertices)
+        if (mask_vertex.first == mask)
+            return mask_vertex.second;
+    HepMC3::GenVertexPtr vertex = std::make_shared<HepMC3::GenVertex>();
+    /// the mask has one bit for each of the first 32 hard particles, the others have no descendants in the skim
+    const std::size_t number_masked = std::min<std::size_t>(_hard_particles.size(), 32);
+    for (std::size_t hard = 0; hard < number_masked; hard++) {
+        if (!(mask & (std::uint32_t(1) << hard)))
+            continue;
+        if (!_hard_vertices[hard]) {
+            _hard_vertices[hard] = std::make_shared<HepMC3::GenVertex>();
+            _hard_vertices[hard]->add_particle_in(_hard_particles[hard]);
+        }
+        HepMC3::GenParticlePtr link = std::make_shared<HepMC3::GenParticle>(HepMC3::FourVector::ZERO_VECTOR(), 0, 2);
+        _hard_vertices[hard]->add_particle_out(link);
+        vertex->add_particle_in(link);
+    }
+    _mask_vertices.emplace_back(mask, vertex);
+    return vertex;
+}
+
+bool SkimReader::read_event(HepMC3::GenEvent& hepmc_event) {
+    hepmc_event.clear();
+    std::uint32_t size;
+    if (!readRecordSize(size))
+        return false;
+    _record.resize(size);
+    if (std::fread(_record.data(), 1, size, _file) != size)
+        return readError("The skim file ends inside a record");
+    _file_offset += size;
+    if (size < record_header_size)
+        return readError("Corrupted record in the skim file");
+
+    const char* data = _record.data();
+    const std::size_t number_initial = readValue<std::uint32_t>(data, 1);
+    const std::size_t number_hard = readValue<std::uint32_t>(data, 2);
+    const std::size_t number_final = readValue<std::uint32_t>(data, 3);
+    const std::size_t number_particles = number_initial + number_hard + number_final;
+    if (size != record_header_size + 5 * sizeof(std::uint32_t) * number_particles + sizeof(std::uint32_t) * number_final)
+        return readError("Corrupted record in the skim file");
+    hepmc_event.set_event_number(readValue<std::int32_t>(data, 0));
+    hepmc_event.set_units(HepMC3::Units::GEV, HepMC3::Units::MM);
+
+    /// the columns
+    const char* pids = data + record_header_size;
+    const char* px = pids + sizeof(std::int32_t) * number_particles;
+    const char* py = px + sizeof(float) * number_particles;
+    const char* pz = py + sizeof(float) * number_particles;
+    const char* e = pz + sizeof(float) * number_particles;
+    const char* masks = e + sizeof(float) * number_particles;
+
+    _hard_particles.clear();
+    _hard_vertices.assign(number_hard, nullptr);
+    _mask_vertices.clear();
+    for (std::size_t i = 0; i < number_particles; i++) {
+        const int status = i < number_initial ? 21 : i < number_initial + number_hard ? 23 : 1;
+        const HepMC3::FourVector momentum (readValue<float>(px, i), readValue<float>(py, i), readValue<float>(pz, i), readValue<float>(e, i));
+        HepMC3::GenParticlePtr particle = std::make_shared<HepMC3::GenParticle>(momentum, readValue<std::int32_t>(pids, i), status);
+        hepmc_event.add_particle(particle);
+        if (status == 23)
+            _hard_particles.push_back(particle);
+        else if (status == 1) {
+            const std::uint32_t mask = readValue<std::uint32_t>(masks, i - number_initial - number_hard);
+            if (mask != 0)
+                maskVertex(mask)->add_particle_out(particle);
+        }
+    }
+    /// the vertices of the hard particles first, so their links are in the event before the vertices of the masks
+    for (const HepMC3::GenVertexPtr& vertex: _hard_vertices)
+        if (vertex)
+            hepmc_event.add_vertex(vertex);
+    for (const std::pair<std::uint32_t, HepMC3::GenVertexPtr>& mask_vertex: _mask_vertices)
+        hepmc_event.add_vertex(mask_vertex.second);
+    return true;
+}
@@ -0,0 +1,183 @@
+#include "Analysis/TrainingSet.h"
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+
+
+/// @brief - uniform number in [0, 1) from the top 53 bits (the same in every standard library)
+static double uniform(std::mt19937_64& generator) {
+    return (generator() >> 11) * 0x1.0p-53;
+}
+
+ClassRowStream::ClassRowStream(const std::string& name, const std::vector<std::string>& filenames):
+    _name(name), _rows_per_file(filenames.size(), 0) {
+    for (const std::string& filename: filenames) {
+        _filenames.push_back(resolveInputFilename(filename));
+        /// every file has its read-ahead thread, so all the files are read and decompressed in parallel
+        _inputs.push_back(openHepMCInput(_filenames.back()));
+        if (!_inputs.back()->is_open())
+            _is_open = false;
+        /// the size on disk is proportional to the number of rows (for the files with the same compression)
+        _weights.push_back(std::max<double>(_inputs.back()->fileSize(), 1));
+    }
+}
+
+bool ClassRowStream::nextRow(std::mt19937_64& generator, std::string& row) {
+    while (true) {
+        const double total_weight = std::accumulate(_weights.begin(), _weights.end(), 0.);
+        if (total_weight <= 0)
+            return false;
+        /// draws the file, the last one with weight absorbs the rounding
+        double draw = uniform(generator) * total_weight;
+        std::size_t file = 0;
+        while (file + 1 < _weights.size() && (_weights[file] == 0 || draw >= _weights[file])) {
+            draw -= _weights[file];
+            file++;
+        }
+        while (_weights[file] == 0)
+            file--;
+        /// empty lines are skipped, a file that ran out is not drawn again
+        while (std::getline(*_inputs[file], row)) {
+            if (!row.empty()) {
+                _rows_per_file[file]++;
+                return true;
+            }
+        }
+        if (_inputs[file]->readFailed())
+            std::cout << "Error reading " << _filenames[file] << ", the rest of the file is ignored" << std::endl;
+        _weights[file] = 0;
+        _inputs[file].reset();
+    }
+}
+
+
+TrainingSetBuilder::TrainingSetBuilder(const std::string& output_prefix, long shard_size, long buffer_size, std::uint64_t seed, bool async_output):
+    _output_prefix(output_prefix), _shard_size(std::max(shard_size, 1L)), _buffer_size(std::max(buffer_size, 1L)), _seed(seed),
+    _async_output(async_output), _generator(seed) {}
+
+bool TrainingSetBuilder::addClass(const std::string& name, const std::vector<std::string>& filenames) {
+    _classes.emplace_back(new ClassRowStream(name, filenames));
+    if (!_classes.back()->is_open() || filenames.empty()) {
+        std::cout << "Could not open the files of the class " << name << std::endl;
+        _classes.pop_back();
+        return false;
+    }
+    return true;
+}
+
+std::string TrainingSetBuilder::temporaryShardFilename(long shard) const {
+    return _output_prefix + "_unshuffled_" + std::to_string(shard) + ".csv";
+}
+
+std::string TrainingSetBuilder::shardFilename(long shard) const {
+    return _output_prefix + "_" + std::to_string(shard) + ".csv";
+}
+
+void TrainingSetBuilder::writeRow(const std::string& row) {
+    if (!_shard) {
+        _shard.reset(new FileWriter(temporaryShardFilename(_number_shards), _async_output));
+        if (!_shard->is_open()) {
+            std::cout << "Could not open " << temporaryShardFilename(_number_shards) << std::endl;
+            _failed = true;
+        }
+        _number_shards++;
+        _rows_in_shard = 0;
+    }
+    _shard->write(row);
+    _shard->write("\n", 1);
+    if (++_rows_in_shard == _shard_size)
+        closeShard();
+}
+
+void TrainingSetBuilder::closeShard() {
+    if (!_shard)
+        return;
+    if (!_shard->close()) {
+        std::cout << "Failed to write " << temporaryShardFilename(_number_shards - 1) << ": " << _shard->errorMessage() << std::endl;
+        _failed = true;
+    }
+    _shard.reset();
+}
+
+bool TrainingSetBuilder::build() {
+    if (_classes.empty()) {
+        std::cout << "No classes for the training set" << std::endl;
+        return false;
+    }
+    const int number_classes = _classes.size();
+    /// the buffer keeps its strings, so the rows reuse their memory once it is full
+    std::vector<std::string> buffer;
+    buffer.reserve(_buffer_size);
+    std::vector<std::string> round (number_classes);
+    std::vector<int> order (number_classes);
+    std::iota(order.begin(), order.end(), 0);
+    std::string row;
+
+    _rows_per_class = 0;
+    while (_max_rows_per_class < 0 || _rows_per_class < _max_rows_per_class) {
+        /// a round is written only if every class has a row, so all the classes have the same number of rows
+        bool complete = true;
+        for (int label = 0; label < number_classes && complete; label++) {
+            complete = _classes[label]->nextRow(_generator, row);
+            round[label].assign(std::to_string(label)).append(1, ',').append(row);
+        }
+        if (!complete)
+            break;
+        _rows_per_class++;
+        std::shuffle(order.begin(), order.end(), _generator);
+        for (int label: order) {
+            if (long(buffer.size()) < _buffer_size) {
+                buffer.push_back(std::move(round[label]));
+                continue;
+            }
+            /// the new row takes the place of a random row of the buffer, which is written
+            std::string& slot = buffer[_generator() % _buffer_size];
+            writeRow(slot);
+            slot.swap(round[label]);
+        }
+        if (_failed)
+            return false;
+    }
+    /// the rows left in the buffer are written in a random order
+    std::shuffle(buffer.begin(), buffer.end(), _generator);
+    for (const std::string& buffered_row: buffer)
+        writeRow(buffered_row);
+    closeShard();
+    if (_failed)
+        return false;
+    return finish();
+}
+
+bool TrainingSetBuilder::finish() {
+    /// shard i of the stream becomes the shard permutation[i]
+    std::vector<long> permutation (_number_shards);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::shuffle(permutation.begin(), permutation.end(), _generator);
+    for (long shard = 0; shard < _number_shards; shard++) {
+        if (std::rename(temporaryShardFilename(shard).c_str(), shardFilename(permutation[shard]).c_str()) != 0) {
+            std::cout << "Could not rename " << temporaryShardFilename(shard) << " to " << shardFilename(permutation[shard]) << std::endl;
+            return false;
+        }
+    }
+
+    /// labels, files and counts, next to the shards
+    const std::string summary_filename = _output_prefix + "_summary.txt";
+    std::ofstream summary (summary_filename);
+    summary << "rows_per_class " << _rows_per_class << "\n";
+    summary << "rows " << _rows_per_class * long(_classes.size()) << "\n";
+    summary << "shards " << _number_shards << "\n";
+    summary << "shard_size " << _shard_size << "\n";
+    summary << "buffer_size " << _buffer_size << "\n";
+    summary << "seed " << _seed << "\n";
+    for (std::size_t label = 0; label < _classes.size(); label++) {
+        summary << "class " << label << " " << _classes[label]->name() << "\n";
+        for (std::size_t file = 0; file < _classes[label]->filenames().size(); file++)
+            summary << "file " << label << " " << _classes[label]->filenames()[file] << " " << _classes[label]->rowsPerFile()[file] << "\n";
+    }
+    if (!summary.good()) {
+        std::cout << "Could not write " << summary_filename << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,240 @@
+#include "Analysis/UnderlyingEventOverlay.h"
+#include "Analysis/HepMCInput.h"
+#include "Analysis/SkimFormat.h"
+#include "HepMC3/ReaderAscii.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/// header of the pool caches
+static const char pool_magic[8] = {'J', 'M', 'L', 'P', 'O', 'O', 'L', '\0'};
+/// magic, version, padding, number of events and number of particles
+static const std::size_t pool_header_size = sizeof(pool_magic) + 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+/// @brief - size of the pool with the number of events and particles
+static std::size_t poolSize(std::uint64_t number_events, std::uint64_t number_particles) {
+    return pool_header_size + (number_events + 1) * sizeof(std::uint64_t) + number_particles * (sizeof(std::int32_t) + 4 * sizeof(float));
+}
+
+bool isPoolFilename(const std::string& filename) {
+    const std::string extension = ".pool";
+    return filename.size() > extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+BackgroundPool::~BackgroundPool() {
+    unmap();
+}
+
+void BackgroundPool::unmap() {
+    if (_mapped)
+        munmap(_mapped, _mapped_size);
+    _mapped = nullptr;
+    _mapped_size = 0;
+}
+
+bool BackgroundPool::setColumns(const char* data, std::size_t size, const std::string& filename) {
+    std::uint32_t file_version;
+    std::uint64_t number_events, number_particles;
+    if (size < pool_header_size || std::memcmp(data, pool_magic, sizeof(pool_magic)) != 0) {
+        std::cout << filename << " is not a background pool" << std::endl;
+        return false;
+    }
+    std::memcpy(&file_version, data + sizeof(pool_magic), sizeof(file_version));
+    std::memcpy(&number_events, data + sizeof(pool_magic) + 2 * sizeof(std::uint32_t), sizeof(number_events));
+    std::memcpy(&number_particles, data + sizeof(pool_magic) + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t), sizeof(number_particles));
+    if (file_version != version) {
+        std::cout << filename << " has version " << file_version << " of the background pool, expected " << version << std::endl;
+        return false;
+    }
+    if (number_events == 0 || size != poolSize(number_events, number_particles)) {
+        std::cout << filename << " is truncated or has no events" << std::endl;
+        return false;
+    }
+    /// the header and the offsets keep the columns aligned (the data comes from mmap or from a vector of char, both aligned for uint64)
+    _data = data;
+    _size = size;
+    _number_events = number_events;
+    _number_particles = number_particles;
+    _offsets = reinterpret_cast<const std::uint64_t*>(data + pool_header_size);
+    _pid = reinterpret_cast<const std::int32_t*>(_offsets + number_events + 1);
+    _px = reinterpret_cast<const float*>(_pid + number_particles);
+    _py = _px + number_particles;
+    _pz = _py + number_particles;
+    _e = _pz + number_particles;
+    if (_offsets[number_events] != number_particles) {
+        std::cout << filename << " has inconsistent event offsets" << std::endl;
+        _data = nullptr;
+        _number_events = _number_particles = 0;
+        return false;
+    }
+    return true;
+}
+
+bool BackgroundPool::load(const std::string& filename, long max_events) {
+    unmap();
+    const std::string hepmc3_filename = resolveInputFilename(filename);
+    std::shared_ptr<HepMCInputStream> hepmc_input;
+    std::unique_ptr<HepMC3::Reader> hepmc_file;
+    if (isSkimFilename(hepmc3_filename))
+        hepmc_file.reset(new SkimReader(hepmc3_filename));
+    else {
+        hepmc_input = openHepMCInput(hepmc3_filename);
+        if (!hepmc_input->is_open()) {
+            std::cout << "Could not open " << filename << std::endl;
+            return false;
+        }
+        hepmc_file.reset(new HepMC3::ReaderAscii(hepmc_input));
+    }
+
+    /// the columns are collected first, the number of particles is only known at the end
+    std::vector<std::uint64_t> offsets = {0};
+    std::vector<std::int32_t> pids;
+    std::vector<float> px, py, pz, e;
+    HepMC3::GenEvent hepmc_event (HepMC3::Units::GEV, HepMC3::Units::MM);
+    while (long(offsets.size()) - 1 < max_events) {
+        hepmc_file->read_event(hepmc_event);
+        if (hepmc_file->failed())
+            break;
+        for (const HepMC3::GenParticlePtr& particle: hepmc_event.particles()) {
+            if (particle->status() != 1)
+                continue;
+            const HepMC3::FourVector& momentum = particle->momentum();
+            pids.push_back(particle->pid());
+            px.push_back(momentum.px());
+            py.push_back(momentum.py());
+            pz.push_back(momentum.pz());
+            e.push_back(momentum.e());
+        }
+        offsets.push_back(pids.size());
+    }
+    const std::uint64_t number_events = offsets.size() - 1, number_particles = pids.size();
+    if (number_events == 0) {
+        std::cout << "No background events read from " << filename << std::endl;
+        return false;
+    }
+
+    _storage.assign(poolSize(number_events, number_particles), 0);
+    char* data = _storage.data();
+    const std::uint32_t padding = 0;
+    auto append = [&](const void* values, std::size_t size) {
+        std::memcpy(data, values, size);
+        data += size;
+    };
+    append(pool_magic, sizeof(pool_magic));
+    append(&version, sizeof(version));
+    append(&padding, sizeof(padding));
+    append(&number_events, sizeof(number_events));
+    append(&number_particles, sizeof(number_particles));
+    append(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+    append(pids.data(), number_particles * sizeof(std::int32_t));
+    for (const std::vector<float>* column: {&px, &py, &pz, &e})
+        append(column->data(), number_particles * sizeof(float));
+    return setColumns(_storage.data(), _storage.size(), filename);
+}
+
+bool BackgroundPool::map(const std::string& cache_filename) {
+    unmap();
+    _storage.clear();
+    const int descriptor = ::open(cache_filename.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        std::cout << "Could not open " << cache_filename << std::endl;
+        return false;
+    }
+    struct stat file_status;
+    if (fstat(descriptor, &file_status) != 0 || file_status.st_size == 0) {
+        std::cout << "Could not read the size of " << cache_filename << std::endl;
+        ::close(descriptor);
+        return false;
+    }
+    void* mapped = mmap(nullptr, file_status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    /// the mapping stays valid after the file is closed
+    ::close(descriptor);
+    if (mapped == MAP_FAILED) {
+        std::cout << "Could not map " << cache_filename << std::endl;
+        return false;
+    }
+    _mapped = mapped;
+    _mapped_size = file_status.st_size;
+    /// the draws touch the whole pool, so the kernel can read it in before the first events
+    madvise(_mapped, _mapped_size, MADV_WILLNEED);
+    if (!setColumns(static_cast<const char*>(_mapped), _mapped_size, cache_filename)) {
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+bool BackgroundPool::open(const std::string& filename, long max_events) {
+    if (!isPoolFilename(filename))
+        return load(filename, max_events);
+    if (!map(filename))
+        return false;
+    if (max_events < _number_events)
+        std::cout << "Using the " << _number_events << " events of " << filename << " (the pool size is fixed by the cache)" << std::endl;
+    return true;
+}
+
+bool BackgroundPool::save(const std::string& cache_filename) const {
+    if (!_data) {
+        std::cout << "The background pool is empty" << std::endl;
+        return false;
+    }
+    std::FILE* file = std::fopen(cache_filename.c_str(), "wb");
+    if (!file) {
+        std::cout << "Could not open " << cache_filename << std::endl;
+        return false;
+    }
+    const bool written = std::fwrite(_data, 1, _size, file) == _size;
+    if (std::fclose(file) != 0 || !written) {
+        std::cout << "Could not write " << cache_filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+/// @brief - splitmix64 step (the same generator as the synthetic events of the benchmarks)
+static std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+UnderlyingEventOverlay::UnderlyingEventOverlay(const BackgroundPool& pool, int events_per_signal, std::uint64_t seed):
+    _pool(pool), _events_per_signal(std::min<long>(std::max(events_per_signal, 0), pool.numberEvents())), _seed(seed) {
+    if (_events_per_signal != events_per_signal)
+        std::cout << "The pool has " << pool.numberEvents() << " events, overlaying " << _events_per_signal << " per event" << std::endl;
+    _overlaid_events.reserve(_events_per_signal);
+}
+
+void UnderlyingEventOverlay::overlay(HepMC3::GenEvent& hepmc_event, long event_index) {
+    _first_background_id = hepmc_event.particles().size() + 1;
+    /// the state depends only on the seed and the position of the event
+    std::uint64_t state = _seed;
+    state = splitmix64(state) ^ std::uint64_t(event_index);
+    const std::uint64_t number_events = _pool.numberEvents();
+    _overlaid_events.clear();
+    while (int(_overlaid_events.size()) < _events_per_signal) {
+        const long event = splitmix64(state) % number_events;
+        /// k is small: the repeated draws are rejected with a linear search
+        if (std::find(_overlaid_events.begin(), _overlaid_events.end(), event) == _overlaid_events.end())
+            _overlaid_events.push_back(event);
+    }
+
+    for (long event: _overlaid_events) {
+        HepMC3::GenVertexPtr vertex = std::make_shared<HepMC3::GenVertex>();
+        vertex->set_status(background_vertex_status);
+        hepmc_event.add_vertex(vertex);
+        for (std::uint64_t i = _pool.firstParticle(event); i < _pool.lastParticle(event); i++) {
+            const HepMC3::FourVector momentum (_pool.px()[i], _pool.py()[i], _pool.pz()[i], _pool.e()[i]);
+            vertex->add_particle_out(std::make_shared<HepMC3::GenParticle>(momentum, _pool.pid()[i], 1));
+        }
+    }
+}
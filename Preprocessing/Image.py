@@ -1,7 +1,7 @@
 from __future__ import annotations
 import numpy as np
 from abc import ABC, abstractmethod
-from collections import UserDict
+from Preprocessing.ParticleProperties import charge
 
 
 class Image:
@@ -62,37 +62,21 @@ class ImageBuilder(ABC):
         pass
 
 
-class ChargesMap(UserDict):
-    """
-    Map to store the value of the charges given the PID of the particle
-    Only needs to store the PID for the particle. The charge of the antiparticle is -Charge where
-    Charge is the electric charge of the respective particle.
-    """
-    def __getitem__(self, pid):
-        if abs(pid) in self.data:
-            return self.data[pid] if pid in self.data else -self.data[-pid]
-        return 0
-
-    def __setitem__(self, pid, charge):
-        if abs(pid) not in self.data:
-            self.data[pid] = charge
-
-
 class SingleImageBuilder(ImageBuilder):
     """Builder for a single image using all the available info"""
-    # PID of the particles and their respective charge
-    pid_charges_map = ChargesMap({211: 1, 11: -1, 13: -1, 321: 1, 2212: 1})
 
     def build_image(self, image_data, image: Image):
         # info about the particle with the greates pT
         # assumes that the particles are sorted by pT, from the biggest to the lowest (this is the case for the files)
         pt_ref, eta_ref, phi_ref = image_data[2: 5]
+        # charges of all the particles of the event, in a single lookup of the PID table
+        charges = charge(np.asarray(image_data[5::4], dtype=np.int64))
         # updates the image with each particle info that belongs to the event
-        for index_const in range(2, len(image_data), 4):
+        for particle, index_const in enumerate(range(2, len(image_data), 4)):
             # particle information
-            pt, eta, phi, pid = image_data[index_const: index_const + 4]
+            pt, eta, phi = image_data[index_const: index_const + 3]
             # array with the color intensities
-            color_intensities = np.array([pt/pt_ref, self.pid_charges_map[pid]])
+            color_intensities = np.array([pt/pt_ref, charges[particle]])
             # updating the image
             image.update_image(eta=eta - eta_ref, phi=self.delta_phi(phi, phi_ref), colors=color_intensities)
 
@@ -0,0 +1,56 @@
+"""
+Lookup of the particle properties (charge, hadron type, heavy-flavour content and ALICE species) given the PID.
+The values come from pid_table.py, which is generated from the C++ table in
+Analysis/include/Analysis/ParticleProperties.h, so both sides always agree.
+"""
+
+import numpy as np
+from Preprocessing import pid_table
+from Preprocessing.pid_table import (OTHER_SPECIES, ELECTRON, MUON, PION, KAON, PROTON, KNOWN, QUARK, LEPTON,
+                                     GAUGE_BOSON, MESON, BARYON, DIQUARK, CHARM, BOTTOM)
+
+# dense arrays indexed by the last four digits of |PID|, exactly as in the C++ table
+CHARGE3 = np.zeros(pid_table.TABLE_SIZE, dtype=np.int8)
+FLAGS = np.zeros(pid_table.TABLE_SIZE, dtype=np.uint16)
+SPECIES = np.zeros(pid_table.TABLE_SIZE, dtype=np.uint8)
+for _index, _charge3, _flags, _species in pid_table.ENTRIES:
+    CHARGE3[_index], FLAGS[_index], SPECIES[_index] = _charge3, _flags, _species
+
+
+def table_index(pid):
+    """Position of the PID (or array of PIDs) in the table - PIDs outside the hadron numbering scheme go to 0"""
+    abs_pid = np.abs(np.asarray(pid, dtype=np.int64))
+    return np.where(abs_pid < 1000000, abs_pid % pid_table.TABLE_SIZE, 0)
+
+
+def charge3(pid):
+    """Three times the electric charge of the particle(s)"""
+    return np.sign(pid).astype(np.int64) * CHARGE3[table_index(pid)]
+
+
+def charge(pid):
+    """Electric charge of the particle(s)"""
+    return charge3(pid) / 3
+
+
+def flags(pid):
+    """Flags with the type and the quark content of the particle(s)"""
+    return FLAGS[table_index(pid)]
+
+
+def species(pid):
+    """ALICE species class of the particle(s) - only the ground states, the excited states (|PID| >= 10000) are OTHER_SPECIES"""
+    abs_pid = np.abs(np.asarray(pid, dtype=np.int64))
+    return np.where(abs_pid < pid_table.TABLE_SIZE, SPECIES[table_index(pid)], OTHER_SPECIES)
+
+
+def has_charm(pid):
+    return (flags(pid) & CHARM) != 0
+
+
+def has_bottom(pid):
+    return (flags(pid) & BOTTOM) != 0
+
+
+def is_hadron(pid):
+    return (flags(pid) & (MESON | BARYON)) != 0
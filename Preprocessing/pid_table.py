@@ -0,0 +1,414 @@
+"""
+PID property table generated by Analysis/examples/write_pid_table.cpp
+from Analysis/include/Analysis/ParticleProperties.h - do not edit by hand.
+Regenerate it with `make pid_table` in the Analysis folder.
+"""
+
+TABLE_SIZE = 10000
+
+# species identified by ALICE
+OTHER_SPECIES, ELECTRON, MUON, PION, KAON, PROTON = 0, 1, 2, 3, 4, 5
+
+# flags with the type and quark content of the particle
+KNOWN = 1
+QUARK = 2
+LEPTON = 4
+GAUGE_BOSON = 8
+MESON = 16
+BARYON = 32
+DIQUARK = 64
+CHARM = 128
+BOTTOM = 256
+
+# (table index, three times the charge, flags, species) for every known entry
+ENTRIES = [
+    (1, -1, 3, 0),
+    (2, 2, 3, 0),
+    (3, -1, 3, 0),
+    (4, 2, 131, 0),
+    (5, -1, 259, 0),
+    (6, 2, 3, 0),
+    (11, -3, 5, 1),
+    (12, 0, 5, 0),
+    (13, -3, 5, 2),
+    (14, 0, 5, 0),
+    (15, -3, 5, 0),
+    (16, 0, 5, 0),
+    (21, 0, 9, 0),
+    (22, 0, 9, 0),
+    (23, 0, 9, 0),
+    (24, 3, 9, 0),
+    (25, 0, 9, 0),
+    (111, 0, 17, 0),
+    (113, 0, 17, 0),
+    (115, 0, 17, 0),
+    (117, 0, 17, 0),
+    (119, 0, 17, 0),
+    (130, 0, 17, 0),
+    (211, 3, 17, 3),
+    (213, 3, 17, 0),
+    (215, 3, 17, 0),
+    (217, 3, 17, 0),
+    (219, 3, 17, 0),
+    (221, 0, 17, 0),
+    (223, 0, 17, 0),
+    (225, 0, 17, 0),
+    (227, 0, 17, 0),
+    (229, 0, 17, 0),
+    (310, 0, 17, 0),
+    (311, 0, 17, 0),
+    (313, 0, 17, 0),
+    (315, 0, 17, 0),
+    (317, 0, 17, 0),
+    (319, 0, 17, 0),
+    (321, 3, 17, 4),
+    (323, 3, 17, 0),
+    (325, 3, 17, 0),
+    (327, 3, 17, 0),
+    (329, 3, 17, 0),
+    (331, 0, 17, 0),
+    (333, 0, 17, 0),
+    (335, 0, 17, 0),
+    (337, 0, 17, 0),
+    (339, 0, 17, 0),
+    (411, 3, 145, 0),
+    (413, 3, 145, 0),
+    (415, 3, 145, 0),
+    (417, 3, 145, 0),
+    (419, 3, 145, 0),
+    (421, 0, 145, 0),
+    (423, 0, 145, 0),
+    (425, 0, 145, 0),
+    (427, 0, 145, 0),
+    (429, 0, 145, 0),
+    (431, 3, 145, 0),
+    (433, 3, 145, 0),
+    (435, 3, 145, 0),
+    (437, 3, 145, 0),
+    (439, 3, 145, 0),
+    (441, 0, 145, 0),
+    (443, 0, 145, 0),
+    (445, 0, 145, 0),
+    (447, 0, 145, 0),
+    (449, 0, 145, 0),
+    (511, 0, 273, 0),
+    (513, 0, 273, 0),
+    (515, 0, 273, 0),
+    (517, 0, 273, 0),
+    (519, 0, 273, 0),
+    (521, 3, 273, 0),
+    (523, 3, 273, 0),
+    (525, 3, 273, 0),
+    (527, 3, 273, 0),
+    (529, 3, 273, 0),
+    (531, 0, 273, 0),
+    (533, 0, 273, 0),
+    (535, 0, 273, 0),
+    (537, 0, 273, 0),
+    (539, 0, 273, 0),
+    (541, 3, 401, 0),
+    (543, 3, 401, 0),
+    (545, 3, 401, 0),
+    (547, 3, 401, 0),
+    (549, 3, 401, 0),
+    (551, 0, 273, 0),
+    (553, 0, 273, 0),
+    (555, 0, 273, 0),
+    (557, 0, 273, 0),
+    (559, 0, 273, 0),
+    (1101, -2, 65, 0),
+    (1103, -2, 65, 0),
+    (1105, -2, 65, 0),
+    (1107, -2, 65, 0),
+    (1109, -2, 65, 0),
+    (1112, -3, 33, 0),
+    (1114, -3, 33, 0),
+    (1116, -3, 33, 0),
+    (1118, -3, 33, 0),
+    (2101, 1, 65, 0),
+    (2103, 1, 65, 0),
+    (2105, 1, 65, 0),
+    (2107, 1, 65, 0),
+    (2109, 1, 65, 0),
+    (2112, 0, 33, 0),
+    (2114, 0, 33, 0),
+    (2116, 0, 33, 0),
+    (2118, 0, 33, 0),
+    (2122, 3, 33, 0),
+    (2124, 3, 33, 0),
+    (2126, 3, 33, 0),
+    (2128, 3, 33, 0),
+    (2201, 4, 65, 0),
+    (2203, 4, 65, 0),
+    (2205, 4, 65, 0),
+    (2207, 4, 65, 0),
+    (2209, 4, 65, 0),
+    (2212, 3, 33, 5),
+    (2214, 3, 33, 0),
+    (2216, 3, 33, 0),
+    (2218, 3, 33, 0),
+    (2222, 6, 33, 0),
+    (2224, 6, 33, 0),
+    (2226, 6, 33, 0),
+    (2228, 6, 33, 0),
+    (3101, -2, 65, 0),
+    (3103, -2, 65, 0),
+    (3105, -2, 65, 0),
+    (3107, -2, 65, 0),
+    (3109, -2, 65, 0),
+    (3112, -3, 33, 0),
+    (3114, -3, 33, 0),
+    (3116, -3, 33, 0),
+    (3118, -3, 33, 0),
+    (3122, 0, 33, 0),
+    (3124, 0, 33, 0),
+    (3126, 0, 33, 0),
+    (3128, 0, 33, 0),
+    (3132, -3, 33, 0),
+    (3134, -3, 33, 0),
+    (3136, -3, 33, 0),
+    (3138, -3, 33, 0),
+    (3201, 1, 65, 0),
+    (3203, 1, 65, 0),
+    (3205, 1, 65, 0),
+    (3207, 1, 65, 0),
+    (3209, 1, 65, 0),
+    (3212, 0, 33, 0),
+    (3214, 0, 33, 0),
+    (3216, 0, 33, 0),
+    (3218, 0, 33, 0),
+    (3222, 3, 33, 0),
+    (3224, 3, 33, 0),
+    (3226, 3, 33, 0),
+    (3228, 3, 33, 0),
+    (3232, 0, 33, 0),
+    (3234, 0, 33, 0),
+    (3236, 0, 33, 0),
+    (3238, 0, 33, 0),
+    (3301, -2, 65, 0),
+    (3303, -2, 65, 0),
+    (3305, -2, 65, 0),
+    (3307, -2, 65, 0),
+    (3309, -2, 65, 0),
+    (3312, -3, 33, 0),
+    (3314, -3, 33, 0),
+    (3316, -3, 33, 0),
+    (3318, -3, 33, 0),
+    (3322, 0, 33, 0),
+    (3324, 0, 33, 0),
+    (3326, 0, 33, 0),
+    (3328, 0, 33, 0),
+    (3332, -3, 33, 0),
+    (3334, -3, 33, 0),
+    (3336, -3, 33, 0),
+    (3338, -3, 33, 0),
+    (4101, 1, 193, 0),
+    (4103, 1, 193, 0),
+    (4105, 1, 193, 0),
+    (4107, 1, 193, 0),
+    (4109, 1, 193, 0),
+    (4112, 0, 161, 0),
+    (4114, 0, 161, 0),
+    (4116, 0, 161, 0),
+    (4118, 0, 161, 0),
+    (4122, 3, 161, 0),
+    (4124, 3, 161, 0),
+    (4126, 3, 161, 0),
+    (4128, 3, 161, 0),
+    (4132, 0, 161, 0),
+    (4134, 0, 161, 0),
+    (4136, 0, 161, 0),
+    (4138, 0, 161, 0),
+    (4142, 3, 161, 0),
+    (4144, 3, 161, 0),
+    (4146, 3, 161, 0),
+    (4148, 3, 161, 0),
+    (4201, 4, 193, 0),
+    (4203, 4, 193, 0),
+    (4205, 4, 193, 0),
+    (4207, 4, 193, 0),
+    (4209, 4, 193, 0),
+    (4212, 3, 161, 0),
+    (4214, 3, 161, 0),
+    (4216, 3, 161, 0),
+    (4218, 3, 161, 0),
+    (4222, 6, 161, 0),
+    (4224, 6, 161, 0),
+    (4226, 6, 161, 0),
+    (4228, 6, 161, 0),
+    (4232, 3, 161, 0),
+    (4234, 3, 161, 0),
+    (4236, 3, 161, 0),
+    (4238, 3, 161, 0),
+    (4242, 6, 161, 0),
+    (4244, 6, 161, 0),
+    (4246, 6, 161, 0),
+    (4248, 6, 161, 0),
+    (4301, 1, 193, 0),
+    (4303, 1, 193, 0),
+    (4305, 1, 193, 0),
+    (4307, 1, 193, 0),
+    (4309, 1, 193, 0),
+    (4312, 0, 161, 0),
+    (4314, 0, 161, 0),
+    (4316, 0, 161, 0),
+    (4318, 0, 161, 0),
+    (4322, 3, 161, 0),
+    (4324, 3, 161, 0),
+    (4326, 3, 161, 0),
+    (4328, 3, 161, 0),
+    (4332, 0, 161, 0),
+    (4334, 0, 161, 0),
+    (4336, 0, 161, 0),
+    (4338, 0, 161, 0),
+    (4342, 3, 161, 0),
+    (4344, 3, 161, 0),
+    (4346, 3, 161, 0),
+    (4348, 3, 161, 0),
+    (4401, 4, 193, 0),
+    (4403, 4, 193, 0),
+    (4405, 4, 193, 0),
+    (4407, 4, 193, 0),
+    (4409, 4, 193, 0),
+    (4412, 3, 161, 0),
+    (4414, 3, 161, 0),
+    (4416, 3, 161, 0),
+    (4418, 3, 161, 0),
+    (4422, 6, 161, 0),
+    (4424, 6, 161, 0),
+    (4426, 6, 161, 0),
+    (4428, 6, 161, 0),
+    (4432, 3, 161, 0),
+    (4434, 3, 161, 0),
+    (4436, 3, 161, 0),
+    (4438, 3, 161, 0),
+    (4442, 6, 161, 0),
+    (4444, 6, 161, 0),
+    (4446, 6, 161, 0),
+    (4448, 6, 161, 0),
+    (5101, -2, 321, 0),
+    (5103, -2, 321, 0),
+    (5105, -2, 321, 0),
+    (5107, -2, 321, 0),
+    (5109, -2, 321, 0),
+    (5112, -3, 289, 0),
+    (5114, -3, 289, 0),
+    (5116, -3, 289, 0),
+    (5118, -3, 289, 0),
+    (5122, 0, 289, 0),
+    (5124, 0, 289, 0),
+    (5126, 0, 289, 0),
+    (5128, 0, 289, 0),
+    (5132, -3, 289, 0),
+    (5134, -3, 289, 0),
+    (5136, -3, 289, 0),
+    (5138, -3, 289, 0),
+    (5142, 0, 417, 0),
+    (5144, 0, 417, 0),
+    (5146, 0, 417, 0),
+    (5148, 0, 417, 0),
+    (5152, -3, 289, 0),
+    (5154, -3, 289, 0),
+    (5156, -3, 289, 0),
+    (5158, -3, 289, 0),
+    (5201, 1, 321, 0),
+    (5203, 1, 321, 0),
+    (5205, 1, 321, 0),
+    (5207, 1, 321, 0),
+    (5209, 1, 321, 0),
+    (5212, 0, 289, 0),
+    (5214, 0, 289, 0),
+    (5216, 0, 289, 0),
+    (5218, 0, 289, 0),
+    (5222, 3, 289, 0),
+    (5224, 3, 289, 0),
+    (5226, 3, 289, 0),
+    (5228, 3, 289, 0),
+    (5232, 0, 289, 0),
+    (5234, 0, 289, 0),
+    (5236, 0, 289, 0),
+    (5238, 0, 289, 0),
+    (5242, 3, 417, 0),
+    (5244, 3, 417, 0),
+    (5246, 3, 417, 0),
+    (5248, 3, 417, 0),
+    (5252, 0, 289, 0),
+    (5254, 0, 289, 0),
+    (5256, 0, 289, 0),
+    (5258, 0, 289, 0),
+    (5301, -2, 321, 0),
+    (5303, -2, 321, 0),
+    (5305, -2, 321, 0),
+    (5307, -2, 321, 0),
+    (5309, -2, 321, 0),
+    (5312, -3, 289, 0),
+    (5314, -3, 289, 0),
+    (5316, -3, 289, 0),
+    (5318, -3, 289, 0),
+    (5322, 0, 289, 0),
+    (5324, 0, 289, 0),
+    (5326, 0, 289, 0),
+    (5328, 0, 289, 0),
+    (5332, -3, 289, 0),
+    (5334, -3, 289, 0),
+    (5336, -3, 289, 0),
+    (5338, -3, 289, 0),
+    (5342, 0, 417, 0),
+    (5344, 0, 417, 0),
+    (5346, 0, 417, 0),
+    (5348, 0, 417, 0),
+    (5352, -3, 289, 0),
+    (5354, -3, 289, 0),
+    (5356, -3, 289, 0),
+    (5358, -3, 289, 0),
+    (5401, 1, 449, 0),
+    (5403, 1, 449, 0),
+    (5405, 1, 449, 0),
+    (5407, 1, 449, 0),
+    (5409, 1, 449, 0),
+    (5412, 0, 417, 0),
+    (5414, 0, 417, 0),
+    (5416, 0, 417, 0),
+    (5418, 0, 417, 0),
+    (5422, 3, 417, 0),
+    (5424, 3, 417, 0),
+    (5426, 3, 417, 0),
+    (5428, 3, 417, 0),
+    (5432, 0, 417, 0),
+    (5434, 0, 417, 0),
+    (5436, 0, 417, 0),
+    (5438, 0, 417, 0),
+    (5442, 3, 417, 0),
+    (5444, 3, 417, 0),
+    (5446, 3, 417, 0),
+    (5448, 3, 417, 0),
+    (5452, 0, 417, 0),
+    (5454, 0, 417, 0),
+    (5456, 0, 417, 0),
+    (5458, 0, 417, 0),
+    (5501, -2, 321, 0),
+    (5503, -2, 321, 0),
+    (5505, -2, 321, 0),
+    (5507, -2, 321, 0),
+    (5509, -2, 321, 0),
+    (5512, -3, 289, 0),
+    (5514, -3, 289, 0),
+    (5516, -3, 289, 0),
+    (5518, -3, 289, 0),
+    (5522, 0, 289, 0),
+    (5524, 0, 289, 0),
+    (5526, 0, 289, 0),
+    (5528, 0, 289, 0),
+    (5532, -3, 289, 0),
+    (5534, -3, 289, 0),
+    (5536, -3, 289, 0),
+    (5538, -3, 289, 0),
+    (5542, 0, 417, 0),
+    (5544, 0, 417, 0),
+    (5546, 0, 417, 0),
+    (5548, 0, 417, 0),
+    (5552, -3, 289, 0),
+    (5554, -3, 289, 0),
+    (5556, -3, 289, 0),
+    (5558, -3, 289, 0),
+]
@@ -0,0 +1,110 @@
+/**
+ * @headerfile - cuts applied to the Pythia event record before the event is converted to HepMC3, so the events that
+ *               the analysis would throw away are neither converted nor written.
+ *               The cuts are a minimum number of charged particles in the acceptance and a minimum pT of the leading
+ *               jet (anti-kt with the Pythia SlowJet). The cheap charged particle count is checked first.
+ *               The filter counts the events it tested and accepted: the cross section of the accepted events is the
+ *               Pythia cross section times the filter efficiency.
+ **/
+
+#ifndef GENERATION_FILTER_H
+#define GENERATION_FILTER_H
+
+#include <string>
+#include <memory>
+#include <cmath>
+#include "Pythia8/Pythia.h"
+
+/**
+ * @brief - cuts of the filter, all disabled by default
+ **/
+struct GenerationFilterSettings {
+    /// @brief - minimum number of final charged particles with pT > charged_pt_min and |eta| < charged_eta_max
+    int min_charged = 0;
+    double charged_pt_min = 0.15;
+    double charged_eta_max = 0.9;
+    /// @brief - minimum pT of the leading anti-kt jet of radius jet_radius, built with the visible particles with |eta| < jet_eta_max
+    double jet_pt_min = 0;
+    double jet_radius = 0.4;
+    double jet_eta_max = 0.9;
+
+    /// @brief - true if any cut is enabled
+    bool active() const {return min_charged > 0 || jet_pt_min > 0;};
+
+    /// @brief - reads the command line option of a cut (--min-charged, --charged-pt-min, --charged-eta-max,
+    ///          --jet-pt-min, --jet-radius, --jet-eta-max)
+    /// @return - false if the option is not a cut of the filter
+    bool parseOption(const std::string& option, const std::string& value) {
+        if (option == "--min-charged") min_charged = std::stoi(value);
+        else if (option == "--charged-pt-min") charged_pt_min = std::stod(value);
+        else if (option == "--charged-eta-max") charged_eta_max = std::stod(value);
+        else if (option == "--jet-pt-min") jet_pt_min = std::stod(value);
+        else if (option == "--jet-radius") jet_radius = std::stod(value);
+        else if (option == "--jet-eta-max") jet_eta_max = std::stod(value);
+        else return false;
+        return true;
+    };
+
+    /// @brief - description of the cuts for the manifests
+    std::string description() const {
+        std::string text = "min_charged " + std::to_string(min_charged) + " charged_pt_min " + std::to_string(charged_pt_min) +
+                           " charged_eta_max " + std::to_string(charged_eta_max);
+        return text + " jet_pt_min " + std::to_string(jet_pt_min) + " jet_radius " + std::to_string(jet_radius) +
+               " jet_eta_max " + std::to_string(jet_eta_max);
+    };
+};
+
+/**
+ * @class - applies the cuts to the events of one Pythia instance (each thread needs its own filter)
+ **/
+class GenerationFilter {
+    public:
+        GenerationFilter(const GenerationFilterSettings& settings): _settings(settings) {
+            // power -1 is anti-kt, select 2 uses all the final visible particles
+            if (settings.jet_pt_min > 0)
+                _slow_jet = std::make_unique<Pythia8::SlowJet>(-1, settings.jet_radius, settings.jet_pt_min, settings.jet_eta_max, 2);
+        };
+
+        /// @brief - true if the event passes the cuts
+        bool accept(const Pythia8::Event& event) {
+            _tested_events++;
+            if (_settings.min_charged > 0 && !hasChargedParticles(event))
+                return false;
+            if (_slow_jet && !hasJet(event))
+                return false;
+            _accepted_events++;
+            return true;
+        };
+
+        /// @brief - number of events tested and accepted
+        long testedEvents() const {return _tested_events;};
+        long acceptedEvents() const {return _accepted_events;};
+
+        /// @brief - fraction of the tested events that were accepted
+        double efficiency() const {return _tested_events > 0 ? double(_accepted_events) / _tested_events : 1.;};
+
+    private:
+        GenerationFilterSettings _settings;
+        std::unique_ptr<Pythia8::SlowJet> _slow_jet;
+        long _tested_events = 0;
+        long _accepted_events = 0;
+
+        /// @brief - true if there are at least min_charged charged particles in the acceptance (stops counting there)
+        bool hasChargedParticles(const Pythia8::Event& event) const {
+            int number_charged = 0;
+            for (int i = 0; i < event.size(); i++) {
+                const Pythia8::Particle& particle = event[i];
+                if (particle.isFinal() && particle.isCharged() && particle.pT() > _settings.charged_pt_min &&
+                    std::abs(particle.eta()) < _settings.charged_eta_max && ++number_charged >= _settings.min_charged)
+                    return true;
+            }
+            return false;
+        };
+
+        /// @brief - true if the leading jet has pT above the threshold (SlowJet only keeps the jets above it)
+        bool hasJet(const Pythia8::Event& event) {
+            return _slow_jet->analyze(event) && _slow_jet->sizeJet() > 0;
+        };
+};
+
+#endif
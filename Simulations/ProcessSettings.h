@@ -0,0 +1,59 @@
+/**
+ * @headerfile - Pythia settings of the samples of the analysis and the seeds of their shards.
+ *               Shared by generate_events (HepMC3 files) and the in-memory generation of the Analysis
+ *               (generate_select_particles), so both produce the same events for the same seed.
+ **/
+
+#ifndef PROCESS_SETTINGS_H
+#define PROCESS_SETTINGS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/// @brief - settings that define each process
+/// @return - false if the process is unknown
+inline bool processSettings (const std::string& process, std::vector<std::string>& settings) {
+    if (process == "bbbar")
+        settings = {"HardQCD:hardbbbar = on"}; // Events must produce b quarks
+    else if (process == "ccbar")
+        settings = {"HardQCD:hardccbar = on"}; // Events must produce c quarks
+    else if (process == "light")
+        settings = {"HardQCD:gg2gg = on", "HardQCD:gg2qqbar = on", "HardQCD:qg2qg = on",
+                    "HardQCD:qq2qq = on", "HardQCD:qqbar2gg = on", "HardQCD:qqbar2qqbarNew = on"};
+    else if (process == "soft")
+        settings = {"SoftQCD:nonDiffractive = on"};
+    else
+        return false;
+    return true;
+}
+
+/// @brief - settings of a sample: the common configuration, the process and the pTHat window
+/// @return - false if the process is unknown
+inline bool sampleSettings (const std::string& process, double pthat_min, double pthat_max, std::vector<std::string>& settings) {
+    if (!processSettings(process, settings))
+        return false;
+    settings.insert(settings.begin(), {"Beams:eCM = 13000.", // CM Energy of 13 TeV
+                                       "Tune:ee = 7", // Unsing Monash 2013 Tune
+                                       "PDF:pSet = LHAPDF6/CT10nlo/4"});
+    settings.push_back("PhaseSpace:pTHatMin = " + std::to_string(pthat_min));
+    settings.push_back("PhaseSpace:pTHatMax = " + std::to_string(pthat_max));
+    return true;
+}
+
+/// @brief - seed of the Pythia instance of a shard, derived from the base seed with splitmix64
+///          Pythia accepts seeds in [1, 900000000]
+inline long shardSeed (std::uint64_t base_seed, int shard) {
+    std::uint64_t z = base_seed + 0x9e3779b97f4a7c15ULL * std::uint64_t(shard + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = z ^ (z >> 31);
+    return long(z % 900000000ULL) + 1;
+}
+
+/// @brief - number of events of a shard when the events are split as evenly as possible among the shards
+inline long shardEvents (long number_events, int shard, int number_shards) {
+    return number_events / number_shards + (shard < number_events % number_shards ? 1 : 0);
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include "Pythia8/Pythia.h"
+#include "Pythia8Plugins/HepMC3.h"
+#include "ProcessSettings.h"
+#include "GenerationFilter.h"
+
+using namespace Pythia8;
+using namespace std;
+
+/**
+ * Generates one sample (process and pTHat window) with N independent Pythia instances, each one in its own
+ * shard file <output>_shard_i_of_N.hepmc, and writes the manifest <output>.manifest with the seed, the number of
+ * events and the cross section of every shard.
+ * With the filter options, the events that fail the cuts of the GenerationFilter are dropped before the conversion
+ * to HepMC3 and each shard generates until it has the requested number of accepted events. The filter efficiency
+ * and the cross section of the accepted events are recorded in the manifest.
+ * The shards are run by a pool of threads, so the content of each shard only depends on the base seed, the shard
+ * index and the number of shards - not on the number of threads or on the machine.
+ *
+ * usage: generate_events --process <bbbar|ccbar|light|soft> --pthat-min <GeV> --pthat-max <GeV> --output <prefix>
+ *                        [--events N] [--shards N] [--threads N] [--seed S] [--set "Pythia setting"]...
+ *                        [--min-charged N] [--charged-pt-min GeV] [--charged-eta-max eta]
+ *                        [--jet-pt-min GeV] [--jet-radius R] [--jet-eta-max eta]
+ **/
+
+/// @brief - name of the file of a shard (same convention as the sharded outputs of the analysis)
+string shardFilename (const string& output, int shard, int number_shards) {
+    if (number_shards == 1)
+        return output + ".hepmc";
+    return output + "_shard_" + to_string(shard) + "_of_" + to_string(number_shards) + ".hepmc";
+}
+
+/// @brief - what each shard produced, for the manifest
+struct ShardResult {
+    string filename;
+    long seed = 0;
+    long events = 0;
+    long written_events = 0;
+    long failed_events = 0;
+    /// @brief - events generated by Pythia and tested by the filter (written events are the accepted ones)
+    long tested_events = 0;
+    double sigma_mb = 0;
+    double sigma_err_mb = 0;
+    double seconds = 0;
+    bool success = false;
+};
+
+/// @brief - generates the events of one shard
+void generateShard (const vector<string>& settings, const GenerationFilterSettings& filter_settings, ShardResult& result, mutex& init_mutex) {
+    const auto start = chrono::steady_clock::now();
+
+    // Generator, event configurations and pythia initialization
+    Pythia pythia ("../share/Pythia8/xmldoc", false);
+    pythia.readString("Random:setSeed = on");
+    pythia.readString("Random:seed = " + to_string(result.seed));
+    pythia.readString("Next:numberCount = 0"); // the progress of the shards would be interleaved
+    for (const string& setting: settings)
+        pythia.readString(setting);
+    {
+        // the initialization reads the xml database and LHAPDF grids, which is not thread safe
+        lock_guard<mutex> lock (init_mutex);
+        if (!pythia.init()) {
+            cout << "Pythia failed to initialize the shard " << result.filename << endl;
+            return;
+        }
+    }
+
+    // Conversion from Pythia8::Event to HepMC event and file where events are saved
+    Pythia8ToHepMC toHepMC (result.filename);
+
+    // cuts on the Pythia event record, before the conversion
+    GenerationFilter filter (filter_settings);
+
+    // Generates until the shard has all its accepted events, giving up if Pythia keeps failing
+    // or if the filter accepts nothing
+    const long max_failed_events = max(100L, result.events / 10);
+    const long max_rejected_events = 10000;
+    while (result.written_events < result.events) {
+        if (!pythia.next()) {
+            if (++result.failed_events > max_failed_events) {
+                cout << "Shard " << result.filename << " stopped after " << result.failed_events << " failed events" << endl;
+                break;
+            }
+            continue;
+        }
+        if (!filter.accept(pythia.event)) {
+            if (filter.acceptedEvents() == 0 && filter.testedEvents() >= max_rejected_events) {
+                cout << "Shard " << result.filename << " stopped: the filter accepted none of " << filter.testedEvents() << " events" << endl;
+                break;
+            }
+            continue;
+        }
+        toHepMC.writeNextEvent(pythia);
+        result.written_events++;
+    }
+    result.tested_events = filter.testedEvents();
+
+    result.sigma_mb = pythia.info.sigmaGen();
+    result.sigma_err_mb = pythia.info.sigmaErr();
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.success = result.written_events == result.events;
+}
+
+/// @brief - writes the manifest of the sample as "key value" lines, one "shard" line per shard
+bool writeManifest (const string& filename, const string& process, double pthat_min, double pthat_max, uint64_t base_seed,
+                    const vector<string>& settings, const GenerationFilterSettings& filter_settings, const vector<ShardResult>& results) {
+    ofstream manifest (filename);
+    if (!manifest.is_open())
+        return false;
+
+    // the shards estimate the same cross section, so they are combined weighted by their number of generated events
+    long total_events = 0, tested_events = 0;
+    double sigma_sum = 0, sigma_err_sum = 0;
+    for (const ShardResult& result: results) {
+        total_events += result.written_events;
+        tested_events += result.tested_events;
+        sigma_sum += result.tested_events * result.sigma_mb;
+        sigma_err_sum += pow(result.tested_events * result.sigma_err_mb, 2);
+    }
+    const double sigma = tested_events > 0 ? sigma_sum / tested_events : 0.;
+    const double sigma_err = tested_events > 0 ? sqrt(sigma_err_sum) / tested_events : 0.;
+    const double efficiency = tested_events > 0 ? double(total_events) / tested_events : 0.;
+
+    manifest << "process " << process << "\n";
+    manifest << "pthat_min " << pthat_min << "\n";
+    manifest << "pthat_max " << pthat_max << "\n";
+    manifest << "seed " << base_seed << "\n";
+    for (const string& setting: settings)
+        manifest << "setting " << setting << "\n";
+    manifest << "filter " << (filter_settings.active() ? filter_settings.description() : "none") << "\n";
+    manifest << "shards " << results.size() << "\n";
+    // shard <index> <file> <seed> <events written> <events tested by the filter> <failed events> <sigma [mb]> <sigma error [mb]> <seconds>
+    for (size_t shard = 0; shard < results.size(); shard++) {
+        const ShardResult& result = results[shard];
+        manifest << "shard " << shard << " " << result.filename << " " << result.seed << " " << result.written_events << " " << result.tested_events << " "
+                 << result.failed_events << " " << result.sigma_mb << " " << result.sigma_err_mb << " " << result.seconds << "\n";
+    }
+    manifest << "events " << total_events << "\n";
+    manifest << "tested_events " << tested_events << "\n";
+    manifest << "filter_efficiency " << efficiency << "\n";
+    // cross section of all the generated events, and of the events in the files (the one to normalise the samples with)
+    manifest << "sigma_mb " << sigma << "\n";
+    manifest << "sigma_err_mb " << sigma_err << "\n";
+    manifest << "sigma_accepted_mb " << sigma * efficiency << "\n";
+    manifest << "end\n";
+    return manifest.good();
+}
+
+int main (int argc, char* argv[]) {
+    string process, output;
+    double pthat_min = -1, pthat_max = -1;
+    long number_events = 500000;
+    // fixed default, so the shards do not depend on the machine where they are generated
+    int number_shards = 16;
+    int number_threads = 0;
+    uint64_t base_seed = 1;
+    vector<string> extra_settings;
+    GenerationFilterSettings filter_settings;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const string option = argv[i], value = argv[i + 1];
+        if (option == "--process") process = value;
+        else if (option == "--pthat-min") pthat_min = stod(value);
+        else if (option == "--pthat-max") pthat_max = stod(value);
+        else if (option == "--output") output = value;
+        else if (option == "--events") number_events = stol(value);
+        else if (option == "--shards") number_shards = stoi(value);
+        else if (option == "--threads") number_threads = stoi(value);
+        else if (option == "--seed") base_seed = stoull(value);
+        else if (option == "--set") extra_settings.push_back(value);
+        else if (filter_settings.parseOption(option, value)) continue;
+        else {
+            cout << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    vector<string> settings;
+    if (!sampleSettings(process, pthat_min, pthat_max, settings)) {
+        cout << "Unknown process '" << process << "' (bbbar, ccbar, light or soft)" << endl;
+        return 1;
+    }
+    if (output.empty() || pthat_min < 0 || pthat_max <= pthat_min || number_events <= 0 || number_shards <= 0) {
+        cout << "usage: generate_events --process <bbbar|ccbar|light|soft> --pthat-min <GeV> --pthat-max <GeV> --output <prefix>" << endl
+             << "                       [--events N] [--shards N] [--threads N] [--seed S] [--set \"Pythia setting\"]..." << endl
+             << "                       [--min-charged N] [--charged-pt-min GeV] [--charged-eta-max eta]" << endl
+             << "                       [--jet-pt-min GeV] [--jet-radius R] [--jet-eta-max eta]" << endl;
+        return 1;
+    }
+    if (number_threads <= 0)
+        number_threads = min<int>(number_shards, max(1u, thread::hardware_concurrency()));
+
+    settings.insert(settings.end(), extra_settings.begin(), extra_settings.end());
+
+    // the events are split as evenly as possible among the shards
+    vector<ShardResult> results (number_shards);
+    for (int shard = 0; shard < number_shards; shard++) {
+        results[shard].filename = shardFilename(output, shard, number_shards);
+        results[shard].seed = shardSeed(base_seed, shard);
+        results[shard].events = shardEvents(number_events, shard, number_shards);
+    }
+
+    cout << "Generating " << number_events << " " << process << " events with pTHat in [" << pthat_min << ", " << pthat_max
+         << "] GeV in " << number_shards << " shards with " << number_threads << " threads" << endl;
+
+    // each thread takes the next shard not generated yet
+    mutex init_mutex;
+    atomic<int> next_shard (0);
+    vector<thread> threads;
+    for (int i = 0; i < number_threads; i++) {
+        threads.emplace_back([&]() {
+            for (int shard = next_shard++; shard < number_shards; shard = next_shard++)
+                generateShard(settings, filter_settings, results[shard], init_mutex);
+        });
+    }
+    for (thread& worker: threads)
+        worker.join();
+
+    bool success = true;
+    for (const ShardResult& result: results) {
+        cout << result.filename << ": " << result.written_events << " of " << result.tested_events << " events accepted, sigma = " << result.sigma_mb << " +- "
+             << result.sigma_err_mb << " mb, " << result.seconds << " s" << endl;
+        success = success && result.success;
+    }
+    if (!writeManifest(output + ".manifest", process, pthat_min, pthat_max, base_seed, settings, filter_settings, results)) {
+        cout << "Could not write the manifest " << output << ".manifest" << endl;
+        return 1;
+    }
+    return success ? 0 : 1;
+}
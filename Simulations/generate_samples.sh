@@ -0,0 +1,37 @@
+#!/bin/bash
+# Generates the twelve samples of the analysis (four processes in three pTHat windows) with generate_events.
+# usage: ./generate_samples.sh [output directory] [shards] [threads]
+# Every sample gets its own base seed, so the samples are independent and can be regenerated event by event.
+# The shards of a sample are <output>/<process>_prod_<min>_<max>_shard_i_of_N.hepmc plus the manifest
+# <output>/<process>_prod_<min>_<max>.manifest with the seed, number of events and cross section of each shard.
+# The generation-time cuts of generate_events can be given in FILTER, e.g. FILTER="--min-charged 2 --jet-pt-min 10".
+
+OUTPUT_DIR=${1:-/sampa/archive/caducka/jetsml}
+SHARDS=${2:-16}
+THREADS=${3:-$(nproc)}
+EVENTS=500000
+FILTER=${FILTER:-}
+
+# process pTHat min pTHat max base seed
+SAMPLES="
+bbbar  20  30 1001
+bbbar  40  60 1002
+bbbar  90 110 1003
+ccbar  20  30 2001
+ccbar  40  60 2002
+ccbar  90 110 2003
+light  20  30 3001
+light  40  60 3002
+light  90 110 3003
+soft   20  30 4001
+soft   40  60 4002
+soft   90 110 4003
+"
+
+mkdir -p "$OUTPUT_DIR"
+echo "$SAMPLES" | while read -r process pthat_min pthat_max seed; do
+    [ -z "$process" ] && continue
+    ./generate_events --process "$process" --pthat-min "$pthat_min" --pthat-max "$pthat_max" --seed "$seed" \
+        --events "$EVENTS" --shards "$SHARDS" --threads "$THREADS" $FILTER \
+        --output "$OUTPUT_DIR/${process}_prod_${pthat_min}_${pthat_max}" || exit 1
+done